@@ -35,6 +35,7 @@ bool yes6;
 bool norun;
 bool read_only;
 bool write_avoid;
+bool secondary;
 bool soft_assert;
 bool nomatrix;
 bool matrix {true}; // matrix server by default.
@@ -65,6 +66,7 @@ lgetopt opts[]
 	{ "norun",      &norun,         lgetopt::BOOL,    "[debug & testing only] Initialize but never run the event loop." },
 	{ "ro",         &read_only,     lgetopt::BOOL,    "Read-only mode. No writes to database allowed." },
 	{ "wa",         &write_avoid,   lgetopt::BOOL,    "Like read-only mode, but writes permitted if triggered." },
+	{ "secondary",  &secondary,     lgetopt::BOOL,    "Read-only secondary tailing the database of a running primary." },
 	{ "smoketest",  &smoketest[0],  lgetopt::BOOL,    "Starts and stops the daemon to return success."},
 	{ "sassert",    &soft_assert,   lgetopt::BOOL,    "Softens assertion effects in debug mode."},
 	{ "nomatrix",   &nomatrix,      lgetopt::BOOL,    "Prevent loading the matrix application module."},
@@ -460,11 +462,15 @@ applyargs()
 	if(defaults)
 		ircd::defaults.set("true");
 
-	if(read_only)
+	if(secondary)
+		ircd::secondary.set("true");
+
+	// secondary implies read_only.
+	if(read_only || secondary)
 		ircd::read_only.set("true");
 
 	// read_only implies write_avoid.
-	if(write_avoid || read_only)
+	if(write_avoid || read_only || secondary)
 		ircd::write_avoid.set("true");
 
 	if(debugmode)
@@ -35,6 +35,7 @@
 namespace ircd::ctx
 {
 	struct ctx;
+	enum class prio :uint8_t;
 
 	IRCD_EXCEPTION(ircd::error, error)
 	IRCD_EXCEPTION(error, interrupted)
@@ -50,6 +51,7 @@ namespace ircd::ctx
 	const ulong &cycles(const ctx &) noexcept;      // Accumulated tsc (not counting cur slice)
 	const int8_t &ionice(const ctx &) noexcept;     // IO priority nice-value
 	const int8_t &nice(const ctx &) noexcept;       // Scheduling priority nice-value
+	prio prio_class(const ctx &) noexcept;          // Scheduling class of nice-value
 	bool interruptible(const ctx &) noexcept;       // Context can throw at interruption point
 	bool interruption(const ctx &) noexcept;        // Context was marked for interruption
 	bool termination(const ctx &) noexcept;         // Context was marked for termination
@@ -71,10 +73,26 @@ namespace ircd::ctx
 
 	bool for_each(const std::function<bool (ctx &)> &);
 	const uint64_t &epoch() noexcept;
+	string_view reflect(const prio &);
 
 	extern log::log log;
 }
 
+/// Scheduling priority classes. A context's class follows from its nice
+/// value: negative is interactive, zero is normal and positive is background.
+/// While interactive or normal contexts are ready to run, a background
+/// context being woken is queued behind them, and a background context which
+/// has used up its time slice yields at its next this_ctx::yield_slice().
+enum class ircd::ctx::prio
+:uint8_t
+{
+	INTERACTIVE,
+	NORMAL,
+	BACKGROUND,
+
+	_NUM_
+};
+
 #include "prof.h"
 #include "this_ctx.h"
 #include "wait.h"
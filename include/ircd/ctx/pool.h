@@ -112,7 +112,8 @@ struct ircd::ctx::pool::opts
 	/// IO priority nice value for contexts in this pool.
 	int8_t ionice {0};
 
-	/// Scheduler priority nice value for contexts in this pool.
+	/// Scheduler priority nice value for contexts in this pool. This selects
+	/// the ctx::prio class of the pool's contexts.
 	int8_t nice {0};
 };
 
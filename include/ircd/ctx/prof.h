@@ -38,6 +38,7 @@ namespace ircd::ctx::prof
 	// totals
 	const ticker &get() noexcept;
 	const uint64_t &get(const event &);
+	const uint64_t &get(const prio &);           // cycles by priority class
 
 	// specific context
 	const ticker &get(const ctx &c) noexcept;
@@ -14,6 +14,8 @@
 /// Interface to the currently running context
 namespace ircd::ctx { inline namespace this_ctx
 {
+	struct background;
+
 	struct ctx &cur() noexcept;                  ///< Assumptional reference to *current
 	const uint64_t &id() noexcept;               // Unique ID for cur ctx
 	string_view name() noexcept;                 // Optional label for cur ctx
@@ -21,6 +23,7 @@ namespace ircd::ctx { inline namespace this_ctx
 	bool interruption_requested() noexcept;      // interruption(cur())
 	void interruption_point();                   // throws if interruption_requested()
 	void yield();                                // Allow other contexts to run before returning.
+	bool yield_slice();                          // yield() if a background slice is used up
 }}
 
 namespace ircd::ctx
@@ -34,6 +37,40 @@ namespace ircd
 	namespace this_ctx = ctx::this_ctx;
 }
 
+/// An instance of background places the current context in the
+/// prio::BACKGROUND class for the scope by raising its nice value, which is
+/// restored after. This is for bulk work which runs on the context of its
+/// caller, such as a rebuild started from the console. A context which is
+/// already nicer is left as it is.
+struct ircd::ctx::this_ctx::background
+{
+	int8_t theirs;
+
+	background(const int8_t &nice = 4) noexcept;
+	background(background &&) = delete;
+	background(const background &) = delete;
+	~background() noexcept;
+};
+
+inline
+ircd::ctx::this_ctx::background::background(const int8_t &nice)
+noexcept
+:theirs
+{
+	ircd::ctx::nice(cur())
+}
+{
+	assert(nice > 0);
+	ircd::ctx::nice(cur(), std::max(theirs, nice));
+}
+
+inline
+ircd::ctx::this_ctx::background::~background()
+noexcept
+{
+	ircd::ctx::nice(cur(), theirs);
+}
+
 /// View the name of the currently running context, or "*" if no context is
 /// currently running.
 inline ircd::string_view
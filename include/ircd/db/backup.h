@@ -0,0 +1,52 @@
+// Matrix Construct
+//
+// Copyright (C) Matrix Construct Developers, Authors & Contributors
+// Copyright (C) 2016-2020 Jason Volk <jason@zemos.net>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice is present in all copies. The
+// full license for this software is available in the LICENSE file.
+
+#pragma once
+#define HAVE_IRCD_DB_BACKUP_H
+
+/// Incremental online backups. Each backup is identified by the sequence
+/// number of the database when it was taken. The table files are immutable
+/// once written, so they are copied once into a directory shared by all
+/// backups of a database under their number, checksum and size; each backup
+/// directory only holds its own copy of the manifest and a list of the table
+/// files it references. Copying is rate
+/// limited and yields to the write path; file deletions are only held off
+/// for the duration of the copy.
+///
+/// Layout: <path>/<dbname>/shared/<number>_<checksum>_<size>.<sst|blob>
+///         <path>/<dbname>/<id>/{CURRENT,MANIFEST-*,OPTIONS-*,FILES}
+///
+/// A restore reconstitutes the backup as a checkpoint of the database (see
+/// db::path(name, checkpoint)) by hard-linking the shared table files when
+/// possible, so it can be opened directly as "name:id".
+namespace ircd::db::backup
+{
+	using closure = std::function<bool (const uint64_t &id)>;
+
+	extern conf::item<std::string> path;
+	extern conf::item<size_t> rate;
+	extern conf::item<size_t> keep;
+	extern conf::item<size_t> buffer_size;
+
+	extern stats::item count;
+	extern stats::item files_copied;
+	extern stats::item files_shared;
+	extern stats::item bytes_copied;
+	extern stats::item bytes_total;
+
+	std::string dir(const string_view &dbname);
+	std::string dir(const string_view &dbname, const uint64_t &id);
+
+	bool for_each(const string_view &dbname, const closure &);
+	size_t verify(database &, const uint64_t &id);
+	size_t purge(const string_view &dbname, const size_t &keep);
+	std::string restore(const string_view &dbname, const uint64_t &id);
+	uint64_t create(database &);
+}
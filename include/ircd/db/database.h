@@ -19,6 +19,7 @@ namespace ircd::db
 	extern conf::item<bool> open_check;
 	extern conf::item<std::string> open_recover;
 	extern conf::item<bool> open_repair;
+	extern conf::item<std::string> secondary_path;
 
 	// General information
 	const std::string &name(const database &);
@@ -53,6 +54,7 @@ namespace ircd::db
 	void bgcontinue(database &);
 	void bgpause(database &);
 	void resume(database &);
+	uint64_t catchup(database &);
 	void check(database &, const string_view &file);
 	void check(database &);
 	void compact(database &, const std::pair<int, int> &level, const compactor & = {});
@@ -103,7 +105,7 @@ struct ircd::db::database
 	uint64_t checkpoint;
 	std::string path;
 	std::string optstr;
-	bool fsck, read_only;
+	bool fsck, read_only, secondary;
 	std::shared_ptr<struct env> env;
 	std::shared_ptr<struct stats> stats;
 	std::shared_ptr<struct logger> logger;
@@ -112,6 +114,7 @@ struct ircd::db::database
 	std::unique_ptr<struct wal_filter> wal_filter;
 	std::shared_ptr<rocksdb::SstFileManager> ssts;
 	std::shared_ptr<rocksdb::Cache> row_cache;
+	std::shared_ptr<rocksdb::RateLimiter> rate_limiter;
 	std::vector<descriptor> descriptors;
 	std::unique_ptr<rocksdb::DBOptions> opts;
 	std::unordered_map<string_view, std::shared_ptr<column>> column_names;
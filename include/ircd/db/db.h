@@ -57,6 +57,8 @@ namespace ircd::db
 #include "json.h"
 #include "txn.h"
 #include "prefetcher.h"
+#include "backup.h"
+#include "governor.h"
 #include "stats.h"
 
 //
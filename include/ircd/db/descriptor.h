@@ -118,4 +118,8 @@ struct ircd::db::descriptor
 		{      0L,  15L }, // max_bytes_for_level[5]
 		{      0L,  31L }, // max_bytes_for_level[6]
 	};
+
+	/// User given merge operator. When set, db::op::MERGE deltas to this
+	/// column are combined with the existing value by this closure.
+	db::merge_closure merger {};
 };
@@ -0,0 +1,43 @@
+// Matrix Construct
+//
+// Copyright (C) Matrix Construct Developers, Authors & Contributors
+// Copyright (C) 2016-2020 Jason Volk <jason@zemos.net>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice is present in all copies. The
+// full license for this software is available in the LICENSE file.
+
+#pragma once
+#define HAVE_IRCD_DB_GOVERNOR_H
+
+/// Load-aware governor for background compaction. The foreground load is
+/// sampled periodically from the latency of the prefetcher's database
+/// operations and the system's IO pressure (PSI); as it rises the write rate
+/// of each database's rate limiter and the number of concurrent compactions
+/// are lowered toward their minimums, and raised again as it falls. Manual
+/// compactions can be deferred to the configured quiet hours.
+namespace ircd::db::governor
+{
+	extern conf::item<bool> enable;
+	extern conf::item<milliseconds> interval;
+	extern conf::item<microseconds> latency_high;
+	extern conf::item<double> psi_high;
+	extern conf::item<size_t> rate_min;
+	extern conf::item<size_t> rate_max;
+	extern conf::item<size_t> compactions_min;
+	extern conf::item<size_t> compactions_max;
+	extern conf::item<size_t> quiet_begin;
+	extern conf::item<size_t> quiet_end;
+
+	extern stats::item load_pct;
+	extern stats::item rate;
+	extern stats::item compactions;
+	extern stats::item deferred;
+
+	bool quiet();
+	void defer(const string_view &dbname, const string_view &colname = {});
+
+	void init();
+	void fini() noexcept;
+}
@@ -94,4 +94,15 @@ struct ircd::db::prefetcher::ticker
 	// accumulated latency totals
 	microseconds accum_snd_req {0us};
 	microseconds accum_req_fin {0us};
+
+	// latency distributions (microseconds)
+	stats::histogram snd_req
+	{
+		{ "name", "ircd.db.prefetcher.snd_req" }
+	};
+
+	stats::histogram req_fin
+	{
+		{ "name", "ircd.db.prefetcher.req_fin" }
+	};
 };
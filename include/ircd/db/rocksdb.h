@@ -31,6 +31,7 @@ namespace rocksdb
 	struct Slice;
 	struct Checkpoint;
 	struct SstFileManager;
+	struct RateLimiter;
 	struct PerfContext;
 	struct IOStatsContext;
 	struct LiveFileMetaData;
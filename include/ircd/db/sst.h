@@ -15,6 +15,7 @@ struct ircd::db::database::sst
 {
 	struct info;
 	struct dump;
+	struct writer;
 
 	static void tool(const vector_view<const string_view> &args);
 };
@@ -84,3 +85,26 @@ struct ircd::db::database::sst::dump
 	dump(dump &&) = delete;
 	dump(const dump &) = delete;
 };
+
+/// Build an external SST file for a column. Data can be appended in any order;
+/// it is sorted by the column's comparator when the file is written. Multiple
+/// appends for a key are resolved in the order they were made: merges are
+/// folded with the column's merge operator into the value before them. The
+/// file is suitable for db::ingest().
+struct ircd::db::database::sst::writer
+{
+	using entry = std::tuple<op, std::string, std::string>;
+
+	database::column &column;
+	std::string path;
+	std::vector<entry> buf;
+
+  public:
+	size_t size() const;
+	void append(const op &, const string_view &key, const string_view &val = {});
+	sst::info finish();
+
+	writer(db::column, const string_view &path);
+	writer(writer &&) = delete;
+	writer(const writer &) = delete;
+};
@@ -346,6 +346,7 @@ enum ircd::http::code
 	RANGE_NOT_SATISFIABLE                   = 416,
 	EXPECTATION_FAILED                      = 417,
 	IM_A_TEAPOT                             = 418,
+	MISDIRECTED_REQUEST                     = 421,
 	UNPROCESSABLE_ENTITY                    = 422,
 	PRECONDITION_REQUIRED                   = 428,
 	TOO_MANY_REQUESTS                       = 429,
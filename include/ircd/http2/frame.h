@@ -21,10 +21,14 @@ struct ircd::http2::frame
 	struct header;
 	struct settings;
 	enum type :uint8_t;
+	enum flag :uint8_t;
 
 	static string_view reflect(const type &);
 };
 
+/// Frame header. The layout matches the wire but the fields are in host
+/// order; construct from the wire with the const_buffer constructor and
+/// compose to the wire with operator().
 struct ircd::http2::frame::header
 {
 	uint32_t len        : 24;
@@ -32,6 +36,16 @@ struct ircd::http2::frame::header
 	uint8_t flags;
 	uint32_t            : 1;
 	uint32_t stream_id  : 31;
+
+	const_buffer operator()(const mutable_buffer &) const;
+
+	explicit header(const const_buffer &);
+	header(const uint32_t &len,
+	       const enum type &,
+	       const uint8_t &flags = 0,
+	       const uint32_t &stream_id = 0) noexcept;
+
+	header() = default;
 }
 __attribute__((packed));
 
@@ -49,3 +63,14 @@ enum ircd::http2::frame::type
 	WINDOW_UPDATE  = 0x8,
 	CONTINUATION   = 0x9,
 };
+
+/// Flags have meanings specific to the frame types they appear in.
+enum ircd::http2::frame::flag
+:uint8_t
+{
+	ACK            = 0x01,    // SETTINGS, PING
+	END_STREAM     = 0x01,    // DATA, HEADERS
+	END_HEADERS    = 0x04,    // HEADERS, CONTINUATION
+	PADDED         = 0x08,    // DATA, HEADERS
+	PRIORITIZED    = 0x20,    // HEADERS
+};
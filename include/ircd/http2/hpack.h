@@ -0,0 +1,45 @@
+// Matrix Construct
+//
+// Copyright (C) Matrix Construct Developers, Authors & Contributors
+// Copyright (C) 2016-2019 Jason Volk <jason@zemos.net>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice is present in all copies. The
+// full license for this software is available in the LICENSE file.
+
+#pragma once
+#define HAVE_IRCD_HTTP2_HPACK_H
+
+/// Header compression (RFC 7541). The decoder is complete. The encoder only
+/// produces literals which are never added to the remote's dynamic table,
+/// with the name indexed from the static table when possible; this keeps it
+/// stateless at some expense of compression.
+namespace ircd::http2::hpack
+{
+	struct table;
+	using header = std::pair<string_view, string_view>;
+	using closure = std::function<void (const string_view &, const string_view &)>;
+
+	extern const std::array<header, 61> static_table;
+
+	string_view huffman_decode(const mutable_buffer &out, const const_buffer &in);
+
+	const_buffer encode(const mutable_buffer &out, const string_view &name, const string_view &value);
+	void decode(table &, const const_buffer &block, const mutable_buffer &scratch, const closure &);
+}
+
+/// Dynamic table for the decoding side of a connection (RFC 7541 2.3.2).
+struct ircd::http2::hpack::table
+{
+	static constexpr const size_t entry_overhead {32};
+
+	std::deque<std::pair<std::string, std::string>> entries;
+	size_t size {0};                   // sum of entry sizes per 4.1
+	size_t max {4096};                 // current maximum set by the encoder
+	size_t limit {4096};               // maximum we advertised in SETTINGS
+
+	header at(const size_t &index) const;
+	void resize(const size_t &max);
+	void add(const string_view &name, const string_view &value);
+};
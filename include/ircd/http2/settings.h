@@ -62,5 +62,25 @@ struct ircd::http2::settings
 	using code = frame::settings::code;
 	using array_type = std::array<uint32_t, num_of<code>()>;
 
+	using array_type::operator[];
+	uint32_t &operator[](const code &);
+	const uint32_t &operator[](const code &) const;
+
 	settings();
 };
+
+/// Codes are numbered from one.
+inline const uint32_t &
+ircd::http2::settings::operator[](const code &code)
+const
+{
+	assert(code > 0 && code < code::_NUM_);
+	return array_type::operator[](code - 1);
+}
+
+inline uint32_t &
+ircd::http2::settings::operator[](const code &code)
+{
+	assert(code > 0 && code < code::_NUM_);
+	return array_type::operator[](code - 1);
+}
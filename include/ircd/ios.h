@@ -101,6 +101,7 @@ struct ircd::ios::descriptor
 :instance_list<descriptor>
 {
 	struct stats;
+	struct slab;
 
 	static uint64_t ids;
 
@@ -110,6 +111,7 @@ struct ircd::ios::descriptor
 	string_view name;
 	uint64_t id {++ids};
 	std::unique_ptr<struct stats> stats;
+	std::unique_ptr<struct slab> slab;
 	std::function<void *(handler &, const size_t &)> allocator;
 	std::function<void (handler &, void *const &, const size_t &)> deallocator;
 	bool continuation;
@@ -133,10 +135,14 @@ struct ircd::ios::descriptor::stats
 	uint64_t alloc_bytes{0};
 	uint64_t frees {0};
 	uint64_t free_bytes{0};
+	uint64_t slab_hits {0};
+	uint64_t slab_misses {0};
 	uint64_t slice_total {0};
 	uint64_t slice_last {0};
 	uint64_t latency_total {0};
 	uint64_t latency_last {0};
+	ircd::stats::histogram slice_hist;       // cycles
+	ircd::stats::histogram latency_hist;     // cycles
 
 	stats &operator+=(const stats &) &;
 
@@ -144,6 +150,45 @@ struct ircd::ios::descriptor::stats
 	~stats() noexcept;
 };
 
+/// Recycles the handler memory of a descriptor. Allocations are rounded up
+/// to a size class and returned to the free list of their class when freed
+/// instead of to the general allocator. A class keeps as many free entries
+/// as the most allocations of it ever seen outstanding at once, up to max,
+/// so the lists size themselves to the descriptor's observed demand. Only
+/// the main thread uses the lists; other threads fall back to new/delete.
+struct ircd::ios::descriptor::slab
+{
+	struct node
+	{
+		node *next;
+	};
+
+	struct shard
+	{
+		node *head {nullptr};
+		uint32_t count {0};              // entries on the free list
+		uint32_t outstanding {0};        // entries allocated and not freed
+		uint32_t peak {0};               // most outstanding observed
+	};
+
+	static constexpr const size_t granule {64};
+	static constexpr const size_t classes {8};
+	static constexpr const size_t max {256};
+
+	std::array<shard, classes> shards;
+
+	static size_t class_of(const size_t &) noexcept;
+
+  public:
+	void *allocate(struct stats &, const size_t &);
+	void deallocate(struct stats &, void *const &, const size_t &) noexcept;
+
+	slab();
+	slab(slab &&) = delete;
+	slab(const slab &) = delete;
+	~slab() noexcept;
+};
+
 struct ircd::ios::handler
 {
 	static thread_local handler *current;
@@ -45,18 +45,21 @@ namespace ircd::m::dbs::appendix
 
 #include "event_idx.h"              // event_id => event_idx
 #include "event_json.h"             // event_idx => (full JSON)
+#include "event_bin.h"              // event_idx => (binary event)
 #include "event_column.h"           // event_idx => (direct value)
 #include "event_refs.h"             // event_idx | ref_type, event_idx
 #include "event_horizon.h"          // event_id | event_idx
 #include "event_sender.h"           // sender | event_idx || hostpart | localpart, event_idx
 #include "event_type.h"             // type | event_idx
 #include "event_state.h"            // state_key, type, room_id, depth, event_idx
+#include "event_relates.h"          // event_idx | rel_type, type, event_idx
 #include "room_events.h"            // room_id | depth, event_idx
 #include "room_type.h"              // room_id | type, depth, event_idx
 #include "room_state.h"             // room_id | type, state_key => event_idx
 #include "room_state_space.h"       // room_id | type, state_key, depth, event_idx
 #include "room_joined.h"            // room_id | origin, member => event_idx
 #include "room_head.h"              // room_id | event_id => event_idx
+#include "user_sync.h"              // user_id | filter_id => (sync snapshot)
 
 /// Options that affect the dbs::write() of an event to the transaction.
 struct ircd::m::dbs::write_opts
@@ -131,6 +134,11 @@ enum ircd::m::dbs::appendix::index
 	/// dark during re-indexing operations to avoid rewriting the same data.
 	EVENT_JSON,
 
+	/// Involves the event_bin column; writes the binary encoding of the
+	/// event when enabled by configuration. Can be dark during re-indexing
+	/// similar to EVENT_JSON.
+	EVENT_BIN,
+
 	/// Involves any direct event columns; such columns are forward-indexed
 	/// values from the original event data but split into columns for each
 	/// property. Can be dark during re-indexing similar to EVENT_JSON.
@@ -160,6 +168,10 @@ enum ircd::m::dbs::appendix::index
 	/// Involves the event_state column.
 	EVENT_STATE,
 
+	/// Involves the event_relates and event_relates_count columns; indexes
+	/// the m.relates_to of an event and adjusts the counter for the target.
+	EVENT_RELATES,
+
 	/// Involves room_events table.
 	ROOM_EVENTS,
 
@@ -0,0 +1,63 @@
+// The Construct
+//
+// Copyright (C) The Construct Developers, Authors & Contributors
+// Copyright (C) 2016-2020 Jason Volk <jason@zemos.net>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice is present in all copies. The
+// full license for this software is available in the LICENSE file.
+
+#pragma once
+#define HAVE_IRCD_M_DBS_EVENT_BIN_H
+
+/// Binary event format. The value is a four byte header followed by a table
+/// of end-offsets for each property present, followed by the property values
+/// in tuple order:
+///
+/// [version:u8][reserved:u8][present:u16][end:u32 * popcount(present)][data]
+///
+/// Bit i of `present` indicates m::event property i is defined. Values are
+/// stored as they are held by the m::event: strings unquoted (but still
+/// escaped), objects and arrays as JSON text, integers as native u64. An
+/// m::event is reconstructed by assigning each property its slice of data
+/// without parsing.
+namespace ircd::m::dbs
+{
+	constexpr uint8_t EVENT_BIN_VERSION
+	{
+		1
+	};
+
+	constexpr size_t EVENT_BIN_HEADER_SIZE
+	{
+		1 + 1 + 2
+	};
+
+	constexpr size_t EVENT_BIN_MAX_SIZE
+	{
+		EVENT_BIN_HEADER_SIZE
+		+ sizeof(uint32_t) * event::size()
+		+ event::MAX_SIZE
+	};
+
+	const_buffer event_bin_encode(const mutable_buffer &out, const event &);
+	bool event_bin_decode(event &, const string_view &bin, const event::keys::selection & = {});
+
+	void _index_event_bin(db::txn &, const event &, const write_opts &);
+
+	extern conf::item<bool> event_bin_enable;
+
+	// event_idx => binary event
+	extern db::column event_bin;
+}
+
+namespace ircd::m::dbs::desc
+{
+	extern conf::item<size_t> event_bin__block__size;
+	extern conf::item<size_t> event_bin__meta_block__size;
+	extern conf::item<size_t> event_bin__cache__size;
+	extern conf::item<size_t> event_bin__cache_comp__size;
+	extern conf::item<size_t> event_bin__bloom__bits;
+	extern const db::descriptor event_bin;
+}
@@ -13,6 +13,8 @@
 
 namespace ircd::m::dbs
 {
+	struct event_idx_filter;
+
 	void _index_event_id(db::txn &, const event &, const write_opts &);
 
 	extern db::column event_idx;       // event_id => event_idx
@@ -27,3 +29,47 @@ namespace ircd::m::dbs::desc
 	extern conf::item<size_t> event_idx__bloom__bits;
 	extern const db::descriptor event_idx;
 }
+
+/// In-memory blocked bloom filter over the keys of event_idx. A negative
+/// answer means the event_id is certainly not in the column, so existence
+/// checks for unknown events (i.e. from federation transactions, fetches and
+/// backfill) don't reach the database. Every event_id is added once the
+/// transaction writing it has been committed; the filter is built from the
+/// column at startup in the background (and again when it has grown past its
+/// capacity) and all answers are positive until then.
+///
+/// Each key sets k bits within one cache-line sized block.
+struct ircd::m::dbs::event_idx_filter
+{
+	struct alignas(64) block
+	{
+		uint64_t word[8] {0};
+	};
+
+	static constexpr const size_t k {7};
+	static conf::item<bool> enable;
+	static conf::item<size_t> bits_per_key;
+	static stats::item queries;
+	static stats::item negatives;
+	static stats::item false_positives;
+	static std::unique_ptr<event_idx_filter> active;
+	static std::unique_ptr<event_idx_filter> building;
+
+	std::vector<block> blocks;
+	size_t capacity {0};
+	size_t keys {0};
+
+	bool test(const string_view &event_id) const noexcept;
+	void set(const string_view &event_id) noexcept;
+	size_t popcount() const noexcept;
+
+	event_idx_filter(const size_t &capacity);
+
+	static bool maybe(const string_view &event_id) noexcept;
+	static void add(const string_view &event_id) noexcept;
+	static void add(const db::txn &);
+	static void missed() noexcept;
+	static void rebuild();
+	static void init();
+	static void fini() noexcept;
+};
@@ -83,6 +83,11 @@ enum class ircd::m::dbs::ref
 	/// The previous states in the transitions for a (type,state_key) cell.
 	PREV_STATE          = 0x04,
 
+	/// All events this event references in its `auth_events`. Unlike the
+	/// NEXT_AUTH graph this is made for every event so the auth chain can be
+	/// walked without fetching any events.
+	PREV_AUTH           = 0x08,
+
 	/// All m.receipt's which target this event.
 	M_RECEIPT__M_READ   = 0x10,
 
@@ -0,0 +1,94 @@
+// The Construct
+//
+// Copyright (C) The Construct Developers, Authors & Contributors
+// Copyright (C) 2016-2020 Jason Volk <jason@zemos.net>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice is present in all copies. The
+// full license for this software is available in the LICENSE file.
+
+#pragma once
+#define HAVE_IRCD_M_DBS_EVENT_RELATES_H
+
+namespace ircd::m::dbs
+{
+	constexpr size_t EVENT_RELATES_KEY_MAX_SIZE
+	{
+		sizeof(event::idx)             // target
+		+ event::TYPE_MAX_SIZE         // rel_type
+		+ 1                            // \0
+		+ event::TYPE_MAX_SIZE         // type
+		+ 1                            // \0
+		+ sizeof(event::idx)           // referer
+	};
+
+	constexpr size_t EVENT_RELATES_COUNT_ANNOTATION_MAX_SIZE
+	{
+		256
+	};
+
+	constexpr size_t EVENT_RELATES_COUNT_KEY_MAX_SIZE
+	{
+		sizeof(event::idx)             // target
+		+ event::TYPE_MAX_SIZE         // rel_type
+		+ 1                            // \0
+		+ event::TYPE_MAX_SIZE         // type
+		+ 1                            // \0
+		+ EVENT_RELATES_COUNT_ANNOTATION_MAX_SIZE
+	};
+
+	// rel_type, type, referer
+	using event_relates_tuple = std::tuple<string_view, string_view, event::idx>;
+
+	// rel_type, type, annotation key
+	using event_relates_count_tuple = std::tuple<string_view, string_view, string_view>;
+
+	event_relates_tuple
+	event_relates_key(const string_view &amalgam);
+
+	string_view
+	event_relates_key(const mutable_buffer &out,
+	                  const event::idx &target,
+	                  const string_view &rel_type  = {},
+	                  const string_view &type      = {},
+	                  const event::idx &referer    = -1);
+
+	event_relates_count_tuple
+	event_relates_count_key(const string_view &amalgam);
+
+	string_view
+	event_relates_count_key(const mutable_buffer &out,
+	                        const event::idx &target,
+	                        const string_view &rel_type  = {},
+	                        const string_view &type      = {},
+	                        const string_view &key       = {});
+
+	void _index_event_relates(db::txn &, const event &, const write_opts &);
+	void _index_event_relates_redact(db::txn &, const event &, const write_opts &, const event::idx &);
+
+	// event_idx | rel_type, type, event_idx
+	extern db::domain event_relates;
+
+	// event_idx | rel_type, type, key => int64_t (merge)
+	extern db::domain event_relates_count;
+}
+
+namespace ircd::m::dbs::desc
+{
+	extern conf::item<size_t> event_relates__block__size;
+	extern conf::item<size_t> event_relates__meta_block__size;
+	extern conf::item<size_t> event_relates__cache__size;
+	extern conf::item<size_t> event_relates__cache_comp__size;
+	extern const db::prefix_transform event_relates__pfx;
+	extern const db::comparator event_relates__cmp;
+	extern const db::descriptor event_relates;
+
+	extern conf::item<size_t> event_relates_count__block__size;
+	extern conf::item<size_t> event_relates_count__meta_block__size;
+	extern conf::item<size_t> event_relates_count__cache__size;
+	extern conf::item<size_t> event_relates_count__cache_comp__size;
+	extern const db::prefix_transform event_relates_count__pfx;
+	extern const db::merge_closure event_relates_count__merge;
+	extern const db::descriptor event_relates_count;
+}
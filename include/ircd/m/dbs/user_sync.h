@@ -0,0 +1,42 @@
+// The Construct
+//
+// Copyright (C) The Construct Developers, Authors & Contributors
+// Copyright (C) 2016-2020 Jason Volk <jason@zemos.net>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice is present in all copies. The
+// full license for this software is available in the LICENSE file.
+
+#pragma once
+#define HAVE_IRCD_M_DBS_USER_SYNC_H
+
+namespace ircd::m::dbs
+{
+	constexpr size_t USER_SYNC_FILTER_MAX_SIZE
+	{
+		256
+	};
+
+	constexpr size_t USER_SYNC_KEY_MAX_SIZE
+	{
+		id::MAX_SIZE + 1 + USER_SYNC_FILTER_MAX_SIZE
+	};
+
+	string_view user_sync_key(const mutable_buffer &out, const id::user &, const string_view &filter_id = {});
+	string_view user_sync_key(const string_view &amalgam);
+
+	// user_id | filter_id => sync snapshot
+	extern db::domain user_sync;
+}
+
+namespace ircd::m::dbs::desc
+{
+	extern conf::item<size_t> user_sync__block__size;
+	extern conf::item<size_t> user_sync__meta_block__size;
+	extern conf::item<size_t> user_sync__cache__size;
+	extern conf::item<size_t> user_sync__cache_comp__size;
+	extern conf::item<size_t> user_sync__bloom__bits;
+	extern const db::prefix_transform user_sync__pfx;
+	extern const db::descriptor user_sync;
+}
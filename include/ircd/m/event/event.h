@@ -96,6 +96,7 @@ struct ircd::m::event
 {
 	struct prev;
 	struct refs;
+	struct relations;
 	struct horizon;
 	struct fetch;
 	struct conforms;
@@ -153,6 +154,7 @@ struct ircd::m::event
 
 #include "prev.h"
 #include "refs.h"
+#include "relations.h"
 #include "horizon.h"
 #include "index.h"
 #include "event_id.h"
@@ -51,6 +51,7 @@ struct ircd::m::event::fetch
 	const opts *fopts {&default_opts};
 	idx event_idx {0};
 	std::array<db::cell, event::size()> cell;
+	db::cell _bin;
 	db::cell _json;
 	db::row row;
 	bool valid;
@@ -58,8 +59,10 @@ struct ircd::m::event::fetch
 
 	static string_view key(const event::idx *const &);
 	static bool should_seek_json(const opts &);
+	static bool should_seek_bin(const opts &);
 	bool assign_from_row(const string_view &key);
 	bool assign_from_json(const string_view &key);
+	bool assign_from_bin(const string_view &key);
 
   public:
 	explicit fetch(std::nothrow_t, const idx &, const id &, const opts & = default_opts);
@@ -92,6 +95,12 @@ struct ircd::m::event::fetch
 /// cost is that the full event JSON is read from storage (up to 64_KiB) and
 /// maintained in cache.
 ///
+/// - Binary Query: When the binary event format is enabled a JSON query is
+/// first attempted as a single point lookup to the binary encoding, which is
+/// assigned to the event without parsing. The event source is not available
+/// from this query; callers which need the source JSON (i.e. to send it over
+/// the wire verbatim) must set `query_json_force`.
+///
 struct ircd::m::event::fetch::opts
 {
 	/// Event property selector
@@ -103,7 +112,8 @@ struct ircd::m::event::fetch::opts
 	/// Whether to force an attempt at populating the event from event_json
 	/// first, bypassing any decision-making. This is useful if a key selection
 	/// is used which would trigger a row query but the developer wants the
-	/// json query anyway.
+	/// json query anyway. This also bypasses the binary query so the source
+	/// JSON is always available.
 	bool query_json_force {false};
 
 	opts(const event::keys::selection &, const db::gopts & = {});
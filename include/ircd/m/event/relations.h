@@ -0,0 +1,55 @@
+// The Construct
+//
+// Copyright (C) The Construct Developers, Authors & Contributors
+// Copyright (C) 2016-2020 Jason Volk <jason@zemos.net>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice is present in all copies. The
+// full license for this software is available in the LICENSE file.
+
+#pragma once
+#define HAVE_IRCD_M_EVENT_RELATIONS_H
+
+/// Interface to the relations made to an event by other events with an
+/// m.relates_to in their content. Relations are pre-indexed by rel_type and
+/// the type of the relating event, from the most recent to the least; the
+/// counters are maintained at insertion (and redaction) of each relation, so
+/// aggregations are available without iterating or fetching any referer.
+struct ircd::m::event::relations
+{
+	using closure = std::function<bool (const event::idx &, const string_view &rel_type, const string_view &type)>;
+	using count_closure = std::function<bool (const string_view &rel_type, const string_view &type, const string_view &key, const int64_t &)>;
+
+	event::idx idx;
+
+  public:
+	bool for_each(const string_view &rel_type, const string_view &type, const event::idx &from, const closure &) const;
+	bool for_each(const string_view &rel_type, const string_view &type, const closure &) const;
+	bool for_each(const string_view &rel_type, const closure &) const;
+	bool for_each(const closure &) const;
+
+	bool for_each_count(const string_view &rel_type, const string_view &type, const count_closure &) const;
+	bool for_each_count(const string_view &rel_type, const count_closure &) const;
+	bool for_each_count(const count_closure &) const;
+
+	int64_t count(const string_view &rel_type, const string_view &type, const string_view &key = {}) const;
+	size_t count(const string_view &rel_type) const;
+	size_t count() const;
+
+	bool has(const string_view &rel_type) const;
+	bool has() const;
+
+	bool prefetch(const string_view &rel_type) const;
+	bool prefetch() const;
+
+	relations(const event::idx &idx) noexcept;
+
+	static void rebuild();
+};
+
+inline
+ircd::m::event::relations::relations(const event::idx &idx)
+noexcept
+:idx{idx}
+{}
@@ -17,8 +17,10 @@
 /// remote parties serially. It operates by querying servers in a room until
 /// one server can provide a satisfying response. The exact method for
 /// determining who to contact, when and how is encapsulated internally for
-/// further development, but it is primarily stochastic. This is liable to be
-/// optimized with further development of selection algorithms and hinting.
+/// further development, but it is primarily stochastic: servers are selected
+/// at random, weighted by a score of their past latency and reliability. When
+/// an attempt is slow to respond a second "hedged" attempt may be made to the
+/// next selection; the first to respond is used and the other is canceled.
 /// All viable servers in a room are exhausted before an error is the result.
 ///
 /// This is an asynchronous promise/future based interface. The result package
@@ -43,6 +45,7 @@ namespace ircd::m::fetch
 	struct opts;
 	struct result;
 	struct request;
+	struct score;
 	enum class op :uint8_t;
 
 	// Observers
@@ -166,6 +169,23 @@ struct ircd::m::fetch::request
 	/// Our future for the server::request. Since we make
 	std::unique_ptr<server::request> future;
 
+	/// Reference to the server of a hedged attempt; this is a second attempt
+	/// made concurrently when the current attempt is slow to respond. This
+	/// string is also placed in the attempted set.
+	string_view hedge_origin;
+
+	/// Time the hedged attempt was started.
+	system_point hedged;
+
+	/// HTTP heads and scratch buffer for the hedged server::request; this is
+	/// allocated the first time the request is hedged.
+	unique_buffer<mutable_buffer> hedge_buf;
+
+	/// Future for the hedged server::request. Whichever of this and the
+	/// primary future responds first becomes the primary; the other one is
+	/// canceled.
+	std::unique_ptr<server::request> hedge;
+
 	/// Promise for our user's future of this request.
 	ctx::promise<result> promise;
 
@@ -185,6 +205,34 @@ struct ircd::m::fetch::request
 	~request() noexcept;
 };
 
+/// Scoreboard entry for a remote server. These are kept by the m::fetch unit
+/// for every server it has made requests to, for the life of the process, and
+/// drive the selection of servers for future attempts. Like fetch::request
+/// this is exposed for examination only.
+struct ircd::m::fetch::score
+{
+	using closure = std::function<bool (const string_view &, const score &)>;
+
+	/// Moving average of the response time in milliseconds. This is updated by
+	/// successful responses and by timeouts.
+	double latency {0.0};
+
+	/// Moving average of the outcome of requests; 1.0 is all successful.
+	double success {1.0};
+
+	/// Number of responses and errors (including timeouts) observed.
+	size_t requests {0};
+	size_t errors {0};
+
+	/// Time of the last outcome observed.
+	system_point last;
+
+	/// Message of the last error observed.
+	std::string error;
+
+	static bool for_each(const closure &);
+};
+
 /// Internally held
 struct ircd::m::fetch::init
 {
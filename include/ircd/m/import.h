@@ -0,0 +1,70 @@
+// The Construct
+//
+// Copyright (C) The Construct Developers, Authors & Contributors
+// Copyright (C) 2016-2020 Jason Volk <jason@zemos.net>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice is present in all copies. The
+// full license for this software is available in the LICENSE file.
+
+#pragma once
+#define HAVE_IRCD_M_IMPORT_H
+
+/// Native bulk import of an event stream, i.e. the concatenated JSON events
+/// produced by tools/synapse.db.py from a Synapse database dump. Events are
+/// sequenced and indexed in batches directly into SST files which are then
+/// ingested into the events database. Evaluation by the vm is skipped
+/// entirely so the data must be trusted. The import is refused while any
+/// evaluation is in progress and new evaluations wait until it's finished.
+namespace ircd::m::import
+{
+	IRCD_M_EXCEPTION(m::error, error, http::INTERNAL_SERVER_ERROR)
+
+	struct opts;
+	struct import;
+
+	extern log::log log;
+	extern conf::item<size_t> batch_size;
+	extern conf::item<size_t> buffer_size;
+	extern conf::item<size_t> buffer_max;
+}
+
+struct ircd::m::import::import
+{
+	size_t read {0};                   ///< Events read from the stream
+	size_t imported {0};               ///< Events ingested into the database
+	size_t skipped {0};                ///< Events existing or unusable
+	size_t batches {0};                ///< Batches ingested
+	size_t files {0};                  ///< SST files ingested
+	size_t sampled {0};                ///< Events validated after ingestion
+	size_t failed {0};                 ///< Events failing validation
+	event::idx_range range {0, 0};     ///< Indexes assigned to imported events
+
+	import(const string_view &path, const opts &);
+};
+
+struct ircd::m::import::opts
+{
+	/// Maximum number of events to import; 0 is unlimited.
+	size_t limit {0};
+
+	/// Number of events indexed into each batch of SST files; 0 uses the
+	/// configured batch_size.
+	size_t batch {0};
+
+	/// Validate every Nth imported event with event::conforms after it has
+	/// been ingested; 0 disables validation.
+	size_t sample {1024};
+
+	/// Skip events which already exist in the database.
+	bool exists {true};
+
+	/// Store the JSON source of each event directly rather than
+	/// re-stringifying it; only appropriate for canonical JSON input.
+	bool json_source {false};
+
+	/// Directory for the intermediate SST files; defaults to an `import`
+	/// directory in the database path.
+	string_view dir;
+};
@@ -54,6 +54,7 @@ struct ircd::m::keys
 >
 {
 	struct cache;
+	struct pk;
 
 	using queries = vector_view<const fed::key::server_key>; // <server, key_id>
 	using closure = std::function<void (const json::object &)>;
@@ -76,3 +77,43 @@ struct ircd::m::keys::cache
 	static bool get(const string_view &server, const string_view &key_id, const closure &);
 	static size_t set(const json::object &keys);
 };
+
+/// Decoded public keys. Verifying a signature requires the ed25519 public key
+/// of the origin; this holds keys already decoded from the cache above so the
+/// verification path skips the room state lookup, the JSON parse and the b64
+/// decode. Keys which could not be found are held as negative entries for a
+/// short time so a missing key doesn't repeat the full lookup either; an
+/// error from the lookup is held the same way and thrown to every caller
+/// until then. A key past its valid_until_ts is refreshed from its server at
+/// most once per negative_ttl, and used as it is meanwhile. Entries for a
+/// server are invalidated whenever its keys are updated; the least recently
+/// used entry is evicted when the cache is full.
+struct ircd::m::keys::pk
+{
+	struct entry;
+
+	using closure = std::function<void (const ed25519::pk &)>;
+	using entry_closure = std::function<bool (const string_view &, const entry &)>;
+
+	static conf::item<size_t> cache_max;
+	static conf::item<seconds> negative_ttl;
+	static stats::item hits;
+	static stats::item misses;
+	static stats::item negatives;
+	static std::map<std::string, entry, std::less<>> cache; // "server key_id"
+	static std::list<string_view> lru; // keys of cache; least recent first
+
+	static bool for_each(const entry_closure &);
+	static size_t clear(const string_view &server);
+	static bool get(const string_view &server, const string_view &key_id, const closure &);
+};
+
+struct ircd::m::keys::pk::entry
+{
+	ed25519::pk key;
+	std::exception_ptr eptr;      // negative entries for a failed lookup
+	std::list<string_view>::iterator lru;
+	time_t valid_until_ts {0};    // milliseconds
+	time_t expires {0};           // milliseconds; retry after (see above)
+	bool found {false};
+};
@@ -97,6 +97,7 @@ namespace ircd
 #include "gossip.h"
 #include "acquire.h"
 #include "burst.h"
+#include "import.h"
 #include "resource.h"
 #include "homeserver.h"
 
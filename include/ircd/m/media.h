@@ -19,11 +19,14 @@ namespace ircd::m::media
 namespace ircd::m::media::file
 {
 	using closure = std::function<void (const const_buffer &)>;
+	using source = std::function<const_buffer (const mutable_buffer &)>;
 
 	room::id room_id(room::id::buf &out, const mxc &);
 	room::id::buf room_id(const mxc &);
 
+	size_t read(const room &, const size_t &offset, const size_t &length, const closure &);
 	size_t read(const room &, const closure &);
+	size_t write(const room &, const user::id &, const size_t &content_length, const string_view &content_type, const source &);
 	size_t write(const room &, const user::id &, const const_buffer &content, const string_view &content_type);
 
 	room::id::buf
@@ -75,6 +75,7 @@ struct ircd::m::room::auth::chain
 
   public:
 	bool for_each(const closure &) const;
+	bool has(const event::idx &) const;
 	bool has(const string_view &type) const;
 	size_t depth() const;
 
@@ -46,17 +46,28 @@ namespace ircd::m
 /// full event. One can iterate just event_idx's by using event_idx() instead
 /// of the dereference operators.
 ///
+/// When readahead() is enabled the iterator keeps a window of prefetches in
+/// flight in front of its position as it is moved. The size of the window
+/// adapts to the pace of the caller relative to the latency observed by the
+/// db::prefetcher so a page of events on a cold cache is requested at once.
+///
 struct ircd::m::room::events
 {
 	struct sounding;
 	struct horizon;
 	struct missing;
+	struct window;
 
 	static conf::item<ssize_t> viewport_size;
+	static conf::item<size_t> readahead_min;
+	static conf::item<size_t> readahead_max;
 
 	m::room room;
 	db::domain::const_iterator it;
 	event::fetch _event;
+	std::unique_ptr<window> _window;
+
+	void advance(const bool &ascending);
 
   public:
 	explicit operator bool() const     { return bool(it);                      }
@@ -76,8 +87,11 @@ struct ircd::m::room::events
 	bool preseek(const uint64_t &depth = -1);
 
 	// Move the iterator
-	auto &operator++()                 { return --it;                          }
-	auto &operator--()                 { return ++it;                          }
+	auto &operator++()                 { --it; if(_window) advance(true); return it;   }
+	auto &operator--()                 { ++it; if(_window) advance(false); return it;  }
+
+	// Prefetch up to limit events ahead of the iterator as it moves (0 disables)
+	bool readahead(const size_t &limit, const bool &ascending = false);
 
 	// Fetch the actual event data at the iterator's position
 	const m::event &operator*();
@@ -103,6 +117,7 @@ struct ircd::m::room::events
 	events() = default;
 	events(const events &) = delete;
 	events &operator=(const events &) = delete;
+	~events() noexcept;
 
 	// Prefetch a new iterator (without any construction)
 	static bool preseek(const m::room &, const uint64_t &depth = -1);
@@ -15,6 +15,7 @@
 namespace ircd::m::rooms::summary
 {
 	struct fetch;
+	struct index;
 	using closure = std::function<bool (const string_view &, const json::object &)>;
 	using closure_idx = std::function<bool (const string_view &, const event::idx &)>;
 
@@ -53,3 +54,32 @@ struct ircd::m::rooms::summary::fetch
 
 	fetch() = default;
 };
+
+/// Ranked index of the public rooms directory. Entries are ordered by origin,
+/// then by descending number of joined members, and each holds the summary
+/// chunk presented to clients. It is built from the public rooms room when
+/// first used and then maintained by hooks on the summary events and on
+/// state changes to the local rooms it lists. Those hooks never run on a
+/// secondary instance, so it isn't used there.
+struct ircd::m::rooms::summary::index
+{
+	using key = std::tuple<std::string, long, std::string>; // origin, -joined, room_id
+	using closure = std::function<bool (const room::id &, const json::object &)>;
+
+	static conf::item<bool> enable;
+	static std::map<key, std::string> ranked;
+	static std::map<std::string, long, std::less<>> joined;
+	static std::map<std::string, size_t, std::less<>> counts;
+	static ctx::mutex mutex;
+	static bool built;
+
+	static void set(const room::id &, const string_view &origin, const json::object &chunk);
+	static bool del(const room::id &, const string_view &origin);
+	static bool refresh(const room &);
+	static size_t rebuild();
+
+  public:
+	static bool available();
+	static size_t count(const string_view &origin);
+	static bool for_each(const string_view &origin, const room::id &since, const closure &);
+};
@@ -55,6 +55,7 @@ struct ircd::m::sync::item
 	json::strung feature;
 	json::object opts;
 	bool phased;
+	bool snapshot;
 
   public:
 	string_view name() const;
@@ -86,6 +87,15 @@ struct ircd::m::sync::data
 	/// in this case, and only handlers with the phased feature
 	bool phased {false};
 
+	/// Whether this is composing the stored snapshot of the user's initial
+	/// sync rather than a response. Items without the snapshot feature
+	/// (i.e. those specific to a device) are skipped in this case.
+	bool snapshot {false};
+
+	/// When non-null a polylog only includes these rooms; used to recompose
+	/// the sections of a snapshot for the rooms which have changed.
+	const std::set<std::string, std::less<>> *rooms_only {nullptr};
+
 	/// Statistics tracking. If null, stats won't be accumulated for the sync.
 	sync::stats *stats {nullptr};
 
@@ -201,6 +211,9 @@ struct ircd::m::sync::args
 
 	/// Constructed by the GET /sync request method handler on its stack.
 	args(const ircd::resource::request &request);
+
+	/// Internal syncs (i.e. snapshots) fill in the members themselves.
+	args() = default;
 };
 
 inline bool
@@ -24,6 +24,13 @@ struct ircd::net::acceptor
 	using callback = listener::callback;
 	using proffer = listener::proffer;
 	using sockets = std::list<std::shared_ptr<socket>>;
+	struct ticket_key;
+	#if OPENSSL_VERSION_NUMBER >= 0x30000000L && !defined(LIBRESSL_VERSION_NUMBER)
+	using ticket_mac = EVP_MAC_CTX;
+	#else
+	using ticket_mac = HMAC_CTX;
+	#endif
+	struct offload;
 
 	IRCD_EXCEPTION(listener::error, error)
 	IRCD_EXCEPTION(error, sni_warning)
@@ -35,6 +42,16 @@ struct ircd::net::acceptor
 	static conf::item<std::string> ssl_curve_list;
 	static conf::item<std::string> ssl_cipher_list;
 	static conf::item<std::string> ssl_cipher_blacklist;
+	static conf::item<bool> ssl_tickets;
+	static conf::item<seconds> ssl_tickets_rotate;
+	static conf::item<size_t> ssl_session_cache_size;
+	static conf::item<seconds> ssl_session_timeout;
+	static conf::item<size_t> offload_threads;
+	static conf::item<bool> offload_accept;
+	static stats::item handshakes_total;
+	static stats::item handshakes_resumed;
+	static stats::item tickets_rotated;
+	static stats::histogram handshake_latency;
 
 	net::listener *listener_;
 	std::string name;
@@ -50,6 +67,11 @@ struct ircd::net::acceptor
 	sockets handshaking;
 	bool interrupting {false};
 	ctx::dock joining;
+	std::unique_ptr<ticket_key[]> ticket_keys;   // [0] issues; [1] accepts
+	std::mutex ticket_keys_mutex;                // handshakes on offload threads
+	std::unique_ptr<struct offload> offloader;
+	size_t handshakes {0};
+	size_t resumed {0};
 
 	// Internal configuration
 	void configure_dh(const json::object &);
@@ -58,19 +80,26 @@ struct ircd::net::acceptor
 	void configure_ciphers(const json::object &);
 	void configure_flags(const json::object &);
 	void configure_password(const json::object &);
+	void configure_sessions(const json::object &);
 	void configure(const json::object &opts);
 
+	// Session ticket stack
+	void rotate_ticket_keys();
+	int handle_ticket(SSL &, uint8_t *name, uint8_t *iv, EVP_CIPHER_CTX &, ticket_mac &, const bool enc);
+
 	// Handshake stack
 	bool handle_sni(SSL &, int &ad);
 	string_view handle_alpn(SSL &, const vector_view<const string_view> &in);
 	void check_handshake_error(const error_code &ec, socket &) const;
-	void handshake(const error_code &, const std::shared_ptr<socket>, const decltype(handshaking)::const_iterator) noexcept;
+	void handshake(const error_code &, const std::shared_ptr<socket>, const decltype(handshaking)::const_iterator, const steady_point) noexcept;
+	void handshake_offload(const std::shared_ptr<socket>, const decltype(handshaking)::const_iterator, const steady_point);
 
 	// Acceptance stack
 	static bool proffer_default(listener &, const ipport &);
 	bool check_handshake_limit(socket &, const ipport &) const;
 	bool check_accept_error(const error_code &ec, socket &) const;
 	void accept(const error_code &, const std::shared_ptr<socket>) noexcept;
+	void accept_offload(const int fd) noexcept;
 
 	// Accept next
 	bool set_handle();
@@ -89,3 +118,72 @@ struct ircd::net::acceptor
 
 	~acceptor() noexcept;
 };
+
+/// Key material for encrypting session tickets issued by an acceptor. The
+/// acceptor issues tickets with the newest key and still accepts tickets from
+/// the key it replaced, so a ticket remains valid for at least one rotation.
+struct ircd::net::acceptor::ticket_key
+{
+	uint8_t name[16] {0};
+	uint8_t aes[32] {0};
+	uint8_t hmac[32] {0};
+	time_t created {0};
+};
+
+/// Pool of threads conducting the TLS handshake for an acceptor off the main
+/// thread. Each handshake is performed with blocking I/O on the accepted
+/// socket, which hasn't yet been used asynchronously. The socket is owned by
+/// the offload thread from the time it's queued until the result is posted
+/// back to the main thread, which doesn't touch it in the meantime; the
+/// deadline and a close of the listener only reach the handshake through its
+/// state, which wakes it by shutting down the descriptor.
+///
+/// Optionally each thread also accepts connections from its own SO_REUSEPORT
+/// socket bound to the listener's address, so the kernel spreads incoming
+/// connections over them; the descriptors are posted to the main thread to
+/// become sockets there.
+struct ircd::net::acceptor::offload
+{
+	struct handshake;
+	using job = std::function<void ()>;
+
+	acceptor &a;
+	std::mutex mutex;
+	std::condition_variable cond;
+	std::deque<job> queue;
+	std::vector<std::thread> threads;
+	std::vector<int> listeners;
+	std::vector<std::thread> accepters;
+	std::set<std::shared_ptr<handshake>> handshakes;   // main thread only
+	std::atomic<size_t> posted {0};
+	std::atomic<bool> closing {false};
+	bool termination {false};
+
+	void worker() noexcept;
+	void accepter(const int fd) noexcept;
+	void terminate() noexcept;
+
+  public:
+	void operator()(job);
+	void cancel() noexcept;
+	void close() noexcept;
+
+	offload(acceptor &, const size_t &threads, const bool &accept);
+	offload(offload &&) = delete;
+	offload(const offload &) = delete;
+	~offload() noexcept;
+};
+
+/// State of one offloaded handshake shared between the threads. Only the
+/// descriptor number and the timeout flag are read by the offload thread.
+struct ircd::net::acceptor::offload::handshake
+{
+	int fd {-1};
+	std::atomic<bool> timedout {false};
+	asio::deadline_timer timer;
+	bool done {false};
+
+	void cancel() noexcept;
+
+	handshake(const int &fd);
+};
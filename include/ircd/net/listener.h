@@ -27,6 +27,8 @@ namespace ircd::net
 	size_t handshaking_count(const acceptor &, const ipaddr &);
 	size_t handshaking_count(const acceptor &);
 	size_t accepting_count(const acceptor &);
+	size_t handshook_count(const acceptor &);
+	size_t resumed_count(const acceptor &);
 
 	string_view loghead(const mutable_buffer &, const acceptor &);
 	string_view loghead(const acceptor &);
@@ -113,6 +113,16 @@ struct ircd::net::open_opts
 
 	/// Option to allow expired certificates.
 	bool allow_expired { default_allow_expired };
+
+	/// Session from a previous connection to the same remote. When given it
+	/// is offered for resumption during the handshake which saves the full
+	/// key exchange if the remote still accepts it.
+	std::shared_ptr<openssl::SSL_SESSION> session;
+
+	/// Application protocols offered in the handshake in order of preference.
+	/// The protocol selected by the remote can be found with openssl::alpn()
+	/// after the handshake; none is offered by default.
+	vector_view<const string_view> alpn;
 };
 
 /// Constructor intended to provide implicit conversions (no-brackets required)
@@ -52,6 +52,8 @@ struct ircd::net::socket
 	static stats::item total_bytes_out;
 	static stats::item total_calls_in;
 	static stats::item total_calls_out;
+	static stats::item total_handshakes;
+	static stats::item total_resumed;
 
 	uint64_t id {++count};
 	ip::tcp::socket sd;
@@ -17,6 +17,7 @@
 struct ssl_st;
 struct ssl_ctx_st;
 struct ssl_cipher_st;
+struct ssl_session_st;
 struct rsa_st;
 struct x509_st;
 struct x509_store_ctx_st;
@@ -43,6 +44,7 @@ namespace ircd::openssl
 	using SSL = ::ssl_st;
 	using SSL_CTX = ::ssl_ctx_st;
 	using SSL_CIPHER = ::ssl_cipher_st;
+	using SSL_SESSION = ::ssl_session_st;
 	using RSA = ::rsa_st;
 	using X509 = ::x509_st;
 	using X509_STORE_CTX = ::x509_store_ctx_st;
@@ -63,6 +65,9 @@ namespace ircd::openssl
 	ulong get_error();
 	void clear_error();
 
+	// Fills the buffer from the library's CSPRNG
+	const_buffer rand_bytes(const mutable_buffer &out);
+
 	// Envelope suite
 	EVP_PKEY &read_pem_pub(EVP_PKEY &out, const string_view &pem);
 	EVP_PKEY &read_pem_priv(EVP_PKEY &out, const string_view &pem);
@@ -140,6 +145,16 @@ namespace ircd::openssl
 	string_view server_name(const SSL &); // provided by client
 	void server_name(SSL &, const string_view &); // set by client
 
+	// Session suite
+	bool session_reused(const SSL &);
+	bool resumable(const SSL_SESSION &);
+	std::shared_ptr<SSL_SESSION> get_session(SSL &); // null if not resumable
+	void set_session(SSL &, SSL_SESSION &); // offer for resumption by client
+
+	// ALPN suite
+	string_view alpn(const SSL &); // selected by handshake; empty if none
+	void alpn(SSL &, const vector_view<const string_view> &); // offered by client
+
 	// Header version; library version
 	extern const info::versions version_api, version_abi;
 	extern const info::versions libressl_version_api;
@@ -32,6 +32,7 @@ struct ircd::resource
 
 	static log::log log;
 	static std::map<string_view, resource *, iless> resources;
+	static conf::item<std::string> secondary_allow;
 
 	string_view path;
 	std::unique_ptr<const struct opts> opts;
@@ -56,6 +57,7 @@ struct ircd::resource
 	~resource() noexcept;
 
 	static resource &find(const string_view &path);
+	static bool allowed(const string_view &method, const string_view &path);
 };
 
 #include "method.h"
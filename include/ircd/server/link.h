@@ -21,14 +21,19 @@ namespace ircd::server
 ///
 struct ircd::server::link
 {
+	struct h2;
+
 	static conf::item<size_t> tag_max_default;
 	static conf::item<size_t> tag_commit_max_default;
+	static conf::item<size_t> http2_streams_max;
+	static conf::item<size_t> http2_window;
 	static uint64_t ids;
 
 	uint64_t id {++ids};                         ///< unique identifier of link.
 	server::peer *peer;                          ///< backreference to peer
 	std::shared_ptr<net::socket> socket;         ///< link's socket
 	std::list<tag> queue;                        ///< link's work queue
+	std::unique_ptr<struct h2> h2;               ///< HTTP/2 state if negotiated
 	time_t synack_ts {0L};                       ///< time socket was estab
 	time_t read_ts {0L};                         ///< time of last read
 	time_t write_ts {0L};                        ///< time of last write
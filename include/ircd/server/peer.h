@@ -27,6 +27,9 @@ struct ircd::server::peer
 	static conf::item<size_t> link_min_default;
 	static conf::item<size_t> link_max_default;
 	static conf::item<seconds> error_clear_default;
+	static conf::item<bool> session_resume;
+	static conf::item<bool> enable_http2;
+	static const string_view alpn_protocols[2];
 	static uint64_t ids;
 
 	uint64_t id {++ids};
@@ -57,6 +60,7 @@ struct ircd::server::peer
 	void disperse(link &);
 	void del(link &);
 
+	void save_session(const link &);
 	void handle_head_recv(const link &, const tag &, const http::response::head &);
 	void handle_link_done(link &);
 	void handle_tag_done(link &, tag &) noexcept;
@@ -14,12 +14,14 @@
 namespace ircd::stats
 {
 	struct item;
+	struct histogram;
 	using value_type = int128_t;
 
 	IRCD_EXCEPTION(ircd::error, error)
 	IRCD_EXCEPTION(error, not_found)
 
 	extern std::map<string_view, item *> items;
+	extern std::map<string_view, histogram *> histograms;
 
 	const value_type &get(const item &);
 	value_type &get(item &);
@@ -29,6 +31,7 @@ namespace ircd::stats
 	value_type &set(item &, const value_type & = 0);
 
 	std::ostream &operator<<(std::ostream &, const item &);
+	std::ostream &operator<<(std::ostream &, const histogram &);
 }
 
 struct ircd::stats::item
@@ -57,6 +60,111 @@ struct ircd::stats::item
 	~item() noexcept;
 };
 
+/// Log-linear histogram of unsigned samples (i.e latencies) in the manner of
+/// HdrHistogram. Each power of two is split into sub_count linear buckets so
+/// a percentile is reported within 1/sub_count of the true value over the
+/// whole 64-bit range at a fixed size. Recording is a few relaxed atomic
+/// increments and never locks; readers may see a sample half-recorded.
+///
+/// Histograms constructed with a name are registered for display like items;
+/// unnamed histograms are members of some other structure which reports them.
+struct ircd::stats::histogram
+{
+	static constexpr const size_t sub_bits {3};
+	static constexpr const size_t sub_count {1UL << sub_bits};
+	static constexpr const size_t bucket_count {(64 - sub_bits + 1) * sub_count};
+
+	json::strung feature_;
+	json::object feature;
+	string_view name;
+	std::array<std::atomic<uint64_t>, bucket_count> bucket {};
+	std::atomic<uint64_t> count {0};
+	std::atomic<uint64_t> sum {0};
+	std::atomic<uint64_t> max {0};
+
+	static size_t index(const uint64_t &) noexcept;
+	static uint64_t lower(const size_t &index) noexcept;
+	static uint64_t upper(const size_t &index) noexcept;
+
+  public:
+	uint64_t percentile(const double &pct) const noexcept;
+	uint64_t mean() const noexcept;
+
+	void operator()(const uint64_t &) noexcept;
+	histogram &operator+=(const histogram &) noexcept;
+	void clear() noexcept;
+
+	histogram(const json::members &);
+	histogram() = default;
+	histogram(histogram &&) = delete;
+	histogram(const histogram &) = delete;
+	~histogram() noexcept;
+};
+
+inline void
+ircd::stats::histogram::operator()(const uint64_t &val)
+noexcept
+{
+	static const auto order
+	{
+		std::memory_order_relaxed
+	};
+
+	bucket[index(val)].fetch_add(1, order);
+	count.fetch_add(1, order);
+	sum.fetch_add(val, order);
+
+	auto cur(max.load(order));
+	while(val > cur && !max.compare_exchange_weak(cur, val, order));
+}
+
+inline uint64_t
+ircd::stats::histogram::mean()
+const noexcept
+{
+	const auto count
+	{
+		this->count.load(std::memory_order_relaxed)
+	};
+
+	return count?
+		sum.load(std::memory_order_relaxed) / count:
+		0UL;
+}
+
+inline uint64_t
+ircd::stats::histogram::upper(const size_t &index)
+noexcept
+{
+	return index < sub_count?
+		index:
+		lower(index) + (1UL << ((index >> sub_bits) - 1)) - 1;
+}
+
+inline uint64_t
+ircd::stats::histogram::lower(const size_t &index)
+noexcept
+{
+	return index < sub_count?
+		index:
+		(sub_count | (index & (sub_count - 1))) << ((index >> sub_bits) - 1);
+}
+
+inline size_t
+ircd::stats::histogram::index(const uint64_t &val)
+noexcept
+{
+	if(val < sub_count)
+		return val;
+
+	const uint shift
+	{
+		63U - __builtin_clzl(val) - uint(sub_bits)
+	};
+
+	return ((shift + 1) << sub_bits) | ((val >> shift) & (sub_count - 1));
+}
+
 inline ircd::stats::item &
 ircd::stats::item::operator--()
 {
@@ -92,6 +92,12 @@ ircd::client::pool_opts
 {
 	size_t(settings.stack_size),
 	size_t(settings.pool_size),
+	-1,                    // queue max hard
+	0,                     // queue max soft
+	true,                  // queue max blocking
+	true,                  // queue max warning
+	0,                     // ionice
+	-1,                    // nice (interactive class)
 };
 
 /// The pool of request contexts. When a client makes a request it does so by acquiring
@@ -83,6 +83,7 @@ ircd::ctx::ctx::~ctx()
 noexcept
 {
 	assert(yc == nullptr); // Check that the context isn't active.
+	sched::resumed(*this);
 }
 
 void
@@ -129,6 +130,7 @@ noexcept try
 		adjoindre.notify_all();
 		stack.at = 0;
 		notes = 0;
+		sched::resumed(*this);
 		this->yc = nullptr;
 		ircd::ctx::current = nullptr;
 		if(flags & context::DETACH && !std::uncaught_exceptions())
@@ -252,9 +254,39 @@ ircd::ctx::ctx::wait()
 	assert(current == this);
 	assert(notes == 1);  // notes = 1; set by continuation dtor on wakeup
 
+	// A background context goes once more to the back of the queue if work
+	// of a higher class became ready while it was asleep.
+	sched::resumed(*this);
+	if(unlikely(sched::deferrable(*this)))
+		defer();
+
 	return true;
 }
 
+/// Requeue this context behind everything already queued to run, then
+/// resume. Notes received meanwhile are absorbed as if the context were
+/// running, as it is already awake.
+void
+IRCD_CTX_STACK_PROTECT
+ircd::ctx::ctx::defer()
+{
+	assert(this->yc);
+	assert(current == this);
+	assert(notes == 1);
+
+	continuation
+	{
+		continuation::false_predicate, continuation::noop_interruptor, []
+		(auto &yield) noexcept
+		{
+			boost::asio::post(ios::get(), yield);
+		}
+	};
+
+	assert(current == this);
+	assert(notes == 1);
+}
+
 /// Notifies this context to resume (wake up from waiting).
 ///
 /// Returns true if this note was the first note received by this context
@@ -277,6 +309,7 @@ bool
 ircd::ctx::ctx::wake()
 noexcept try
 {
+	sched::readied(*this);
 	alarm.cancel();
 	return true;
 }
@@ -636,6 +669,32 @@ noexcept
 	return ctx.nice;
 }
 
+/// Returns the scheduling class following from the nice-value
+[[gnu::hot]]
+ircd::ctx::prio
+ircd::ctx::prio_class(const ctx &ctx)
+noexcept
+{
+	return
+		ctx.nice < 0? prio::INTERACTIVE:
+		ctx.nice > 0? prio::BACKGROUND:
+		              prio::NORMAL;
+}
+
+ircd::string_view
+ircd::ctx::reflect(const prio &p)
+{
+	switch(p)
+	{
+		case prio::INTERACTIVE:    return "INTERACTIVE";
+		case prio::NORMAL:         return "NORMAL";
+		case prio::BACKGROUND:     return "BACKGROUND";
+		case prio::_NUM_:          break;
+	}
+
+	return "?????";
+}
+
 /// Returns the yield count for `ctx`
 [[gnu::hot]]
 const uint64_t &
@@ -799,6 +858,22 @@ ircd::ctx::this_ctx::interruption_point()
 	return cur().interruption_point();
 }
 
+/// A background context which has used up its time slice yields here while
+/// work of a higher class is waiting; otherwise this returns immediately.
+/// Call this only at points in a loop where yielding is known to be safe,
+/// i.e. where nothing which other contexts might touch is held inconsistent.
+/// Returns true if the context yielded.
+bool
+ircd::ctx::this_ctx::yield_slice()
+{
+	auto &c(cur());
+	if(likely(!sched::yieldable(c)))
+		return false;
+
+	c.defer();
+	return true;
+}
+
 /// Returns true if the currently running context was interrupted and clears
 /// the interrupt flag.
 bool
@@ -1592,6 +1667,79 @@ ircd::ctx::debug_stats(const pool &pool)
 	};
 }
 
+///////////////////////////////////////////////////////////////////////////////
+//
+// (internal) sched
+//
+
+decltype(ircd::ctx::sched::enable)
+ircd::ctx::sched::enable
+{
+	{ "name",     "ircd.ctx.sched.enable" },
+	{ "default",  true                    },
+};
+
+// background contexts yield after this number of tsc ticks...
+decltype(ircd::ctx::sched::background_slice)
+ircd::ctx::sched::background_slice
+{
+	{ "name",     "ircd.ctx.sched.background.slice" },
+	{ "default",  20 * 1000000L                     },
+};
+
+/// Number of contexts of each class which have been woken and have not yet
+/// resumed; i.e. what is waiting in the ios queue to run.
+decltype(ircd::ctx::sched::ready)
+ircd::ctx::sched::ready;
+
+[[gnu::hot]]
+bool
+ircd::ctx::sched::deferrable(const ctx &c)
+noexcept
+{
+	return prio_class(c) == prio::BACKGROUND
+	&& (ready[uint8_t(prio::INTERACTIVE)] || ready[uint8_t(prio::NORMAL)])
+	&& bool(enable);
+}
+
+[[gnu::hot]]
+bool
+ircd::ctx::sched::yieldable(const ctx &c)
+noexcept
+{
+	return prio_class(c) == prio::BACKGROUND
+	&& (ready[uint8_t(prio::INTERACTIVE)] || ready[uint8_t(prio::NORMAL)])
+	&& prof::cur_slice_cycles() > ulong(background_slice)
+	&& bool(enable)
+	&& !critical_asserted
+	&& !std::current_exception();
+}
+
+[[gnu::hot]]
+void
+ircd::ctx::sched::readied(ctx &c)
+noexcept
+{
+	if(c.ready >= 0 || &c == current)
+		return;
+
+	c.ready = int8_t(prio_class(c));
+	++ready[c.ready];
+}
+
+[[gnu::hot]]
+void
+ircd::ctx::sched::resumed(ctx &c)
+noexcept
+{
+	if(c.ready < 0)
+		return;
+
+	assert(ready[c.ready] > 0);
+	--ready[c.ready];
+	c.ready = -1;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 // ctx_prof.h
@@ -1602,6 +1750,7 @@ namespace ircd::ctx::prof
 	thread_local ulong _slice_start;     // Current/last time slice started
 	thread_local ulong _slice_stop;      // Last time slice ended
 	thread_local ticker _total;          // Totals kept for all contexts.
+	thread_local std::array<uint64_t, num_of<prio>()> _prio; // Cycles by class
 
 	static void check_stack();
 	static void check_slice();
@@ -1755,9 +1904,11 @@ noexcept
 
 	_total.event.at(pos) += last_slice;
 	c.profile.event.at(pos) += last_slice;
+	_prio.at(uint8_t(prio_class(c))) += last_slice;
 	assert(c.ios_desc.stats);
 	c.ios_desc.stats->slice_total += last_slice;
 	c.ios_desc.stats->slice_last = last_slice;
+	c.ios_desc.stats->slice_hist(last_slice);
 	c.stack.at = stack_at_here();
 	c.stack.peak = std::max(c.stack.at, c.stack.peak);
 }
@@ -1927,6 +2078,12 @@ ircd::ctx::prof::get(const event &e)
 	return get().event.at(uint8_t(e));
 }
 
+const uint64_t &
+ircd::ctx::prof::get(const prio &p)
+{
+	return _prio.at(uint8_t(p));
+}
+
 [[gnu::hot]]
 const ircd::ctx::prof::ticker &
 ircd::ctx::prof::get()
@@ -23,6 +23,18 @@ namespace ircd::ctx::prof
 	void mark(const event &);
 }
 
+namespace ircd::ctx::sched
+{
+	extern conf::item<bool> enable;
+	extern conf::item<ulong> background_slice;
+	extern std::array<uint32_t, num_of<prio>()> ready;
+
+	bool deferrable(const ctx &) noexcept;
+	bool yieldable(const ctx &) noexcept;
+	void readied(ctx &) noexcept;
+	void resumed(ctx &) noexcept;
+}
+
 /// Internal context implementation
 ///
 struct ircd::ctx::ctx
@@ -36,6 +48,7 @@ struct ircd::ctx::ctx
 	context::flags flags;                        // User given flags
 	int8_t nice {0};                             // Scheduling priority nice-value
 	int8_t ionice {0};                           // IO priority nice-value (defaults for fs::opts)
+	int8_t ready {-1};                           // prio class while woken and not yet resumed
 	int32_t notes {0};                           // norm: 0 = asleep; 1 = awake; inc by others; dec by self
 	boost::asio::deadline_timer alarm;           // acting semaphore (64B)
 	boost::asio::yield_context *yc {nullptr};    // boost interface
@@ -57,6 +70,7 @@ struct ircd::ctx::ctx
 	bool note() noexcept;                        // properly request wake()
 	bool wait();                                 // yield context to ios queue (returns on this resume)
 	void jump();                                 // jump to context directly (returns on your resume)
+	void defer();                                // requeue behind contexts already queued
 
 	void operator()(boost::asio::yield_context, const std::function<void ()>) noexcept;
 	void spawn(context::function func);
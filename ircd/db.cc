@@ -115,6 +115,7 @@ try
 	test_direct_io();
 	test_hw_crc32();
 	request.add(request_pool_size);
+	governor::init();
 }
 catch(const std::exception &e)
 {
@@ -130,6 +131,7 @@ catch(const std::exception &e)
 ircd::db::init::~init()
 noexcept
 {
+	governor::fini();
 	delete prefetcher;
 	prefetcher = nullptr;
 
@@ -405,6 +407,19 @@ ircd::db::open_repair
 	{ "persist",  false                  },
 };
 
+/// Directory for the private files of databases opened as a secondary (see
+/// secondary=true in the optstr). Each database gets a subdirectory by name.
+/// When empty the directory of each database is suffixed with ".secondary".
+/// Multiple secondaries of the same primary on one host must each set a
+/// distinct value here.
+decltype(ircd::db::secondary_path)
+ircd::db::secondary_path
+{
+	{ "name",     "ircd.db.secondary.path"  },
+	{ "default",  string_view{}             },
+	{ "persist",  false                     },
+};
+
 void
 ircd::db::sync(database &d)
 {
@@ -599,6 +614,47 @@ ircd::db::resume(database &d)
 	};
 }
 
+/// Replays the primary's new MANIFEST and WAL entries into a database opened
+/// as a secondary. Returns the sequence number visible after catching up.
+uint64_t
+ircd::db::catchup(database &d)
+{
+	assert(d.d);
+	if(unlikely(!d.secondary))
+		throw error
+		{
+			"[%s] database is not opened as a secondary.",
+			name(d)
+		};
+
+	const ctx::uninterruptible::nothrow ui;
+	const auto before
+	{
+		sequence(d)
+	};
+
+	throw_on_error
+	{
+		d.d->TryCatchUpWithPrimary()
+	};
+
+	const auto after
+	{
+		sequence(d)
+	};
+
+	if(after != before)
+		log::debug
+		{
+			log, "[%s] @%lu caught up with primary +%lu",
+			name(d),
+			after,
+			after - before,
+		};
+
+	return after;
+}
+
 void
 ircd::db::bgpause(database &d)
 {
@@ -1126,6 +1182,10 @@ try
 {
 	ircd::read_only
 }
+,secondary
+{
+	false
+}
 ,env
 {
 	std::make_shared<struct env>(this)
@@ -1165,6 +1225,15 @@ try
 {
 	std::make_shared<database::cache>(this, this->stats, this->name, 16_MiB)
 }
+,rate_limiter
+{
+	governor::enable?
+		std::shared_ptr<rocksdb::RateLimiter>
+		{
+			rocksdb::NewGenericRateLimiter(int64_t(governor::rate_max))
+		}:
+		nullptr
+}
 ,descriptors
 {
 	std::move(description)
@@ -1173,9 +1242,12 @@ try
 {
 	auto opts
 	{
-		std::make_unique<rocksdb::DBOptions>(make_dbopts(this->optstr, &this->optstr, &read_only, &fsck))
+		std::make_unique<rocksdb::DBOptions>(make_dbopts(this->optstr, &this->optstr, &read_only, &fsck, &secondary))
 	};
 
+	// A secondary never writes to the primary's directory.
+	read_only |= secondary;
+
 	// Setup sundry
 	opts->create_if_missing = true;
 	opts->create_missing_column_families = true;
@@ -1198,6 +1270,14 @@ try
 
 	opts->max_total_wal_size = 96_MiB; //TODO: conf
 	opts->db_write_buffer_size = 96_MiB; //TODO: conf
+
+	// Background writes are paced by the compaction governor when enabled.
+	opts->rate_limiter = rate_limiter;
+
+	// The secondary has to keep all table files open, otherwise a file it
+	// has not yet opened may be deleted by the primary's compactions.
+	if(secondary)
+		opts->max_open_files = -1;
 	//opts->max_log_file_size = 32_MiB; //TODO: conf
 
 	//TODO: range_sync
@@ -1397,7 +1477,24 @@ try
 		columns.size()
 	};
 
-	if(read_only)
+	const std::string secondary_path
+	{
+		!secondary?
+			std::string{}:
+		!empty(string_view(db::secondary_path))?
+			fs::path_string(fs::path_views{string_view(db::secondary_path), this->name}):
+			path + ".secondary"
+	};
+
+	if(secondary)
+		log::notice
+		{
+			log, "Database \"%s\" @ `%s' will be opened as a secondary @ `%s'.",
+			this->name,
+			path,
+			secondary_path,
+		};
+	else if(read_only)
 		log::warning
 		{
 			log, "Database \"%s\" @ `%s' will be opened in read-only mode.",
@@ -1407,7 +1504,12 @@ try
 
 	// Open DB into ptr
 	rocksdb::DB *ptr;
-	if(read_only)
+	if(secondary)
+		throw_on_error
+		{
+			rocksdb::DB::OpenAsSecondary(*opts, path, secondary_path, columns, &handles, &ptr)
+		};
+	else if(read_only)
 		throw_on_error
 		{
 			rocksdb::DB::OpenForReadOnly(*opts, path, columns, &handles, &ptr)
@@ -1498,7 +1600,7 @@ try
 	// here. The drop operation has no effects until the database is next
 	// closed; the dropped columns will still work during this instance.
 	for(const auto &colptr : columns)
-		if(describe(*colptr).drop)
+		if(describe(*colptr).drop && !secondary)
 			db::drop(*colptr);
 
 	// Database integrity check branch.
@@ -1925,6 +2027,10 @@ ircd::db::database::column::column(database &d,
 	// Set the compaction filter
 	this->options.compaction_filter = &this->cfilter;
 
+	// Set the merge operator
+	if(this->descriptor->merger)
+		this->options.merge_operator = std::make_shared<struct mergeop>(this->d, this->descriptor->merger);
+
 	//this->options.paranoid_file_checks = true;
 
 	// More stats reported by the rocksdb.stats property.
@@ -3549,218 +3655,1624 @@ ircd::db::database::sst::dump::dump(db::column column,
 	this->info.version = info.version;
 }
 
+//
+// sst::writer
+//
+
+ircd::db::database::sst::writer::writer(db::column column,
+                                        const string_view &path)
+:column{column}
+,path{path}
+{
+}
+
+void
+ircd::db::database::sst::writer::append(const op &op,
+                                        const string_view &key,
+                                        const string_view &val)
+{
+	buf.emplace_back(op, std::string{key}, std::string{val});
+}
+
+size_t
+ircd::db::database::sst::writer::size()
+const
+{
+	return buf.size();
+}
+
+ircd::db::database::sst::info
+ircd::db::database::sst::writer::finish()
+{
+	database::column &c(column);
+	const database &d(*c.d);
+	const auto compare{[&c]
+	(const entry &a, const entry &b)
+	{
+		return c.cmp.Compare(slice(std::get<1>(a)), slice(std::get<1>(b)));
+	}};
+
+	// The stable sort preserves the order of appends for the same key so
+	// they are resolved in that order below.
+	std::stable_sort(begin(buf), end(buf), [&compare]
+	(const entry &a, const entry &b)
+	{
+		return compare(a, b) < 0;
+	});
+
+	const db::merge_closure merger
+	{
+		c.descriptor->merger?
+			c.descriptor->merger:
+			db::merge_closure{db::merge_operator}
+	};
+
+	rocksdb::Options opts(d.d->GetOptions(c));
+	rocksdb::EnvOptions eopts(opts);
+	rocksdb::SstFileWriter writer
+	{
+		eopts, opts, c
+	};
+
+	throw_on_error
+	{
+		writer.Open(path)
+	};
+
+	// Only one entry can be written for each key; the appends for a key are
+	// resolved as the database would have applied them in order. A SET or
+	// DELETE replaces anything before it; a MERGE is folded into the value
+	// before it with the column's merge operator. Merges without any SET or
+	// DELETE before them are folded together and written as one MERGE to be
+	// applied to the existing value at ingestion.
+	size_t i(0);
+	for(auto it(begin(buf)); it != end(buf); )
+	{
+		const auto first(it);
+		const auto &key
+		{
+			std::get<1>(*first)
+		};
+
+		std::optional<op> base;
+		std::string value;
+		bool merged(false);
+		for(; it != end(buf) && compare(*it, *first) == 0; ++it)
+		{
+			const auto &[code, _key, val]
+			{
+				*it
+			};
+
+			switch(code)
+			{
+				case op::SET:
+					base = op::SET;
+					value = val;
+					merged = false;
+					continue;
+
+				case op::DELETE:
+					base = op::DELETE;
+					value.clear();
+					merged = false;
+					continue;
+
+				case op::MERGE:
+					value = merged || base == op::SET?
+						merger(key, {value, val}):
+						val;
+
+					merged = true;
+					continue;
+
+				default:
+					throw error
+					{
+						"Cannot write %s to SST for column '%s'",
+						reflect(code),
+						db::name(c),
+					};
+			}
+		}
+
+		if(merged && !base)
+			throw_on_error
+			{
+				writer.Merge(slice(key), slice(value))
+			};
+		else if(base == op::DELETE && !merged)
+			throw_on_error
+			{
+				writer.Delete(slice(key))
+			};
+		else
+			throw_on_error
+			{
+				writer.Put(slice(key), slice(value))
+			};
+
+		++i;
+	}
+
+	sst::info ret;
+	rocksdb::ExternalSstFileInfo info;
+	if(i)
+		throw_on_error
+		{
+			writer.Finish(&info)
+		};
+
+	ret.column = db::name(c);
+	ret.path = std::move(info.file_path);
+	ret.min_key = std::move(info.smallest_key);
+	ret.max_key = std::move(info.largest_key);
+	ret.min_seq = info.sequence_number;
+	ret.max_seq = info.sequence_number;
+	ret.size = info.file_size;
+	ret.entries = info.num_entries;
+	ret.version = info.version;
+	buf.clear();
+	return ret;
+}
+
 //
 // sst::info::vector
 //
 
-ircd::db::database::sst::info::vector::vector(const database &d)
+ircd::db::database::sst::info::vector::vector(const database &d)
+{
+	this->reserve(db::file_count(d));
+	for(const auto &c : d.columns)
+	{
+		db::column column{*c};
+		for(auto &&info : vector(column))
+			this->emplace_back(std::move(info));
+	}
+}
+
+ircd::db::database::sst::info::vector::vector(const db::column &column)
+{
+	database::column &c(const_cast<db::column &>(column));
+	database &d(*c.d);
+
+	rocksdb::ColumnFamilyMetaData cfmd;
+	d.d->GetColumnFamilyMetaData(c, &cfmd);
+
+	rocksdb::TablePropertiesCollection tpc;
+	throw_on_error
+	{
+		d.d->GetPropertiesOfAllTables(c, &tpc)
+	};
+
+	size_t i(0);
+	this->resize(std::max(cfmd.file_count, tpc.size()));
+	for(rocksdb::LevelMetaData &level : cfmd.levels)
+		for(rocksdb::SstFileMetaData md : level.files)
+		{
+			auto &info(this->at(i++));
+			info.operator=(std::move(md));
+			info.level = level.level;
+
+			const auto path(info.path + info.name);
+			auto tp(*tpc.at(path));
+			info.operator=(std::move(tp));
+			tpc.erase(path);
+		}
+
+	for(auto &&kv : tpc)
+	{
+		auto &info(this->at(i++));
+		auto tp(*kv.second);
+		info.operator=(std::move(tp));
+		info.path = kv.first;
+	}
+
+	assert(i == this->size());
+}
+
+//
+// sst::info::info
+//
+
+ircd::db::database::sst::info::info(const database &d_,
+                                    const string_view &filename)
+{
+	auto &d(const_cast<database &>(d_));
+	const ctx::uninterruptible::nothrow ui;
+
+	std::vector<rocksdb::LiveFileMetaData> v;
+	d.d->GetLiveFilesMetaData(&v);
+
+	for(auto &md : v)
+		if(md.name == filename)
+		{
+			rocksdb::TablePropertiesCollection tpc;
+			throw_on_error
+			{
+				d.d->GetPropertiesOfAllTables(d[md.column_family_name], &tpc)
+			};
+
+			auto tp(*tpc.at(md.db_path + md.name));
+			this->operator=(std::move(md));
+			this->operator=(std::move(tp));
+			return;
+		}
+
+	throw not_found
+	{
+		"No file named '%s' is live in database '%s'",
+		filename,
+		d.name
+	};
+}
+
+ircd::db::database::sst::info &
+ircd::db::database::sst::info::operator=(rocksdb::LiveFileMetaData &&md)
+{
+	name = std::move(md.name);
+	path = std::move(md.db_path);
+	column = std::move(md.column_family_name);
+	size = std::move(md.size);
+	min_seq = std::move(md.smallest_seqno);
+	max_seq = std::move(md.largest_seqno);
+	min_key = std::move(md.smallestkey);
+	max_key = std::move(md.largestkey);
+	num_reads = std::move(md.num_reads_sampled);
+	level = std::move(md.level);
+	compacting = std::move(md.being_compacted);
+	return *this;
+}
+
+ircd::db::database::sst::info &
+ircd::db::database::sst::info::operator=(rocksdb::SstFileMetaData &&md)
+{
+	name = std::move(md.name);
+	path = std::move(md.db_path);
+	size = std::move(md.size);
+	min_seq = std::move(md.smallest_seqno);
+	max_seq = std::move(md.largest_seqno);
+	min_key = std::move(md.smallestkey);
+	max_key = std::move(md.largestkey);
+	num_reads = std::move(md.num_reads_sampled);
+	compacting = std::move(md.being_compacted);
+	return *this;
+}
+
+ircd::db::database::sst::info &
+ircd::db::database::sst::info::operator=(rocksdb::TableProperties &&tp)
+{
+	column = std::move(tp.column_family_name);
+	filter = std::move(tp.filter_policy_name);
+	comparator = std::move(tp.comparator_name);
+	merge_operator = std::move(tp.merge_operator_name);
+	prefix_extractor = std::move(tp.prefix_extractor_name);
+	compression = std::move(tp.compression_name);
+	format = std::move(tp.format_version);
+	cfid = std::move(tp.column_family_id);
+	data_size = std::move(tp.data_size);
+	index_size = std::move(tp.index_size);
+	top_index_size = std::move(tp.top_level_index_size);
+	filter_size = std::move(tp.filter_size);
+	keys_size = std::move(tp.raw_key_size);
+	values_size = std::move(tp.raw_value_size);
+	index_parts = std::move(tp.index_partitions);
+	data_blocks = std::move(tp.num_data_blocks);
+	entries = std::move(tp.num_entries);
+	range_deletes = std::move(tp.num_range_deletions);
+	fixed_key_len = std::move(tp.fixed_key_len);
+	created = std::move(tp.creation_time);
+	oldest_key = std::move(tp.oldest_key_time);
+	return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// database::wal
+//
+
+//
+// wal::info::vector
+//
+
+ircd::db::database::wal::info::vector::vector(const database &d_)
+{
+	auto &d{const_cast<database &>(d_)};
+	std::vector<std::unique_ptr<rocksdb::LogFile>> vec;
+	throw_on_error
+	{
+		d.d->GetSortedWalFiles(vec)
+	};
+
+	this->resize(vec.size());
+	for(size_t i(0); i < vec.size(); ++i)
+		this->at(i).operator=(*vec.at(i));
+}
+
+//
+// wal::info::info
+//
+
+ircd::db::database::wal::info::info(const database &d_,
+                                    const string_view &filename)
+{
+	auto &d{const_cast<database &>(d_)};
+	std::vector<std::unique_ptr<rocksdb::LogFile>> vec;
+	throw_on_error
+	{
+		d.d->GetSortedWalFiles(vec)
+	};
+
+	for(const auto &ptr : vec)
+		if(ptr->PathName() == filename)
+		{
+			this->operator=(*ptr);
+			return;
+		}
+
+	throw not_found
+	{
+		"No file named '%s' is live in database '%s'",
+		filename,
+		d.name
+	};
+}
+
+ircd::db::database::wal::info &
+ircd::db::database::wal::info::operator=(const rocksdb::LogFile &lf)
+{
+	name = lf.PathName();
+	number = lf.LogNumber();
+	seq = lf.StartSequence();
+	size = lf.SizeFileBytes();
+	alive = lf.Type() == rocksdb::WalFileType::kAliveLogFile;
+
+	return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// db/backup.h
+//
+
+namespace ircd::db::backup
+{
+	static size_t copy(const string_view &src, const string_view &dst, const size_t &size, const size_t &rate, const ircd::timer &, size_t &copied);
+	static std::string share_name(const string_view &src, const string_view &name, const size_t &size, const size_t &rate, const ircd::timer &, size_t &done);
+	static std::string unshare_name(const string_view &shared);
+	static void pace(const size_t &done, const size_t &rate, const ircd::timer &);
+	static std::vector<std::pair<std::string, size_t>> files(const string_view &dir);
+	static void remove(const string_view &dir);
+	static size_t _purge(const string_view &dbname, const size_t &keep);
+
+	static ctx::mutex mutex;
+	static std::map<std::string, std::string, std::less<>> shared_names;
+}
+
+/// Root directory of all backups. When empty this is a "backup" directory
+/// under the database directory; backups should be kept on another device.
+decltype(ircd::db::backup::path)
+ircd::db::backup::path
+{
+	{ "name",     "ircd.db.backup.path"  },
+	{ "default",  string_view{}          },
+};
+
+/// Bytes per second when copying files into a backup. Zero is unlimited.
+decltype(ircd::db::backup::rate)
+ircd::db::backup::rate
+{
+	{ "name",     "ircd.db.backup.rate"  },
+	{ "default",  long(32_MiB)           },
+};
+
+/// Number of backups of each database retained after creating a new one;
+/// the oldest are purged along with table files no longer referenced. Zero
+/// disables purging.
+decltype(ircd::db::backup::keep)
+ircd::db::backup::keep
+{
+	{ "name",     "ircd.db.backup.keep"  },
+	{ "default",  7L                     },
+};
+
+decltype(ircd::db::backup::buffer_size)
+ircd::db::backup::buffer_size
+{
+	{ "name",     "ircd.db.backup.buffer_size"  },
+	{ "default",  long(1_MiB)                   },
+};
+
+decltype(ircd::db::backup::count)
+ircd::db::backup::count
+{
+	{ "name", "ircd.db.backup.count"                                  },
+	{ "desc", "Number of backups created"                            },
+};
+
+decltype(ircd::db::backup::files_copied)
+ircd::db::backup::files_copied
+{
+	{ "name", "ircd.db.backup.files.copied"                           },
+	{ "desc", "Number of files copied into backups"                   },
+};
+
+decltype(ircd::db::backup::files_shared)
+ircd::db::backup::files_shared
+{
+	{ "name", "ircd.db.backup.files.shared"                           },
+	{ "desc", "Number of table files already present from a backup"   },
+};
+
+decltype(ircd::db::backup::bytes_copied)
+ircd::db::backup::bytes_copied
+{
+	{ "name", "ircd.db.backup.bytes.copied"                           },
+	{ "desc", "Number of bytes copied into backups"                   },
+};
+
+decltype(ircd::db::backup::bytes_total)
+ircd::db::backup::bytes_total
+{
+	{ "name", "ircd.db.backup.bytes.total"                            },
+	{ "desc", "Number of bytes referenced by the backups created"     },
+};
+
+/// Copies the live files of the database into a new backup. Table files
+/// already in the backup set are not copied again; they are identified by
+/// their number, checksum and size (see share_name()). The memtables are
+/// flushed first so the write-ahead logs are not required; the id of the
+/// backup is the sequence number after that flush. File deletions are
+/// disabled until the copy completes; writes and compactions otherwise
+/// proceed.
+uint64_t
+ircd::db::backup::create(database &d)
+{
+	const std::lock_guard lock
+	{
+		backup::mutex
+	};
+
+	fdeletions(d, false);
+	const unwind enable_deletions{[&d]
+	{
+		const ctx::uninterruptible::nothrow ui;
+		fdeletions(d, true);
+	}};
+
+	uint64_t manifest_size;
+	std::vector<std::string> live;
+	throw_on_error
+	{
+		d.d->GetLiveFiles(live, &manifest_size, !d.read_only)
+	};
+
+	// The id is taken after the memtables were flushed by GetLiveFiles() so
+	// it covers what those files contain.
+	const auto id
+	{
+		sequence(d)
+	};
+
+	const std::string target
+	{
+		dir(name(d), id)
+	};
+
+	if(fs::exists(target))
+		throw error
+		{
+			"[%s] backup %lu already exists.",
+			name(d),
+			id,
+		};
+
+	// CURRENT is written from the manifest listed with the live files, as
+	// a checkpoint does; the one on disk may have moved on to a newer
+	// manifest by the time the copies are done.
+	const auto manifest
+	{
+		std::find_if(begin(live), end(live), [](const auto &file)
+		{
+			return startswith(lstrip(file, '/'), "MANIFEST-");
+		})
+	};
+
+	if(unlikely(manifest == end(live)))
+		throw error
+		{
+			"[%s] no manifest among the %zu live files.",
+			name(d),
+			live.size(),
+		};
+
+	const std::string shared
+	{
+		fs::path_string(fs::path_views{dir(name(d)), "shared"})
+	};
+
+	const std::string tmp
+	{
+		target + ".tmp"
+	};
+
+	if(fs::exists(tmp))
+		remove(tmp);
+
+	fs::mkdir(shared);
+	fs::mkdir(tmp);
+	const unwind_exceptional cleanup{[&tmp]
+	{
+		const ctx::uninterruptible::nothrow ui;
+		remove(tmp);
+	}};
+
+	log::info
+	{
+		log, "[%s] Backup %lu of %zu files to `%s'...",
+		name(d),
+		id,
+		live.size(),
+		target,
+	};
+
+	const ircd::timer timer;
+	size_t done(0), copied(0), copied_files(0), shared_files(0), total(0);
+	std::stringstream list;
+	for(const auto &file : live)
+	{
+		const string_view name
+		{
+			lstrip(file, '/')
+		};
+
+		const std::string src
+		{
+			fs::path_string(fs::path_views{d.path, name})
+		};
+
+		// Table files are immutable; they are copied into the shared
+		// directory once for all backups. A shared file is never replaced.
+		if(endswith(name, ".sst") || endswith(name, ".blob"))
+		{
+			const size_t size
+			{
+				fs::size(src)
+			};
+
+			const std::string shared_name
+			{
+				share_name(src, name, size, size_t(rate), timer, done)
+			};
+
+			const std::string dst
+			{
+				fs::path_string(fs::path_views{shared, shared_name})
+			};
+
+			if(!fs::exists(dst))
+			{
+				const std::string part{dst + ".tmp"};
+				copy(src, part, size, size_t(rate), timer, done);
+				fs::rename(part, dst);
+				copied += size;
+				++copied_files;
+			}
+			else if(unlikely(fs::size(dst) != size))
+				throw error
+				{
+					"[%s] shared table file '%s' is %zu bytes rather than %zu.",
+					db::name(d),
+					shared_name,
+					fs::size(dst),
+					size,
+				};
+			else ++shared_files;
+
+			list << shared_name << ' ' << size << '\n';
+			total += size;
+			continue;
+		}
+
+		if(name == "CURRENT")
+			continue;
+
+		// The manifest is over-allocated; only the used size is copied.
+		const size_t size
+		{
+			startswith(name, "MANIFEST-")?
+				size_t(manifest_size):
+				fs::size(src)
+		};
+
+		const std::string dst
+		{
+			fs::path_string(fs::path_views{tmp, name})
+		};
+
+		copy(src, dst, size, size_t(rate), timer, done);
+		copied += size;
+		++copied_files;
+		total += size;
+	}
+
+	const std::string current
+	{
+		std::string(lstrip(*manifest, '/')) + '\n'
+	};
+
+	fs::write(fs::path_string(fs::path_views{tmp, "CURRENT"}), const_buffer{current});
+
+	const std::string &files
+	{
+		list.str()
+	};
+
+	fs::write(fs::path_string(fs::path_views{tmp, "FILES"}), const_buffer{files});
+	fs::rename(tmp, target);
+
+	++count;
+	files_copied += copied_files;
+	files_shared += shared_files;
+	bytes_total += total;
+
+	char pbuf[3][48];
+	log::info
+	{
+		log, "[%s] Backup %lu complete; copied %zu files (%s) shared %zu (%s total) in %s",
+		name(d),
+		id,
+		copied_files,
+		ircd::pretty(pbuf[0], iec(copied)),
+		shared_files,
+		ircd::pretty(pbuf[1], iec(total)),
+		ircd::pretty(pbuf[2], timer.at<microseconds>(), true),
+	};
+
+	if(size_t(keep))
+		_purge(name(d), keep);
+
+	return id;
+}
+
+/// Reconstitutes a backup as a checkpoint of the database which can then be
+/// opened as "dbname:id" (or moved into place of the live database while it
+/// is closed). Table files are hard-linked from the backup when possible.
+std::string
+ircd::db::backup::restore(const string_view &dbname,
+                          const uint64_t &id)
+{
+	const std::lock_guard lock
+	{
+		backup::mutex
+	};
+
+	const std::string source
+	{
+		dir(dbname, id)
+	};
+
+	if(!fs::is_dir(source))
+		throw not_found
+		{
+			"[%s] backup %lu does not exist.",
+			dbname,
+			id,
+		};
+
+	// The restored database reuses the numbers of files created after the
+	// backup; the live files can no longer be identified by their names.
+	shared_names.clear();
+
+	const std::string target
+	{
+		db::path(dbname, id)
+	};
+
+	if(fs::exists(target))
+		throw error
+		{
+			"[%s] restore target `%s' already exists.",
+			dbname,
+			target,
+		};
+
+	const std::string tmp
+	{
+		target + ".tmp"
+	};
+
+	if(fs::exists(tmp))
+		remove(tmp);
+
+	fs::mkdir(tmp);
+	const unwind_exceptional cleanup{[&tmp]
+	{
+		const ctx::uninterruptible::nothrow ui;
+		remove(tmp);
+	}};
+
+	const ircd::timer timer;
+	size_t copied(0), linked(0);
+	for(const auto &src : fs::ls(source))
+	{
+		const string_view name
+		{
+			lstrip(lstrip(src, source), '/')
+		};
+
+		if(name == "FILES")
+			continue;
+
+		const std::string dst
+		{
+			fs::path_string(fs::path_views{tmp, name})
+		};
+
+		copy(src, dst, fs::size(src), 0UL, timer, copied);
+	}
+
+	const std::string shared
+	{
+		fs::path_string(fs::path_views{dir(dbname), "shared"})
+	};
+
+	for(const auto &[name, size] : files(source))
+	{
+		const std::string src
+		{
+			fs::path_string(fs::path_views{shared, name})
+		};
+
+		const std::string dst
+		{
+			fs::path_string(fs::path_views{tmp, unshare_name(name)})
+		};
+
+		// Falls back to a copy when the backup is on another device.
+		try
+		{
+			syscall(::link, src.c_str(), dst.c_str());
+			++linked;
+		}
+		catch(const std::system_error &)
+		{
+			copy(src, dst, size, 0UL, timer, copied);
+		}
+	}
+
+	fs::rename(tmp, target);
+
+	char pbuf[2][48];
+	log::info
+	{
+		log, "[%s] Restored backup %lu to `%s'; linked %zu files; copied %s in %s",
+		dbname,
+		id,
+		target,
+		linked,
+		ircd::pretty(pbuf[0], iec(copied)),
+		ircd::pretty(pbuf[1], timer.at<microseconds>(), true),
+	};
+
+	return target;
+}
+
+/// Removes all but the most recent `keep` backups of the database, then any
+/// shared table files no longer referenced. Returns the number of backups
+/// removed.
+size_t
+ircd::db::backup::purge(const string_view &dbname,
+                        const size_t &keep)
+{
+	const std::lock_guard lock
+	{
+		backup::mutex
+	};
+
+	return _purge(dbname, keep);
+}
+
+size_t
+ircd::db::backup::_purge(const string_view &dbname,
+                         const size_t &keep)
+{
+	std::vector<uint64_t> ids;
+	for_each(dbname, [&ids]
+	(const uint64_t &id)
+	{
+		ids.emplace_back(id);
+		return true;
+	});
+
+	const size_t removing
+	{
+		ids.size() > keep?
+			ids.size() - keep:
+			0UL
+	};
+
+	for(size_t i(0); i < removing; ++i)
+	{
+		remove(dir(dbname, ids.at(i)));
+		log::info
+		{
+			log, "[%s] Purged backup %lu",
+			dbname,
+			ids.at(i),
+		};
+	}
+
+	std::set<std::string, std::less<>> referenced;
+	for(size_t i(removing); i < ids.size(); ++i)
+		for(auto &[name, size] : files(dir(dbname, ids.at(i))))
+			referenced.emplace(std::move(name));
+
+	const std::string shared
+	{
+		fs::path_string(fs::path_views{dir(dbname), "shared"})
+	};
+
+	if(!fs::is_dir(shared))
+		return removing;
+
+	size_t unreferenced(0);
+	for(const auto &file : fs::ls(shared))
+	{
+		const string_view name
+		{
+			lstrip(lstrip(file, shared), '/')
+		};
+
+		if(referenced.count(name))
+			continue;
+
+		fs::remove(file);
+		++unreferenced;
+	}
+
+	if(unreferenced)
+		log::debug
+		{
+			log, "[%s] Removed %zu unreferenced table files from backups.",
+			dbname,
+			unreferenced,
+		};
+
+	return removing;
+}
+
+/// Checks that every file referenced by the backup is present at the listed
+/// size and that the checksums of each table file are correct. Throws on the
+/// first failure; returns the number of bytes verified.
+size_t
+ircd::db::backup::verify(database &d,
+                         const uint64_t &id)
+{
+	const std::string source
+	{
+		dir(name(d), id)
+	};
+
+	if(!fs::is_dir(source))
+		throw not_found
+		{
+			"[%s] backup %lu does not exist.",
+			name(d),
+			id,
+		};
+
+	const std::string current
+	{
+		fs::read(fs::path_string(fs::path_views{source, "CURRENT"}))
+	};
+
+	const string_view manifest
+	{
+		rstrip(current, '\n')
+	};
+
+	if(!startswith(manifest, "MANIFEST-") || !fs::exists(fs::path_string(fs::path_views{source, manifest})))
+		throw error
+		{
+			"[%s] backup %lu is missing its manifest '%s'.",
+			name(d),
+			id,
+			manifest,
+		};
+
+	const std::string shared
+	{
+		fs::path_string(fs::path_views{dir(name(d)), "shared"})
+	};
+
+	size_t ret(0);
+	for(const auto &[name, size] : files(source))
+	{
+		const std::string path
+		{
+			fs::path_string(fs::path_views{shared, name})
+		};
+
+		if(!fs::exists(path) || fs::size(path) != size)
+			throw error
+			{
+				"[%s] backup %lu table file '%s' is missing or not %zu bytes.",
+				db::name(d),
+				id,
+				name,
+				size,
+			};
+
+		if(endswith(name, ".sst"))
+			check(d, path);
+
+		ret += size;
+	}
+
+	return ret;
+}
+
+/// Iterates the ids of the backups of the database from oldest to newest.
+bool
+ircd::db::backup::for_each(const string_view &dbname,
+                           const closure &closure)
+{
+	const std::string base
+	{
+		dir(dbname)
+	};
+
+	if(!fs::is_dir(base))
+		return true;
+
+	std::vector<uint64_t> ids;
+	for(const auto &entry : fs::ls(base)) try
+	{
+		const string_view name
+		{
+			lstrip(lstrip(entry, base), '/')
+		};
+
+		ids.emplace_back(lex_cast<uint64_t>(name));
+	}
+	catch(const bad_lex_cast &)
+	{
+		continue;
+	}
+
+	std::sort(begin(ids), end(ids));
+	for(const auto &id : ids)
+		if(!closure(id))
+			return false;
+
+	return true;
+}
+
+std::string
+ircd::db::backup::dir(const string_view &dbname,
+                      const uint64_t &id)
+{
+	return fs::path_string(fs::path_views
+	{
+		dir(dbname), lex_cast(id)
+	});
+}
+
+std::string
+ircd::db::backup::dir(const string_view &dbname)
+{
+	const string_view &root
+	{
+		backup::path
+	};
+
+	return root?
+		fs::path_string(fs::path_views{root, dbname}):
+		fs::path_string(fs::path_views{fs::base::db, "backup", dbname});
+}
+
+/// Reads the list of table files referenced by the backup in `dir`.
+std::vector<std::pair<std::string, size_t>>
+ircd::db::backup::files(const string_view &dir)
+{
+	const std::string list
+	{
+		fs::read(fs::path_string(fs::path_views{dir, "FILES"}))
+	};
+
+	std::vector<std::pair<std::string, size_t>> ret;
+	tokens(list, '\n', [&ret]
+	(const string_view &line)
+	{
+		const auto &[name, size]
+		{
+			split(line, ' ')
+		};
+
+		ret.emplace_back(name, lex_cast<size_t>(size));
+	});
+
+	return ret;
+}
+
+void
+ircd::db::backup::remove(const string_view &dir)
+{
+	for(const auto &file : fs::ls(dir))
+		fs::remove(file);
+
+	fs::remove(dir);
+}
+
+/// Copies `size` bytes from the start of `src` to the new file `dst`. The
+/// rate is applied to the `copied` total since `timer` started; zero yields
+/// between buffers without any delay. The source is evicted from the page
+/// cache afterward so a backup does not displace the working set.
+size_t
+ircd::db::backup::copy(const string_view &src,
+                       const string_view &dst,
+                       const size_t &size,
+                       const size_t &rate,
+                       const ircd::timer &timer,
+                       size_t &copied)
+{
+	const fs::fd in
+	{
+		src, std::ios::in
+	};
+
+	const fs::fd out
+	{
+		dst, std::ios::out
+	};
+
+	const unique_mutable_buffer buf
+	{
+		std::max(size_t(buffer_size), size_t(4_KiB)), info::page_size
+	};
+
+	size_t off(0);
+	while(off < size)
+	{
+		const mutable_buffer chunk
+		{
+			data(buf), std::min(size - off, ircd::size(buf))
+		};
+
+		const const_buffer read
+		{
+			fs::read(in, chunk, fs::read_opts(off))
+		};
+
+		if(unlikely(empty(read)))
+			break;
+
+		fs::write(out, read, fs::write_opts(off));
+		off += ircd::size(read);
+		copied += ircd::size(read);
+		bytes_copied += ircd::size(read);
+		pace(copied, rate, timer);
+	}
+
+	if(unlikely(off != size))
+		throw error
+		{
+			"Copied %zu of %zu bytes from `%s' to `%s'.",
+			off,
+			size,
+			src,
+			dst,
+		};
+
+	fs::sync(out);
+	fs::evict(in, size, fs::read_opts(0));
+	return off;
+}
+
+/// Name of a table file in the shared directory. A database restored from a
+/// backup reuses the numbers of files which later backups already hold, so
+/// the number is followed by a checksum of the content and the size, i.e.
+/// 000123_<checksum>_<size>.sst. The checksum requires reading the file; the
+/// names of the live files are remembered so each is only read once.
+std::string
+ircd::db::backup::share_name(const string_view &src,
+                             const string_view &name,
+                             const size_t &size,
+                             const size_t &rate,
+                             const ircd::timer &timer,
+                             size_t &done)
+{
+	const std::string key
+	{
+		fmt::snstringf
+		{
+			src.size() + 24, "%s:%zu", src, size
+		}
+	};
+
+	const auto it
+	{
+		shared_names.lower_bound(key)
+	};
+
+	if(it != end(shared_names) && it->first == key)
+		return it->second;
+
+	const fs::fd in
+	{
+		src, std::ios::in
+	};
+
+	const unique_mutable_buffer buf
+	{
+		std::max(size_t(buffer_size), size_t(4_KiB)), info::page_size
+	};
+
+	sha256 hash;
+	size_t off(0);
+	while(off < size)
+	{
+		const mutable_buffer chunk
+		{
+			data(buf), std::min(size - off, ircd::size(buf))
+		};
+
+		const const_buffer read
+		{
+			fs::read(in, chunk, fs::read_opts(off))
+		};
+
+		if(unlikely(empty(read)))
+			break;
+
+		hash.update(read);
+		off += ircd::size(read);
+		done += ircd::size(read);
+		pace(done, rate, timer);
+	}
+
+	if(unlikely(off != size))
+		throw error
+		{
+			"Read %zu of %zu bytes from `%s'.",
+			off,
+			size,
+			src,
+		};
+
+	fs::evict(in, size, fs::read_opts(0));
+
+	char digest[sha256::digest_size];
+	hash.finalize(digest);
+
+	char hex[16];
+	const auto &[stem, ext]
+	{
+		rsplit(name, '.')
+	};
+
+	std::string ret
+	{
+		fmt::snstringf
+		{
+			name.size() + 48, "%s_%s_%zu.%s",
+			stem,
+			u2a(hex, const_buffer{digest, 8}),
+			size,
+			ext,
+		}
+	};
+
+	shared_names.emplace_hint(it, key, ret);
+	return ret;
+}
+
+/// Name of a table file in the database from its name in the shared
+/// directory. Backups taken before names were suffixed list the plain name.
+std::string
+ircd::db::backup::unshare_name(const string_view &shared)
+{
+	const auto &[stem, ext]
+	{
+		rsplit(shared, '.')
+	};
+
+	return fmt::snstringf
+	{
+		shared.size() + 1, "%s.%s",
+		split(stem, '_').first,
+		ext,
+	};
+}
+
+/// Sleeps as required to hold `done` bytes since `timer` started to `rate`
+/// bytes per second; zero yields without any delay.
+void
+ircd::db::backup::pace(const size_t &done,
+                       const size_t &rate,
+                       const ircd::timer &timer)
+{
+	const milliseconds due
+	{
+		rate? done * 1000 / rate: 0
+	};
+
+	const auto elapsed
+	{
+		timer.at<milliseconds>()
+	};
+
+	if(due > elapsed)
+		ctx::sleep(due - elapsed);
+	else
+		ctx::yield();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// db/governor.h
+//
+
+namespace ircd::db::governor
+{
+	static double sample();
+	static void adjust(const double &load);
+	static void worker();
+	static void deferred_worker();
+
+	static std::deque<std::pair<std::string, std::string>> queue;
+	static size_t last_fetched;
+	static microseconds last_accum;
+	static double smoothed;
+	static ctx::context context;
+	static ctx::context deferred_context;
+}
+
+/// Enables the governor; the rate limiter is only attached to databases
+/// opened while this is true.
+decltype(ircd::db::governor::enable)
+ircd::db::governor::enable
+{
+	{ "name",     "ircd.db.governor.enable" },
+	{ "default",  true                      },
+};
+
+decltype(ircd::db::governor::interval)
+ircd::db::governor::interval
+{
+	{ "name",     "ircd.db.governor.interval" },
+	{ "default",  2000L                       },
+};
+
+/// Average latency of a foreground database operation considered full load.
+decltype(ircd::db::governor::latency_high)
+ircd::db::governor::latency_high
+{
+	{ "name",     "ircd.db.governor.latency.high" },
+	{ "default",  20000L                          },
+};
+
+/// Percentage of time some tasks stalled on IO (10s average) considered
+/// full load.
+decltype(ircd::db::governor::psi_high)
+ircd::db::governor::psi_high
+{
+	{ "name",     "ircd.db.governor.psi.high" },
+	{ "default",  25.0                        },
+};
+
+/// Background write rate (bytes per second) under full load.
+decltype(ircd::db::governor::rate_min)
+ircd::db::governor::rate_min
+{
+	{ "name",     "ircd.db.governor.rate.min" },
+	{ "default",  long(8_MiB)                 },
+};
+
+/// Background write rate (bytes per second) without any load.
+decltype(ircd::db::governor::rate_max)
+ircd::db::governor::rate_max
+{
+	{ "name",     "ircd.db.governor.rate.max" },
+	{ "default",  long(128_MiB)               },
+};
+
+/// Concurrent compactions (max_background_compactions) under full load.
+decltype(ircd::db::governor::compactions_min)
+ircd::db::governor::compactions_min
+{
+	{ "name",     "ircd.db.governor.compactions.min" },
+	{ "default",  1L                                 },
+};
+
+/// Concurrent compactions without any load. See the TODO in the database
+/// options regarding values greater than one.
+decltype(ircd::db::governor::compactions_max)
+ircd::db::governor::compactions_max
+{
+	{ "name",     "ircd.db.governor.compactions.max" },
+	{ "default",  1L                                 },
+};
+
+/// First hour (local time) of the period when deferred compactions run.
+decltype(ircd::db::governor::quiet_begin)
+ircd::db::governor::quiet_begin
+{
+	{ "name",     "ircd.db.governor.quiet.begin" },
+	{ "default",  2L                             },
+};
+
+/// Hour (local time) ending the quiet period. When equal to the beginning
+/// every hour is quiet.
+decltype(ircd::db::governor::quiet_end)
+ircd::db::governor::quiet_end
+{
+	{ "name",     "ircd.db.governor.quiet.end" },
+	{ "default",  6L                           },
+};
+
+decltype(ircd::db::governor::load_pct)
+ircd::db::governor::load_pct
+{
+	{ "name", "ircd.db.governor.load"                                 },
+	{ "desc", "Smoothed foreground load as a percentage"              },
+};
+
+decltype(ircd::db::governor::rate)
+ircd::db::governor::rate
+{
+	{ "name", "ircd.db.governor.rate"                                 },
+	{ "desc", "Current background write rate in bytes per second"     },
+};
+
+decltype(ircd::db::governor::compactions)
+ircd::db::governor::compactions
+{
+	{ "name", "ircd.db.governor.compactions"                          },
+	{ "desc", "Current number of concurrent compactions"              },
+};
+
+decltype(ircd::db::governor::deferred)
+ircd::db::governor::deferred
+{
+	{ "name", "ircd.db.governor.deferred"                             },
+	{ "desc", "Number of deferred compactions conducted"              },
+};
+
+void
+ircd::db::governor::init()
 {
-	this->reserve(db::file_count(d));
-	for(const auto &c : d.columns)
+	if(!enable)
+		return;
+
+	context = ctx::context
 	{
-		db::column column{*c};
-		for(auto &&info : vector(column))
-			this->emplace_back(std::move(info));
-	}
+		"db.governor", 256_KiB, worker, ctx::context::POST
+	};
+
+	deferred_context = ctx::context
+	{
+		"db.deferred", 1_MiB, deferred_worker, ctx::context::POST
+	};
 }
 
-ircd::db::database::sst::info::vector::vector(const db::column &column)
+void
+ircd::db::governor::fini()
+noexcept
 {
-	database::column &c(const_cast<db::column &>(column));
-	database &d(*c.d);
-
-	rocksdb::ColumnFamilyMetaData cfmd;
-	d.d->GetColumnFamilyMetaData(c, &cfmd);
+	// Terminates and joins the workers.
+	deferred_context = ctx::context{};
+	context = ctx::context{};
+}
 
-	rocksdb::TablePropertiesCollection tpc;
-	throw_on_error
+/// Queues a full compaction of the database (or just one column) to be
+/// conducted during the quiet hours while the load is low.
+void
+ircd::db::governor::defer(const string_view &dbname,
+                          const string_view &colname)
+{
+	queue.emplace_back(dbname, colname);
+	log::info
 	{
-		d.d->GetPropertiesOfAllTables(c, &tpc)
+		log, "[%s] Compaction of '%s' deferred to quiet hours (%zu queued).",
+		dbname,
+		colname?: "*"_sv,
+		queue.size(),
 	};
+}
 
-	size_t i(0);
-	this->resize(std::max(cfmd.file_count, tpc.size()));
-	for(rocksdb::LevelMetaData &level : cfmd.levels)
-		for(rocksdb::SstFileMetaData md : level.files)
-		{
-			auto &info(this->at(i++));
-			info.operator=(std::move(md));
-			info.level = level.level;
+bool
+ircd::db::governor::quiet()
+{
+	const size_t begin(quiet_begin), end(quiet_end);
+	if(begin == end)
+		return true;
 
-			const auto path(info.path + info.name);
-			auto tp(*tpc.at(path));
-			info.operator=(std::move(tp));
-			tpc.erase(path);
-		}
+	struct tm tm;
+	const time_t now(ircd::time());
+	localtime_r(&now, &tm);
+	const size_t hour(tm.tm_hour);
+	return begin < end?
+		hour >= begin && hour < end:
+		hour >= begin || hour < end;
+}
 
-	for(auto &&kv : tpc)
+void
+ircd::db::governor::worker()
+{
+	while(1) try
 	{
-		auto &info(this->at(i++));
-		auto tp(*kv.second);
-		info.operator=(std::move(tp));
-		info.path = kv.first;
+		ctx::sleep(milliseconds(interval));
+		adjust(sample());
+	}
+	catch(const ctx::interrupted &)
+	{
+		throw;
+	}
+	catch(const std::exception &e)
+	{
+		log::error
+		{
+			log, "Compaction governor :%s",
+			e.what()
+		};
 	}
-
-	assert(i == this->size());
 }
 
-//
-// sst::info::info
-//
-
-ircd::db::database::sst::info::info(const database &d_,
-                                    const string_view &filename)
+void
+ircd::db::governor::deferred_worker()
 {
-	auto &d(const_cast<database &>(d_));
-	const ctx::uninterruptible::nothrow ui;
+	while(1) try
+	{
+		ctx::sleep(milliseconds(interval));
+		if(queue.empty() || !quiet() || smoothed >= 0.5)
+			continue;
 
-	std::vector<rocksdb::LiveFileMetaData> v;
-	d.d->GetLiveFilesMetaData(&v);
+		const auto [dbname, colname]
+		{
+			std::move(queue.front())
+		};
 
-	for(auto &md : v)
-		if(md.name == filename)
+		queue.pop_front();
+		auto *const d
 		{
-			rocksdb::TablePropertiesCollection tpc;
-			throw_on_error
-			{
-				d.d->GetPropertiesOfAllTables(d[md.column_family_name], &tpc)
-			};
+			database::get(std::nothrow, dbname)
+		};
 
-			auto tp(*tpc.at(md.db_path + md.name));
-			this->operator=(std::move(md));
-			this->operator=(std::move(tp));
-			return;
+		if(!d)
+			continue;
+
+		log::notice
+		{
+			log, "[%s] Conducting deferred compaction of '%s'...",
+			dbname,
+			!colname.empty()? string_view{colname}: "*"_sv,
+		};
+
+		if(!colname.empty())
+		{
+			db::column column{(*d)[colname]};
+			compact(column, std::pair<string_view, string_view>{}, -1);
 		}
+		else compact(*d);
 
-	throw not_found
+		++deferred;
+	}
+	catch(const ctx::interrupted &)
 	{
-		"No file named '%s' is live in database '%s'",
-		filename,
-		d.name
-	};
+		throw;
+	}
+	catch(const std::exception &e)
+	{
+		log::error
+		{
+			log, "Deferred compaction :%s",
+			e.what()
+		};
+	}
 }
 
-ircd::db::database::sst::info &
-ircd::db::database::sst::info::operator=(rocksdb::LiveFileMetaData &&md)
+/// Load in the range [0, 1] since the last sample. The average latency of
+/// the prefetcher's database operations is taken relative to latency_high
+/// and the IO pressure relative to psi_high; the greater of the two is used.
+double
+ircd::db::governor::sample()
 {
-	name = std::move(md.name);
-	path = std::move(md.db_path);
-	column = std::move(md.column_family_name);
-	size = std::move(md.size);
-	min_seq = std::move(md.smallest_seqno);
-	max_seq = std::move(md.largest_seqno);
-	min_key = std::move(md.smallestkey);
-	max_key = std::move(md.largestkey);
-	num_reads = std::move(md.num_reads_sampled);
-	level = std::move(md.level);
-	compacting = std::move(md.being_compacted);
-	return *this;
-}
+	double ret(0.0);
+	if(prefetcher && prefetcher->ticker)
+	{
+		const auto &ticker
+		{
+			*prefetcher->ticker
+		};
 
-ircd::db::database::sst::info &
-ircd::db::database::sst::info::operator=(rocksdb::SstFileMetaData &&md)
-{
-	name = std::move(md.name);
-	path = std::move(md.db_path);
-	size = std::move(md.size);
-	min_seq = std::move(md.smallest_seqno);
-	max_seq = std::move(md.largest_seqno);
-	min_key = std::move(md.smallestkey);
-	max_key = std::move(md.largestkey);
-	num_reads = std::move(md.num_reads_sampled);
-	compacting = std::move(md.being_compacted);
-	return *this;
-}
+		const size_t fetched
+		{
+			ticker.fetched - last_fetched
+		};
 
-ircd::db::database::sst::info &
-ircd::db::database::sst::info::operator=(rocksdb::TableProperties &&tp)
-{
-	column = std::move(tp.column_family_name);
-	filter = std::move(tp.filter_policy_name);
-	comparator = std::move(tp.comparator_name);
-	merge_operator = std::move(tp.merge_operator_name);
-	prefix_extractor = std::move(tp.prefix_extractor_name);
-	compression = std::move(tp.compression_name);
-	format = std::move(tp.format_version);
-	cfid = std::move(tp.column_family_id);
-	data_size = std::move(tp.data_size);
-	index_size = std::move(tp.index_size);
-	top_index_size = std::move(tp.top_level_index_size);
-	filter_size = std::move(tp.filter_size);
-	keys_size = std::move(tp.raw_key_size);
-	values_size = std::move(tp.raw_value_size);
-	index_parts = std::move(tp.index_partitions);
-	data_blocks = std::move(tp.num_data_blocks);
-	entries = std::move(tp.num_entries);
-	range_deletes = std::move(tp.num_range_deletions);
-	fixed_key_len = std::move(tp.fixed_key_len);
-	created = std::move(tp.creation_time);
-	oldest_key = std::move(tp.oldest_key_time);
-	return *this;
-}
+		const microseconds accum
+		{
+			ticker.accum_req_fin - last_accum
+		};
 
-///////////////////////////////////////////////////////////////////////////////
-//
-// database::wal
-//
+		const microseconds high
+		{
+			latency_high
+		};
 
-//
-// wal::info::vector
-//
+		last_fetched = ticker.fetched;
+		last_accum = ticker.accum_req_fin;
+		if(fetched && high.count())
+			ret = std::max(ret, accum.count() / double(fetched) / high.count());
+	}
 
-ircd::db::database::wal::info::vector::vector(const database &d_)
-{
-	auto &d{const_cast<database &>(d_)};
-	std::vector<std::unique_ptr<rocksdb::LogFile>> vec;
-	throw_on_error
-	{
-		d.d->GetSortedWalFiles(vec)
-	};
+	if(prof::psi::supported && double(psi_high) > 0.0)
+		if(prof::psi::refresh(prof::psi::io))
+			ret = std::max(ret, prof::psi::io.some.avg.at(0).pct / double(psi_high));
 
-	this->resize(vec.size());
-	for(size_t i(0); i < vec.size(); ++i)
-		this->at(i).operator=(*vec.at(i));
+	return std::min(ret, 1.0);
 }
 
-//
-// wal::info::info
-//
-
-ircd::db::database::wal::info::info(const database &d_,
-                                    const string_view &filename)
+void
+ircd::db::governor::adjust(const double &load)
 {
-	auto &d{const_cast<database &>(d_)};
-	std::vector<std::unique_ptr<rocksdb::LogFile>> vec;
-	throw_on_error
+	smoothed = (smoothed + load) / 2.0;
+
+	const size_t rate_lo(rate_min);
+	const size_t rate_hi(std::max(size_t(rate_max), rate_lo));
+	const size_t target_rate
 	{
-		d.d->GetSortedWalFiles(vec)
+		rate_hi - size_t((rate_hi - rate_lo) * smoothed)
 	};
 
-	for(const auto &ptr : vec)
-		if(ptr->PathName() == filename)
-		{
-			this->operator=(*ptr);
-			return;
-		}
+	const size_t comp_lo(std::max(size_t(compactions_min), 1UL));
+	const size_t comp_hi(std::max(size_t(compactions_max), comp_lo));
+	const size_t target_compactions
+	{
+		comp_hi - size_t(std::lround((comp_hi - comp_lo) * smoothed))
+	};
 
-	throw not_found
+	// Setting a DB option rewrites its OPTIONS file; only on a change.
+	const bool change_compactions
 	{
-		"No file named '%s' is live in database '%s'",
-		filename,
-		d.name
+		target_compactions != uint64_t(compactions.val)
 	};
-}
 
-ircd::db::database::wal::info &
-ircd::db::database::wal::info::operator=(const rocksdb::LogFile &lf)
-{
-	name = lf.PathName();
-	number = lf.LogNumber();
-	seq = lf.StartSequence();
-	size = lf.SizeFileBytes();
-	alive = lf.Type() == rocksdb::WalFileType::kAliveLogFile;
+	for(auto *const &d : database::list) try
+	{
+		if(d->rate_limiter)
+			d->rate_limiter->SetBytesPerSecond(target_rate);
 
-	return *this;
+		if(change_compactions && !d->read_only)
+			setopt(*d, "max_background_compactions", lex_cast(target_compactions));
+	}
+	catch(const std::exception &e)
+	{
+		log::error
+		{
+			log, "[%s] Compaction governor adjustment :%s",
+			d->name,
+			e.what(),
+		};
+	}
+
+	if(change_compactions || target_rate != uint64_t(rate.val))
+	{
+		char pbuf[48];
+		log::debug
+		{
+			log, "Compaction governor load:%.0lf%% rate:%s/s compactions:%zu",
+			smoothed * 100.0,
+			ircd::pretty(pbuf, iec(target_rate)),
+			target_compactions,
+		};
+	}
+
+	load_pct = smoothed * 100.0;
+	rate = target_rate;
+	compactions = target_compactions;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -4165,6 +5677,7 @@ ircd::db::prefetcher::request_worker()
 	request->req = now<steady_point>();
 	ticker->last_snd_req = duration_cast<microseconds>(request->req - request->snd);
 	ticker->accum_snd_req += ticker->last_snd_req;
+	ticker->snd_req(ticker->last_snd_req.count());
 
 	ticker->fetches++;
 	request_handle(*request);
@@ -4223,6 +5736,7 @@ try
 	request.fin = now<steady_point>();
 	ticker->last_req_fin = duration_cast<microseconds>(request.fin - request.req);
 	ticker->accum_req_fin += ticker->last_req_fin;
+	ticker->req_fin(ticker->last_req_fin.count());
 	const bool lte
 	{
 		valid_lte(*it, key)
@@ -8080,7 +9594,8 @@ rocksdb::DBOptions
 ircd::db::make_dbopts(std::string optstr,
                       std::string *const &out,
                       bool *const read_only,
-                      bool *const fsck)
+                      bool *const fsck,
+                      bool *const secondary)
 {
 	// RocksDB doesn't parse a read_only option, so we allow that to be added
 	// to open the database as read_only and then remove that from the string.
@@ -8096,6 +9611,13 @@ ircd::db::make_dbopts(std::string optstr,
 	else
 		optstr_find_and_remove(optstr, "fsck=true;"s);
 
+	// Likewise secondary=true opens the database as a secondary instance
+	// tailing a primary owned by another process.
+	if(secondary)
+		*secondary |= optstr_find_and_remove(optstr, "secondary=true;"s);
+	else
+		optstr_find_and_remove(optstr, "secondary=true;"s);
+
 	// Generate RocksDB options from string
 	rocksdb::DBOptions opts
 	{
@@ -48,6 +48,7 @@
 #include <rocksdb/filter_policy.h>
 #include <rocksdb/table.h>
 #include <rocksdb/sst_file_manager.h>
+#include <rocksdb/rate_limiter.h>
 #include <rocksdb/sst_dump_tool.h>
 #include <rocksdb/compaction_filter.h>
 #include <rocksdb/wal_filter.h>
@@ -94,7 +95,7 @@ namespace ircd::db
 
 	// Database options creator
 	bool optstr_find_and_remove(std::string &optstr, const std::string &what);
-	rocksdb::DBOptions make_dbopts(std::string optstr, std::string *const &out = nullptr, bool *read_only = nullptr, bool *fsck = nullptr);
+	rocksdb::DBOptions make_dbopts(std::string optstr, std::string *const &out = nullptr, bool *read_only = nullptr, bool *fsck = nullptr, bool *secondary = nullptr);
 	rocksdb::CompressionType find_supported_compression(const std::string &);
 
 	// Read column names from filesystem
@@ -1710,6 +1710,10 @@ noexcept try
 {
 	assert(!opts.direct);
 	const ctx::uninterruptible::nothrow ui;
+
+	// Background writers (compactions) give way here between appends once
+	// their slice is used up; nothing is held yet.
+	ctx::this_ctx::yield_slice();
 	const std::lock_guard lock{mutex};
 
 	#ifdef RB_DEBUG_DB_ENV
@@ -3349,6 +3353,10 @@ const noexcept try
 {
 	const ctx::uninterruptible::nothrow ui;
 
+	// Background readers (compactions) give way here between reads once
+	// their slice is used up.
+	ctx::this_ctx::yield_slice();
+
 	assert(result);
 	assert(scratch);
 	#ifdef RB_DEBUG_DB_ENV
@@ -4071,7 +4079,9 @@ ircd::db::database::env::state::pool::pool(database &d,
 	true,                  // queue_max_blocking
 	true,                  // queue_max_dwarning
 	make_nice(iopri),      // ionice
-	make_nice(this->pri),  // nice
+	pri == Priority::HIGH? // nice: flushes NORMAL; compactions BACKGROUND
+		int8_t(0):
+		make_nice(this->pri),
 }
 ,p
 {
@@ -94,6 +94,7 @@ ircd::http::reason
 	{ code::RANGE_NOT_SATISFIABLE,               "Range Not Satisfiable"                           },
 	{ code::EXPECTATION_FAILED,                  "Expectation Failed"                              },
 	{ code::IM_A_TEAPOT,                         "Negative, I Am A Meat Popsicle"                  },
+	{ code::MISDIRECTED_REQUEST,                 "Misdirected Request"                             },
 	{ code::UNPROCESSABLE_ENTITY,                "Unprocessable Entity"                            },
 	{ code::PRECONDITION_REQUIRED,               "Precondition Required"                           },
 	{ code::TOO_MANY_REQUESTS,                   "Too Many Requests"                               },
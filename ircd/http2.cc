@@ -91,6 +91,702 @@ static_assert
     sizeof(ircd::http2::frame::header) == 9
 );
 
+ircd::http2::frame::header::header(const uint32_t &len,
+                                   const enum type &type,
+                                   const uint8_t &flags,
+                                   const uint32_t &stream_id)
+noexcept
+:len{len}
+,type{type}
+,flags{flags}
+,stream_id{stream_id}
+{
+	assert(len < (1U << 24));
+	assert(stream_id < (1U << 31));
+}
+
+ircd::http2::frame::header::header(const const_buffer &buf)
+{
+	if(unlikely(size(buf) < sizeof(header)))
+		throw error
+		{
+			error::FRAME_SIZE_ERROR, "frame header requires %zu bytes; have %zu",
+			sizeof(header),
+			size(buf),
+		};
+
+	const auto *const b
+	{
+		reinterpret_cast<const uint8_t *>(data(buf))
+	};
+
+	len = (uint32_t(b[0]) << 16) | (uint32_t(b[1]) << 8) | uint32_t(b[2]);
+	type = (enum type)(b[3]);
+	flags = b[4];
+	stream_id =
+	{
+		((uint32_t(b[5]) & 0x7f) << 24) |
+		(uint32_t(b[6]) << 16) |
+		(uint32_t(b[7]) << 8) |
+		uint32_t(b[8])
+	};
+}
+
+ircd::const_buffer
+ircd::http2::frame::header::operator()(const mutable_buffer &buf)
+const
+{
+	if(unlikely(size(buf) < sizeof(header)))
+		throw error
+		{
+			"frame header requires %zu bytes; have %zu",
+			sizeof(header),
+			size(buf),
+		};
+
+	auto *const b
+	{
+		reinterpret_cast<uint8_t *>(data(buf))
+	};
+
+	b[0] = uint8_t(len >> 16);
+	b[1] = uint8_t(len >> 8);
+	b[2] = uint8_t(len);
+	b[3] = uint8_t(type);
+	b[4] = flags;
+	b[5] = uint8_t(stream_id >> 24) & 0x7f;
+	b[6] = uint8_t(stream_id >> 16);
+	b[7] = uint8_t(stream_id >> 8);
+	b[8] = uint8_t(stream_id);
+	return const_buffer
+	{
+		data(buf), sizeof(header)
+	};
+}
+
+ircd::string_view
+ircd::http2::frame::reflect(const type &type)
+{
+	switch(type)
+	{
+		case type::DATA:              return "DATA";
+		case type::HEADERS:           return "HEADERS";
+		case type::PRIORITY:          return "PRIORITY";
+		case type::RST_STREAM:        return "RST_STREAM";
+		case type::SETTINGS:          return "SETTINGS";
+		case type::PUSH_PROMISE:      return "PUSH_PROMISE";
+		case type::PING:              return "PING";
+		case type::GOAWAY:            return "GOAWAY";
+		case type::WINDOW_UPDATE:     return "WINDOW_UPDATE";
+		case type::CONTINUATION:      return "CONTINUATION";
+	}
+
+	return "??????";
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// hpack.h
+//
+
+namespace ircd::http2::hpack
+{
+	struct huffman_node;
+
+	extern const std::array<std::pair<uint32_t, uint8_t>, 256> huffman_code;
+	extern const std::vector<huffman_node> huffman_tree;
+
+	static std::vector<huffman_node> huffman_tree_make();
+	static size_t encode_integer(const mutable_buffer &, const size_t &off, const uint8_t &prefix, const uint8_t &bits, size_t val);
+	static size_t encode_string(const mutable_buffer &, const size_t &off, const string_view &);
+	static size_t decode_integer(const const_buffer &, size_t &off, const uint8_t &bits);
+	static string_view decode_string(const const_buffer &, size_t &off, window_buffer &scratch);
+}
+
+/// Nodes of the tree for decoding; a leaf has no children and the symbol.
+struct ircd::http2::hpack::huffman_node
+{
+	int16_t child[2] {-1, -1};
+	int16_t symbol {-1};
+};
+
+/// RFC 7541 Appendix A
+decltype(ircd::http2::hpack::static_table)
+ircd::http2::hpack::static_table
+{{
+	{ ":authority"_sv,                {}                 },
+	{ ":method"_sv,                   "GET"_sv           },
+	{ ":method"_sv,                   "POST"_sv          },
+	{ ":path"_sv,                     "/"_sv             },
+	{ ":path"_sv,                     "/index.html"_sv   },
+	{ ":scheme"_sv,                   "http"_sv          },
+	{ ":scheme"_sv,                   "https"_sv         },
+	{ ":status"_sv,                   "200"_sv           },
+	{ ":status"_sv,                   "204"_sv           },
+	{ ":status"_sv,                   "206"_sv           },
+	{ ":status"_sv,                   "304"_sv           },
+	{ ":status"_sv,                   "400"_sv           },
+	{ ":status"_sv,                   "404"_sv           },
+	{ ":status"_sv,                   "500"_sv           },
+	{ "accept-charset"_sv,            {}                 },
+	{ "accept-encoding"_sv,           "gzip, deflate"_sv },
+	{ "accept-language"_sv,           {}                 },
+	{ "accept-ranges"_sv,             {}                 },
+	{ "accept"_sv,                    {}                 },
+	{ "access-control-allow-origin"_sv, {}                 },
+	{ "age"_sv,                       {}                 },
+	{ "allow"_sv,                     {}                 },
+	{ "authorization"_sv,             {}                 },
+	{ "cache-control"_sv,             {}                 },
+	{ "content-disposition"_sv,       {}                 },
+	{ "content-encoding"_sv,          {}                 },
+	{ "content-language"_sv,          {}                 },
+	{ "content-length"_sv,            {}                 },
+	{ "content-location"_sv,          {}                 },
+	{ "content-range"_sv,             {}                 },
+	{ "content-type"_sv,              {}                 },
+	{ "cookie"_sv,                    {}                 },
+	{ "date"_sv,                      {}                 },
+	{ "etag"_sv,                      {}                 },
+	{ "expect"_sv,                    {}                 },
+	{ "expires"_sv,                   {}                 },
+	{ "from"_sv,                      {}                 },
+	{ "host"_sv,                      {}                 },
+	{ "if-match"_sv,                  {}                 },
+	{ "if-modified-since"_sv,         {}                 },
+	{ "if-none-match"_sv,             {}                 },
+	{ "if-range"_sv,                  {}                 },
+	{ "if-unmodified-since"_sv,       {}                 },
+	{ "last-modified"_sv,             {}                 },
+	{ "link"_sv,                      {}                 },
+	{ "location"_sv,                  {}                 },
+	{ "max-forwards"_sv,              {}                 },
+	{ "proxy-authenticate"_sv,        {}                 },
+	{ "proxy-authorization"_sv,       {}                 },
+	{ "range"_sv,                     {}                 },
+	{ "referer"_sv,                   {}                 },
+	{ "refresh"_sv,                   {}                 },
+	{ "retry-after"_sv,               {}                 },
+	{ "server"_sv,                    {}                 },
+	{ "set-cookie"_sv,                {}                 },
+	{ "strict-transport-security"_sv, {}                 },
+	{ "transfer-encoding"_sv,         {}                 },
+	{ "user-agent"_sv,                {}                 },
+	{ "vary"_sv,                      {}                 },
+	{ "via"_sv,                       {}                 },
+	{ "www-authenticate"_sv,          {}                 },
+}};
+
+/// RFC 7541 Appendix B; the code (right-aligned) and its length in bits for
+/// each symbol. The EOS symbol is not included; it is never decoded.
+decltype(ircd::http2::hpack::huffman_code)
+ircd::http2::hpack::huffman_code
+{{
+	{ 0x00001ff8, 13 }, { 0x007fffd8, 23 }, { 0x0fffffe2, 28 }, { 0x0fffffe3, 28 },
+	{ 0x0fffffe4, 28 }, { 0x0fffffe5, 28 }, { 0x0fffffe6, 28 }, { 0x0fffffe7, 28 },
+	{ 0x0fffffe8, 28 }, { 0x00ffffea, 24 }, { 0x3ffffffc, 30 }, { 0x0fffffe9, 28 },
+	{ 0x0fffffea, 28 }, { 0x3ffffffd, 30 }, { 0x0fffffeb, 28 }, { 0x0fffffec, 28 },
+	{ 0x0fffffed, 28 }, { 0x0fffffee, 28 }, { 0x0fffffef, 28 }, { 0x0ffffff0, 28 },
+	{ 0x0ffffff1, 28 }, { 0x0ffffff2, 28 }, { 0x3ffffffe, 30 }, { 0x0ffffff3, 28 },
+	{ 0x0ffffff4, 28 }, { 0x0ffffff5, 28 }, { 0x0ffffff6, 28 }, { 0x0ffffff7, 28 },
+	{ 0x0ffffff8, 28 }, { 0x0ffffff9, 28 }, { 0x0ffffffa, 28 }, { 0x0ffffffb, 28 },
+	{ 0x00000014,  6 }, { 0x000003f8, 10 }, { 0x000003f9, 10 }, { 0x00000ffa, 12 },
+	{ 0x00001ff9, 13 }, { 0x00000015,  6 }, { 0x000000f8,  8 }, { 0x000007fa, 11 },
+	{ 0x000003fa, 10 }, { 0x000003fb, 10 }, { 0x000000f9,  8 }, { 0x000007fb, 11 },
+	{ 0x000000fa,  8 }, { 0x00000016,  6 }, { 0x00000017,  6 }, { 0x00000018,  6 },
+	{ 0x00000000,  5 }, { 0x00000001,  5 }, { 0x00000002,  5 }, { 0x00000019,  6 },
+	{ 0x0000001a,  6 }, { 0x0000001b,  6 }, { 0x0000001c,  6 }, { 0x0000001d,  6 },
+	{ 0x0000001e,  6 }, { 0x0000001f,  6 }, { 0x0000005c,  7 }, { 0x000000fb,  8 },
+	{ 0x00007ffc, 15 }, { 0x00000020,  6 }, { 0x00000ffb, 12 }, { 0x000003fc, 10 },
+	{ 0x00001ffa, 13 }, { 0x00000021,  6 }, { 0x0000005d,  7 }, { 0x0000005e,  7 },
+	{ 0x0000005f,  7 }, { 0x00000060,  7 }, { 0x00000061,  7 }, { 0x00000062,  7 },
+	{ 0x00000063,  7 }, { 0x00000064,  7 }, { 0x00000065,  7 }, { 0x00000066,  7 },
+	{ 0x00000067,  7 }, { 0x00000068,  7 }, { 0x00000069,  7 }, { 0x0000006a,  7 },
+	{ 0x0000006b,  7 }, { 0x0000006c,  7 }, { 0x0000006d,  7 }, { 0x0000006e,  7 },
+	{ 0x0000006f,  7 }, { 0x00000070,  7 }, { 0x00000071,  7 }, { 0x00000072,  7 },
+	{ 0x000000fc,  8 }, { 0x00000073,  7 }, { 0x000000fd,  8 }, { 0x00001ffb, 13 },
+	{ 0x0007fff0, 19 }, { 0x00001ffc, 13 }, { 0x00003ffc, 14 }, { 0x00000022,  6 },
+	{ 0x00007ffd, 15 }, { 0x00000003,  5 }, { 0x00000023,  6 }, { 0x00000004,  5 },
+	{ 0x00000024,  6 }, { 0x00000005,  5 }, { 0x00000025,  6 }, { 0x00000026,  6 },
+	{ 0x00000027,  6 }, { 0x00000006,  5 }, { 0x00000074,  7 }, { 0x00000075,  7 },
+	{ 0x00000028,  6 }, { 0x00000029,  6 }, { 0x0000002a,  6 }, { 0x00000007,  5 },
+	{ 0x0000002b,  6 }, { 0x00000076,  7 }, { 0x0000002c,  6 }, { 0x00000008,  5 },
+	{ 0x00000009,  5 }, { 0x0000002d,  6 }, { 0x00000077,  7 }, { 0x00000078,  7 },
+	{ 0x00000079,  7 }, { 0x0000007a,  7 }, { 0x0000007b,  7 }, { 0x00007ffe, 15 },
+	{ 0x000007fc, 11 }, { 0x00003ffd, 14 }, { 0x00001ffd, 13 }, { 0x0ffffffc, 28 },
+	{ 0x000fffe6, 20 }, { 0x003fffd2, 22 }, { 0x000fffe7, 20 }, { 0x000fffe8, 20 },
+	{ 0x003fffd3, 22 }, { 0x003fffd4, 22 }, { 0x003fffd5, 22 }, { 0x007fffd9, 23 },
+	{ 0x003fffd6, 22 }, { 0x007fffda, 23 }, { 0x007fffdb, 23 }, { 0x007fffdc, 23 },
+	{ 0x007fffdd, 23 }, { 0x007fffde, 23 }, { 0x00ffffeb, 24 }, { 0x007fffdf, 23 },
+	{ 0x00ffffec, 24 }, { 0x00ffffed, 24 }, { 0x003fffd7, 22 }, { 0x007fffe0, 23 },
+	{ 0x00ffffee, 24 }, { 0x007fffe1, 23 }, { 0x007fffe2, 23 }, { 0x007fffe3, 23 },
+	{ 0x007fffe4, 23 }, { 0x001fffdc, 21 }, { 0x003fffd8, 22 }, { 0x007fffe5, 23 },
+	{ 0x003fffd9, 22 }, { 0x007fffe6, 23 }, { 0x007fffe7, 23 }, { 0x00ffffef, 24 },
+	{ 0x003fffda, 22 }, { 0x001fffdd, 21 }, { 0x000fffe9, 20 }, { 0x003fffdb, 22 },
+	{ 0x003fffdc, 22 }, { 0x007fffe8, 23 }, { 0x007fffe9, 23 }, { 0x001fffde, 21 },
+	{ 0x007fffea, 23 }, { 0x003fffdd, 22 }, { 0x003fffde, 22 }, { 0x00fffff0, 24 },
+	{ 0x001fffdf, 21 }, { 0x003fffdf, 22 }, { 0x007fffeb, 23 }, { 0x007fffec, 23 },
+	{ 0x001fffe0, 21 }, { 0x001fffe1, 21 }, { 0x003fffe0, 22 }, { 0x001fffe2, 21 },
+	{ 0x007fffed, 23 }, { 0x003fffe1, 22 }, { 0x007fffee, 23 }, { 0x007fffef, 23 },
+	{ 0x000fffea, 20 }, { 0x003fffe2, 22 }, { 0x003fffe3, 22 }, { 0x003fffe4, 22 },
+	{ 0x007ffff0, 23 }, { 0x003fffe5, 22 }, { 0x003fffe6, 22 }, { 0x007ffff1, 23 },
+	{ 0x03ffffe0, 26 }, { 0x03ffffe1, 26 }, { 0x000fffeb, 20 }, { 0x0007fff1, 19 },
+	{ 0x003fffe7, 22 }, { 0x007ffff2, 23 }, { 0x003fffe8, 22 }, { 0x01ffffec, 25 },
+	{ 0x03ffffe2, 26 }, { 0x03ffffe3, 26 }, { 0x03ffffe4, 26 }, { 0x07ffffde, 27 },
+	{ 0x07ffffdf, 27 }, { 0x03ffffe5, 26 }, { 0x00fffff1, 24 }, { 0x01ffffed, 25 },
+	{ 0x0007fff2, 19 }, { 0x001fffe3, 21 }, { 0x03ffffe6, 26 }, { 0x07ffffe0, 27 },
+	{ 0x07ffffe1, 27 }, { 0x03ffffe7, 26 }, { 0x07ffffe2, 27 }, { 0x00fffff2, 24 },
+	{ 0x001fffe4, 21 }, { 0x001fffe5, 21 }, { 0x03ffffe8, 26 }, { 0x03ffffe9, 26 },
+	{ 0x0ffffffd, 28 }, { 0x07ffffe3, 27 }, { 0x07ffffe4, 27 }, { 0x07ffffe5, 27 },
+	{ 0x000fffec, 20 }, { 0x00fffff3, 24 }, { 0x000fffed, 20 }, { 0x001fffe6, 21 },
+	{ 0x003fffe9, 22 }, { 0x001fffe7, 21 }, { 0x001fffe8, 21 }, { 0x007ffff3, 23 },
+	{ 0x003fffea, 22 }, { 0x003fffeb, 22 }, { 0x01ffffee, 25 }, { 0x01ffffef, 25 },
+	{ 0x00fffff4, 24 }, { 0x00fffff5, 24 }, { 0x03ffffea, 26 }, { 0x007ffff4, 23 },
+	{ 0x03ffffeb, 26 }, { 0x07ffffe6, 27 }, { 0x03ffffec, 26 }, { 0x03ffffed, 26 },
+	{ 0x07ffffe7, 27 }, { 0x07ffffe8, 27 }, { 0x07ffffe9, 27 }, { 0x07ffffea, 27 },
+	{ 0x07ffffeb, 27 }, { 0x0ffffffe, 28 }, { 0x07ffffec, 27 }, { 0x07ffffed, 27 },
+	{ 0x07ffffee, 27 }, { 0x07ffffef, 27 }, { 0x07fffff0, 27 }, { 0x03ffffee, 26 },
+}};
+
+decltype(ircd::http2::hpack::huffman_tree)
+ircd::http2::hpack::huffman_tree
+{
+	huffman_tree_make()
+};
+
+std::vector<ircd::http2::hpack::huffman_node>
+ircd::http2::hpack::huffman_tree_make()
+{
+	std::vector<huffman_node> ret(1);
+	ret.reserve(huffman_code.size() * 2);
+	for(size_t sym(0); sym < huffman_code.size(); ++sym)
+	{
+		const auto &[code, len]
+		{
+			huffman_code[sym]
+		};
+
+		size_t node(0);
+		for(ssize_t i(len - 1); i >= 0; --i)
+		{
+			const bool bit
+			{
+				bool(code & (1U << i))
+			};
+
+			if(ret[node].child[bit] < 0)
+			{
+				ret[node].child[bit] = ret.size();
+				ret.emplace_back();
+			}
+
+			node = ret[node].child[bit];
+		}
+
+		ret[node].symbol = sym;
+	}
+
+	return ret;
+}
+
+ircd::string_view
+ircd::http2::hpack::huffman_decode(const mutable_buffer &out,
+                                   const const_buffer &in)
+{
+	size_t node(0), pos(0), depth(0);
+	for(const uint8_t byte : string_view{in})
+		for(ssize_t i(7); i >= 0; --i)
+		{
+			const bool bit(byte & (1U << i));
+			const auto next(huffman_tree[node].child[bit]);
+
+			// Only the EOS symbol of all ones exceeds the depth of the tree.
+			if(unlikely(next < 0))
+				throw error
+				{
+					error::COMPRESSION_ERROR, "Huffman string contains EOS",
+				};
+
+			node = next;
+			++depth;
+			if(huffman_tree[node].symbol < 0)
+				continue;
+
+			if(unlikely(pos >= size(out)))
+				throw error
+				{
+					error::COMPRESSION_ERROR, "Huffman string exceeds %zu bytes",
+					size(out),
+				};
+
+			out[pos++] = huffman_tree[node].symbol;
+			node = 0;
+			depth = 0;
+		}
+
+	// Padding is a prefix of EOS (all ones) strictly shorter than 8 bits.
+	if(unlikely(depth >= 8))
+		throw error
+		{
+			error::COMPRESSION_ERROR, "Huffman string padding exceeds 7 bits",
+		};
+
+	return string_view
+	{
+		data(out), pos
+	};
+}
+
+ircd::const_buffer
+ircd::http2::hpack::encode(const mutable_buffer &out,
+                           const string_view &name,
+                           const string_view &value)
+{
+	size_t name_index(0);
+	for(size_t i(0); i < static_table.size(); ++i)
+	{
+		if(static_table[i].first != name)
+			continue;
+
+		// Indexed header field (6.1)
+		if(static_table[i].second == value)
+			return const_buffer
+			{
+				data(out), encode_integer(out, 0, 0x80, 7, i + 1)
+			};
+
+		name_index = name_index?: i + 1;
+	}
+
+	// Literal header field without indexing (6.2.2); indexed name, or with
+	// the literal name following when the index is zero.
+	size_t off
+	{
+		encode_integer(out, 0, 0x00, 4, name_index)
+	};
+
+	if(!name_index)
+		off = encode_string(out, off, name);
+
+	off = encode_string(out, off, value);
+	return const_buffer
+	{
+		data(out), off
+	};
+}
+
+void
+ircd::http2::hpack::decode(table &table,
+                           const const_buffer &block,
+                           const mutable_buffer &scratch,
+                           const closure &closure)
+{
+	size_t off(0);
+	window_buffer sb(scratch);
+	while(off < size(block))
+	{
+		const uint8_t &byte
+		{
+			reinterpret_cast<const uint8_t &>(block[off])
+		};
+
+		// Indexed header field (6.1)
+		if(byte & 0x80)
+		{
+			const auto &[name, value]
+			{
+				table.at(decode_integer(block, off, 7))
+			};
+
+			closure(name, value);
+			continue;
+		}
+
+		// Dynamic table size update (6.3)
+		if((byte & 0xe0) == 0x20)
+		{
+			table.resize(decode_integer(block, off, 5));
+			continue;
+		}
+
+		// Literal header field with incremental indexing (6.2.1), without
+		// indexing (6.2.2) or never indexed (6.2.3); they differ only by the
+		// length of the prefix of the name index.
+		const bool indexing
+		{
+			(byte & 0xc0) == 0x40
+		};
+
+		const size_t name_index
+		{
+			decode_integer(block, off, indexing? 6: 4)
+		};
+
+		const string_view name
+		{
+			name_index?
+				table.at(name_index).first:
+				decode_string(block, off, sb)
+		};
+
+		const string_view value
+		{
+			decode_string(block, off, sb)
+		};
+
+		closure(name, value);
+		if(indexing)
+			table.add(name, value);
+	}
+}
+
+size_t
+ircd::http2::hpack::encode_integer(const mutable_buffer &out,
+                                   const size_t &off_,
+                                   const uint8_t &prefix,
+                                   const uint8_t &bits,
+                                   size_t val)
+{
+	size_t off(off_);
+	const size_t max
+	{
+		(1UL << bits) - 1
+	};
+
+	const auto put{[&out, &off]
+	(const uint8_t &byte)
+	{
+		if(unlikely(off >= size(out)))
+			throw error
+			{
+				"No more space to encode header (%zu bytes)",
+				size(out),
+			};
+
+		out[off++] = byte;
+	}};
+
+	if(val < max)
+	{
+		put(prefix | uint8_t(val));
+		return off;
+	}
+
+	put(prefix | uint8_t(max));
+	for(val -= max; val >= 0x80; val >>= 7)
+		put(uint8_t(val & 0x7f) | 0x80);
+
+	put(uint8_t(val));
+	return off;
+}
+
+size_t
+ircd::http2::hpack::encode_string(const mutable_buffer &out,
+                                  const size_t &off_,
+                                  const string_view &str)
+{
+	const size_t off
+	{
+		encode_integer(out, off_, 0x00, 7, size(str))
+	};
+
+	if(unlikely(off + size(str) > size(out)))
+		throw error
+		{
+			"No more space to encode header (%zu bytes)",
+			size(out),
+		};
+
+	return off + copy(out + off, str);
+}
+
+size_t
+ircd::http2::hpack::decode_integer(const const_buffer &in,
+                                   size_t &off,
+                                   const uint8_t &bits)
+{
+	const auto get{[&in, &off]
+	{
+		if(unlikely(off >= size(in)))
+			throw error
+			{
+				error::COMPRESSION_ERROR, "Truncated integer",
+			};
+
+		return uint8_t(in[off++]);
+	}};
+
+	const size_t max
+	{
+		(1UL << bits) - 1
+	};
+
+	size_t ret
+	{
+		get() & max
+	};
+
+	if(ret < max)
+		return ret;
+
+	uint8_t byte; size_t shift(0); do
+	{
+		if(unlikely(shift > 28))
+			throw error
+			{
+				error::COMPRESSION_ERROR, "Integer overflow",
+			};
+
+		byte = get();
+		ret += size_t(byte & 0x7f) << shift;
+		shift += 7;
+	}
+	while(byte & 0x80);
+
+	return ret;
+}
+
+ircd::string_view
+ircd::http2::hpack::decode_string(const const_buffer &in,
+                                  size_t &off,
+                                  window_buffer &scratch)
+{
+	if(unlikely(off >= size(in)))
+		throw error
+		{
+			error::COMPRESSION_ERROR, "Truncated string",
+		};
+
+	const bool huffman
+	{
+		bool(uint8_t(in[off]) & 0x80)
+	};
+
+	const size_t len
+	{
+		decode_integer(in, off, 7)
+	};
+
+	if(unlikely(off + len > size(in)))
+		throw error
+		{
+			error::COMPRESSION_ERROR, "Truncated string of %zu bytes",
+			len,
+		};
+
+	const const_buffer str
+	{
+		data(in) + off, len
+	};
+
+	off += len;
+	if(!huffman)
+		return string_view{str};
+
+	string_view ret;
+	scratch([&ret, &str](const mutable_buffer &buf)
+	{
+		ret = huffman_decode(buf, str);
+		return size(ret);
+	});
+
+	return ret;
+}
+
+//
+// table
+//
+
+/// Index into the combined static and dynamic tables per 2.3.3.
+ircd::http2::hpack::header
+ircd::http2::hpack::table::at(const size_t &index)
+const
+{
+	if(likely(index > 0 && index <= static_table.size()))
+		return static_table[index - 1];
+
+	const size_t dyn
+	{
+		index - static_table.size() - 1
+	};
+
+	if(unlikely(!index || dyn >= entries.size()))
+		throw error
+		{
+			error::COMPRESSION_ERROR, "Header index %zu out of range",
+			index,
+		};
+
+	const auto &[name, value]
+	{
+		entries[dyn]
+	};
+
+	return header
+	{
+		name, value
+	};
+}
+
+void
+ircd::http2::hpack::table::resize(const size_t &max)
+{
+	if(unlikely(max > limit))
+		throw error
+		{
+			error::COMPRESSION_ERROR, "Table size update %zu exceeds limit of %zu",
+			max,
+			limit,
+		};
+
+	this->max = max;
+	while(size > max)
+	{
+		assert(!entries.empty());
+		const auto &[name, value]
+		{
+			entries.back()
+		};
+
+		size -= entry_overhead + name.size() + value.size();
+		entries.pop_back();
+	}
+}
+
+/// An entry larger than the table empties it and is not added (4.4).
+void
+ircd::http2::hpack::table::add(const string_view &name,
+                               const string_view &value)
+{
+	const size_t len
+	{
+		entry_overhead + name.size() + value.size()
+	};
+
+	// The name may reference an entry which is about to be evicted.
+	std::pair<std::string, std::string> entry
+	{
+		name, value
+	};
+
+	while(!entries.empty() && size + len > max)
+	{
+		const auto &[name, value]
+		{
+			entries.back()
+		};
+
+		size -= entry_overhead + name.size() + value.size();
+		entries.pop_back();
+	}
+
+	if(len > max)
+		return;
+
+	entries.emplace_front(std::move(entry));
+	size += len;
+}
+
 
 ///////////////////////////////////////////////////////////////////////////////
 //
@@ -93,6 +93,10 @@ ircd::ios::descriptor::descriptor(const string_view &name,
 {
 	std::make_unique<struct stats>()
 }
+,slab
+{
+	std::make_unique<struct slab>()
+}
 ,allocator
 {
 	allocator?: default_allocator
@@ -120,11 +124,11 @@ ircd::ios::descriptor::default_deallocator(handler &handler,
                                            const size_t &size)
 noexcept
 {
-	#ifdef __clang__
-	::operator delete(ptr);
-	#else
-	::operator delete(ptr, size);
-	#endif
+	assert(handler.descriptor);
+	auto &descriptor(*handler.descriptor);
+
+	assert(descriptor.slab && descriptor.stats);
+	descriptor.slab->deallocate(*descriptor.stats, ptr, size);
 }
 
 [[gnu::hot]]
@@ -132,7 +136,122 @@ void *
 ircd::ios::descriptor::default_allocator(handler &handler,
                                          const size_t &size)
 {
-	return ::operator new(size);
+	assert(handler.descriptor);
+	auto &descriptor(*handler.descriptor);
+
+	assert(descriptor.slab && descriptor.stats);
+	return descriptor.slab->allocate(*descriptor.stats, size);
+}
+
+//
+// descriptor::slab
+//
+
+ircd::ios::descriptor::slab::slab()
+{
+}
+
+ircd::ios::descriptor::slab::~slab()
+noexcept
+{
+	for(auto &shard : shards)
+		while(shard.head)
+		{
+			::operator delete(std::exchange(shard.head, shard.head->next));
+			--shard.count;
+		}
+}
+
+[[gnu::hot]]
+void *
+ircd::ios::descriptor::slab::allocate(struct stats &stats,
+                                      const size_t &size)
+{
+	const auto idx
+	{
+		class_of(size)
+	};
+
+	if(unlikely(idx >= classes))
+	{
+		++stats.slab_misses;
+		return ::operator new(size);
+	}
+
+	// Allocations are rounded up to the class whether or not they come off
+	// the list, so any entry can be recycled by any thread's free.
+	const size_t class_size
+	{
+		(idx + 1) * granule
+	};
+
+	if(unlikely(!is_main_thread()))
+	{
+		++stats.slab_misses;
+		return ::operator new(class_size);
+	}
+
+	auto &shard(shards[idx]);
+	shard.outstanding++;
+	shard.peak = std::max(shard.peak, shard.outstanding);
+	if(!shard.head)
+	{
+		++stats.slab_misses;
+		return ::operator new(class_size);
+	}
+
+	++stats.slab_hits;
+	assert(shard.count > 0);
+	--shard.count;
+	return std::exchange(shard.head, shard.head->next);
+}
+
+[[gnu::hot]]
+void
+ircd::ios::descriptor::slab::deallocate(struct stats &stats,
+                                        void *const &ptr,
+                                        const size_t &size)
+noexcept
+{
+	const auto idx
+	{
+		class_of(size)
+	};
+
+	const size_t class_size
+	{
+		idx < classes? (idx + 1) * granule : size
+	};
+
+	if(likely(idx < classes && is_main_thread()))
+	{
+		auto &shard(shards[idx]);
+		shard.outstanding -= bool(shard.outstanding);
+		if(shard.count < std::min(size_t(shard.peak), max))
+		{
+			static_assert(sizeof(node) <= granule);
+			shard.head = new (ptr) node
+			{
+				shard.head
+			};
+
+			++shard.count;
+			return;
+		}
+	}
+
+	#ifdef __clang__
+	::operator delete(ptr);
+	#else
+	::operator delete(ptr, class_size);
+	#endif
+}
+
+size_t
+ircd::ios::descriptor::slab::class_of(const size_t &size)
+noexcept
+{
+	return size? (size - 1) / granule : 0;
 }
 
 //
@@ -159,10 +278,14 @@ ircd::ios::descriptor::stats::operator+=(const stats &o)
 	alloc_bytes += o.alloc_bytes;
 	frees += o.frees;
 	free_bytes += o.free_bytes;
+	slab_hits += o.slab_hits;
+	slab_misses += o.slab_misses;
 	slice_total += o.slice_total;
 	slice_last += o.slice_last;
 	latency_total += o.latency_total;
 	latency_last += o.latency_last;
+	slice_hist += o.slice_hist;
+	latency_hist += o.latency_hist;
 	return *this;
 }
 
@@ -197,6 +320,7 @@ noexcept
 	{
 		stats.slice_last = cycles() - handler->ts;
 		stats.slice_total += stats.slice_last;
+		stats.slice_hist(stats.slice_last);
 
 		assert(handler::current == handler);
 		handler::current = nullptr;
@@ -226,6 +350,7 @@ noexcept
 	assert(slice_stop >= handler->ts);
 	stats.slice_last = slice_stop - handler->ts;
 	stats.slice_total += stats.slice_last;
+	stats.slice_hist(stats.slice_last);
 
 	assert(handler::current == handler);
 	handler::current = nullptr;
@@ -254,6 +379,7 @@ noexcept
 
 	stats.latency_last = handler->ts - last_ts;
 	stats.latency_total += stats.latency_last;
+	stats.latency_hist(stats.latency_last);
 }
 
 [[gnu::hot]]
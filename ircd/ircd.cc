@@ -76,6 +76,19 @@ ircd::read_only
 	{ "persist",  false                },
 };
 
+/// Coarse mode declaration for operating as a secondary instance: another
+/// process owns the databases and this process tails them, serving only the
+/// subset of resources configured for it. The matrix database is opened as a
+/// RocksDB secondary which periodically catches up with the primary. This
+/// implies read_only and should be set before ircd::init().
+decltype(ircd::secondary)
+ircd::secondary
+{
+	{ "name",     "ircd.secondary"     },
+	{ "default",  false                },
+	{ "persist",  false                },
+};
+
 /// Coarse mode indicator for debug/developer behavior when and if possible.
 /// For example: additional log messages may be enabled by this mode. This
 /// option is technically effective in both release builds and debug builds
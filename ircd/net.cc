@@ -1169,6 +1169,20 @@ ircd::net::socket::total_calls_out
 	{ "desc", "The total number of write operations on all sockets"  },
 };
 
+decltype(ircd::net::socket::total_handshakes)
+ircd::net::socket::total_handshakes
+{
+	{ "name", "ircd.net.socket.handshake.total"                             },
+	{ "desc", "The total number of completed client handshakes"             },
+};
+
+decltype(ircd::net::socket::total_resumed)
+ircd::net::socket::total_resumed
+{
+	{ "name", "ircd.net.socket.handshake.resumed"                           },
+	{ "desc", "The number of client handshakes which resumed a session"     },
+};
+
 //
 // socket
 //
@@ -1296,6 +1310,12 @@ ircd::net::socket::handshake(const open_opts &opts,
 	if(opts.send_sni && server_name(opts))
 		openssl::server_name(*this, server_name(opts));
 
+	if(opts.session)
+		openssl::set_session(*this, *opts.session);
+
+	if(!opts.alpn.empty())
+		openssl::alpn(*this, opts.alpn);
+
 	ssl.set_verify_callback(std::move(verify_handler));
 	ssl.async_handshake(handshake_type::client, ios::handle(desc, std::move(handshake_handler)));
 }
@@ -2213,15 +2233,24 @@ noexcept try
 	thread_local char ecbuf[64];
 	log::debug
 	{
-		log, "%s handshake cipher:%s %s",
+		log, "%s handshake cipher:%s%s %s",
 		loghead(*this),
 		current_cipher?
 			openssl::name(*current_cipher):
 			"<NO CIPHER>"_sv,
+		!ec && openssl::session_reused(*this)?
+			" resumed"_sv:
+			string_view{},
 		string(ecbuf, ec)
 	};
 	#endif
 
+	if(!ec)
+	{
+		++total_handshakes;
+		total_resumed += openssl::session_reused(*this);
+	}
+
 	// Toggles the behavior of non-async functions; see func comment
 	if(!ec)
 		blocking(*this, false);
@@ -8,6 +8,8 @@
 // copyright notice and this permission notice is present in all copies. The
 // full license for this software is available in the LICENSE file.
 
+#include <RB_INC_OPENSSL_CORE_NAMES_H
+
 /// Option to indicate if any listener sockets should be allowed to bind. If
 /// false then no listeners should bind. This is only effective on startup
 /// unless a conf item updated function is implemented here.
@@ -107,6 +109,18 @@ ircd::net::handshaking_count(const acceptor &a,
 	});
 }
 
+size_t
+ircd::net::handshook_count(const acceptor &a)
+{
+	return a.handshakes;
+}
+
+size_t
+ircd::net::resumed_count(const acceptor &a)
+{
+	return a.resumed;
+}
+
 ircd::net::ipport
 ircd::net::local(const acceptor &a)
 {
@@ -272,6 +286,88 @@ ircd::net::acceptor::ssl_cipher_blacklist
 	{ "default",  string_view{ircd::net::ssl_cipher_blacklist} },
 };
 
+/// Toggles stateless session resumption by issuing session tickets to
+/// clients; otherwise only the server-side session cache is available.
+decltype(ircd::net::acceptor::ssl_tickets)
+ircd::net::acceptor::ssl_tickets
+{
+	{ "name",     "ircd.net.acceptor.ssl.tickets" },
+	{ "default",  true                            },
+};
+
+/// Interval at which the session ticket encryption key is replaced. Tickets
+/// issued under the previous key are still accepted (and renewed) for one
+/// more interval, after which those clients conduct a full handshake.
+decltype(ircd::net::acceptor::ssl_tickets_rotate)
+ircd::net::acceptor::ssl_tickets_rotate
+{
+	{ "name",     "ircd.net.acceptor.ssl.tickets.rotate" },
+	{ "default",  long(60 * 60 * 12)                     },
+};
+
+/// Number of sessions held in the server-side cache for clients which don't
+/// support tickets.
+decltype(ircd::net::acceptor::ssl_session_cache_size)
+ircd::net::acceptor::ssl_session_cache_size
+{
+	{ "name",     "ircd.net.acceptor.ssl.session.cache.size" },
+	{ "default",  long(16384)                                },
+};
+
+decltype(ircd::net::acceptor::ssl_session_timeout)
+ircd::net::acceptor::ssl_session_timeout
+{
+	{ "name",     "ircd.net.acceptor.ssl.session.timeout" },
+	{ "default",  long(60 * 60 * 24)                      },
+};
+
+decltype(ircd::net::acceptor::handshakes_total)
+ircd::net::acceptor::handshakes_total
+{
+	{ "name", "ircd.net.acceptor.handshake.total"                          },
+	{ "desc", "The total number of completed server handshakes"            },
+};
+
+decltype(ircd::net::acceptor::handshakes_resumed)
+ircd::net::acceptor::handshakes_resumed
+{
+	{ "name", "ircd.net.acceptor.handshake.resumed"                        },
+	{ "desc", "The number of server handshakes which resumed a session"    },
+};
+
+decltype(ircd::net::acceptor::tickets_rotated)
+ircd::net::acceptor::tickets_rotated
+{
+	{ "name", "ircd.net.acceptor.ssl.tickets.rotated"                      },
+	{ "desc", "The number of session ticket key rotations"                 },
+};
+
+/// The number of threads conducting TLS handshakes for each listener. When
+/// zero the handshakes are conducted asynchronously on the main thread.
+/// Effective for listeners opened after this is changed.
+decltype(ircd::net::acceptor::offload_threads)
+ircd::net::acceptor::offload_threads
+{
+	{ "name",     "ircd.net.acceptor.offload.threads" },
+	{ "default",  0L                                  },
+};
+
+/// Whether each offload thread also accepts connections with its own
+/// SO_REUSEPORT socket. Effective for listeners opened after this is changed.
+decltype(ircd::net::acceptor::offload_accept)
+ircd::net::acceptor::offload_accept
+{
+	{ "name",     "ircd.net.acceptor.offload.accept" },
+	{ "default",  false                              },
+};
+
+decltype(ircd::net::acceptor::handshake_latency)
+ircd::net::acceptor::handshake_latency
+{
+	{ "name", "ircd.net.acceptor.handshake.latency"                        },
+	{ "desc", "Microseconds from accept to completed server handshake"     },
+};
+
 //
 // acceptor::acceptor
 //
@@ -367,10 +463,23 @@ ircd::net::acceptor::open()
 		true
 	};
 
+	static const asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT> reuse_port
+	{
+		true
+	};
+
+	const bool offload_accept
+	{
+		size_t(offload_threads) && bool(acceptor::offload_accept)
+	};
+
 	assert(!interrupting);
 	interrupting = false;
 	a.open(ep.protocol());
 	a.set_option(reuse_address);
+	if(offload_accept)
+		a.set_option(reuse_port);
+
 	a.non_blocking(true);
 	log::debug
 	{
@@ -393,6 +502,9 @@ ircd::net::acceptor::open()
 		backlog,
 		max_connections
 	};
+
+	if(!offloader && size_t(offload_threads))
+		offloader = std::make_unique<struct offload>(*this, size_t(offload_threads), offload_accept);
 }
 
 void
@@ -404,10 +516,18 @@ ircd::net::acceptor::close()
 	if(a.is_open())
 		a.close();
 
-	for(const auto &sock : handshaking)
+	// Sockets handshaking on the offload threads are owned by those threads
+	// until they post back; the handshakes are only woken from here.
+	if(offloader)
+	{
+		offloader->close();
+		offloader->cancel();
+	}
+	else for(const auto &sock : handshaking)
 		sock->cancel();
 
 	join();
+	offloader.reset();
 	log::debug
 	{
 		log, "%s listener finished",
@@ -427,7 +547,7 @@ noexcept try
 
 	joining.wait([this]
 	{
-		return !accepting && handshaking.empty();
+		return !accepting && handshaking.empty() && (!offloader || !offloader->posted);
 	});
 
 	interrupting = false;
@@ -513,7 +633,6 @@ noexcept try
 {
 	assert(bool(sock));
 	assert(accepting > 0);
-	assert(accepting == 1); // for now
 	thread_local char ecbuf[64];
 	log::debug
 	{
@@ -568,9 +687,17 @@ noexcept try
 		handshaking.emplace(end(handshaking), sock)
 	};
 
+	const auto started
+	{
+		now<steady_point>()
+	};
+
+	if(offloader)
+		return handshake_offload(sock, it, started);
+
 	auto handshake
 	{
-		std::bind(&acceptor::handshake, this, ph::_1, sock, it)
+		std::bind(&acceptor::handshake, this, ph::_1, sock, it, started)
 	};
 
 	sock->set_timeout(milliseconds(timeout));
@@ -696,10 +823,129 @@ ircd::net::acceptor::proffer_default(listener &listener,
 	return true;
 }
 
+/// Continue on the main thread with a connection accepted by an offload
+/// thread; it takes the same path as one accepted here.
+void
+ircd::net::acceptor::accept_offload(const int fd)
+noexcept try
+{
+	assert(offloader);
+	assert(offloader->posted > 0);
+	const unwind posted{[this]
+	{
+		--offloader->posted;
+		joining.notify_all();
+	}};
+
+	if(unlikely(interrupting))
+	{
+		::close(fd);
+		return;
+	}
+
+	const auto sock
+	{
+		std::make_shared<ircd::socket>(ssl)
+	};
+
+	try
+	{
+		sock->sd.assign(ep.protocol(), fd);
+	}
+	catch(...)
+	{
+		::close(fd);
+		throw;
+	}
+
+	++accepting;
+	accept(error_code{}, sock);
+}
+catch(const std::exception &e)
+{
+	log::error
+	{
+		log, "%s acceptor error in accept_offload() :%s",
+		loghead(*this),
+		e.what()
+	};
+}
+
+/// Conduct the handshake on an offload thread. The deadline is kept by a
+/// timer of the handshake state rather than the socket's own; when it
+/// expires the descriptor is shut down, which wakes the blocking handshake
+/// with an error.
+void
+ircd::net::acceptor::handshake_offload(const std::shared_ptr<socket> sock,
+                                       const decltype(handshaking)::const_iterator it,
+                                       const steady_point started)
+{
+	assert(offloader);
+	static ios::descriptor timer_desc
+	{
+		"ircd::net::acceptor offload timeout"
+	};
+
+	const auto state
+	{
+		std::make_shared<offload::handshake>(sock->sd.native_handle())
+	};
+
+	const boost::posix_time::milliseconds pt
+	{
+		milliseconds(timeout).count()
+	};
+
+	state->timer.expires_from_now(pt);
+	state->timer.async_wait(ios::handle(timer_desc, [state]
+	(const error_code &ec)
+	{
+		if(ec || state->done)
+			return;
+
+		state->timedout = true;
+		state->cancel();
+	}));
+
+	offloader->handshakes.emplace(state);
+	(*offloader)([this, sock, it, started, state]
+	{
+		static ios::descriptor desc
+		{
+			"ircd::net::acceptor offload handshake"
+		};
+
+		static const socket::handshake_type handshake_type
+		{
+			socket::handshake_type::server
+		};
+
+		error_code ec;
+		sock->ssl.handshake(handshake_type, ec);
+		ircd::post(desc, [this, sock, it, started, state, ec]
+		{
+			state->done = true;
+			state->timer.cancel();
+			offloader->handshakes.erase(state);
+
+			// A timeout has the same result as on the asynchronous path.
+			const error_code &ec_
+			{
+				ec && state->timedout?
+					make_error_code(boost::system::errc::timed_out):
+					ec
+			};
+
+			handshake(ec_, sock, it, started);
+		});
+	});
+}
+
 void
 ircd::net::acceptor::handshake(const error_code &ec,
                                const std::shared_ptr<socket> sock,
-                               const decltype(handshaking)::const_iterator it)
+                               const decltype(handshaking)::const_iterator it,
+                               const steady_point started)
 noexcept try
 {
 	assert(bool(sock));
@@ -734,6 +980,17 @@ noexcept try
 	sock->cancel_timeout();
 	assert(bool(cb));
 
+	const bool reused
+	{
+		openssl::session_reused(*sock)
+	};
+
+	++handshakes;
+	++handshakes_total;
+	resumed += reused;
+	handshakes_resumed += reused;
+	handshake_latency(duration_cast<microseconds>(now<steady_point>() - started).count());
+
 	// Toggles the behavior of non-async functions; see func comment
 	blocking(*sock, false);
 	cb(*listener_, sock);
@@ -1027,6 +1284,206 @@ catch(...)
 	__builtin_unreachable();
 }
 
+namespace ircd::net
+{
+	static bool ticket_mac_init(acceptor::ticket_mac &, const acceptor::ticket_key &);
+}
+
+int
+ircd::net::acceptor::handle_ticket(SSL &ssl,
+                                   uint8_t *const name,
+                                   uint8_t *const iv,
+                                   EVP_CIPHER_CTX &cipher,
+                                   ticket_mac &hmac,
+                                   const bool enc)
+{
+	assert(ticket_keys);
+	const std::lock_guard lock
+	{
+		ticket_keys_mutex
+	};
+
+	if(enc)
+	{
+		const auto expires
+		{
+			ticket_keys[0].created + seconds(ssl_tickets_rotate).count()
+		};
+
+		if(expires <= ircd::time())
+			rotate_ticket_keys();
+
+		const auto &key(ticket_keys[0]);
+		const mutable_buffer iv_buf
+		{
+			reinterpret_cast<char *>(iv), size_t(EVP_MAX_IV_LENGTH)
+		};
+
+		openssl::rand_bytes(iv_buf);
+		memcpy(name, key.name, sizeof(key.name));
+		if(!EVP_EncryptInit_ex(&cipher, EVP_aes_256_cbc(), nullptr, key.aes, iv))
+			return -1;
+
+		if(!ticket_mac_init(hmac, key))
+			return -1;
+
+		return 1;
+	}
+
+	// Find the key which issued the client's ticket; if it has been rotated
+	// out the client falls back to a full handshake.
+	for(size_t i(0); i < 2; ++i)
+	{
+		const auto &key(ticket_keys[i]);
+		if(!key.created || memcmp(name, key.name, sizeof(key.name)) != 0)
+			continue;
+
+		if(!ticket_mac_init(hmac, key))
+			return -1;
+
+		if(!EVP_DecryptInit_ex(&cipher, EVP_aes_256_cbc(), nullptr, key.aes, iv))
+			return -1;
+
+		// Tickets under the previous key are accepted but renewed.
+		return i == 0? 1 : 2;
+	}
+
+	return 0;
+}
+
+/// Keys the ticket's HMAC-SHA256. OpenSSL 3 deprecates HMAC_CTX; there the
+/// callback is given an EVP_MAC_CTX instead.
+bool
+ircd::net::ticket_mac_init(acceptor::ticket_mac &hmac,
+                           const acceptor::ticket_key &key)
+{
+	#if OPENSSL_VERSION_NUMBER >= 0x30000000L && !defined(LIBRESSL_VERSION_NUMBER)
+	const OSSL_PARAM params[]
+	{
+		OSSL_PARAM_construct_octet_string(OSSL_MAC_PARAM_KEY, const_cast<uint8_t *>(key.hmac), sizeof(key.hmac)),
+		OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, const_cast<char *>("SHA256"), 0),
+		OSSL_PARAM_construct_end(),
+	};
+
+	return EVP_MAC_CTX_set_params(&hmac, params);
+	#else
+	return HMAC_Init_ex(&hmac, key.hmac, sizeof(key.hmac), EVP_sha256(), nullptr);
+	#endif
+}
+
+void
+ircd::net::acceptor::rotate_ticket_keys()
+{
+	assert(ticket_keys);
+	auto &key(ticket_keys[0]);
+	ticket_keys[1] = key;
+	openssl::rand_bytes(mutable_buffer{reinterpret_cast<char *>(key.name), sizeof(key.name)});
+	openssl::rand_bytes(mutable_buffer{reinterpret_cast<char *>(key.aes), sizeof(key.aes)});
+	openssl::rand_bytes(mutable_buffer{reinterpret_cast<char *>(key.hmac), sizeof(key.hmac)});
+	key.created = ircd::time();
+	++tickets_rotated;
+
+	log::debug
+	{
+		log, "%s rotated session ticket key",
+		loghead(*this),
+	};
+}
+
+/// Index of the acceptor instance in the SSL_CTX ex_data for callbacks which
+/// don't provide a user argument.
+static const int
+ircd_net_acceptor_ex_index
+{
+	SSL_CTX_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr)
+};
+
+static int
+ircd_net_acceptor_handle_ticket(SSL *const s,
+                                unsigned char *const name,
+                                unsigned char *const iv,
+                                EVP_CIPHER_CTX *const cipher,
+                                ircd::net::acceptor::ticket_mac *const hmac,
+                                int enc)
+noexcept try
+{
+	if(unlikely(!s || !name || !iv || !cipher || !hmac))
+		throw ircd::panic
+		{
+			"Missing arguments to callback s:%p name:%p iv:%p cipher:%p hmac:%p",
+			s,
+			name,
+			iv,
+			cipher,
+			hmac,
+		};
+
+	auto *const ctx
+	{
+		SSL_get_SSL_CTX(s)
+	};
+
+	auto &acceptor
+	{
+		*reinterpret_cast<ircd::net::acceptor *>(SSL_CTX_get_ex_data(ctx, ircd_net_acceptor_ex_index))
+	};
+
+	return acceptor.handle_ticket(*s, name, iv, *cipher, *hmac, enc);
+}
+catch(const std::exception &e)
+{
+	ircd::log::error
+	{
+		ircd::net::acceptor::log,
+		"Acceptor session ticket callback :%s",
+		e.what(),
+	};
+
+	return -1;
+}
+
+void
+ircd::net::acceptor::configure_sessions(const json::object &opts)
+{
+	auto &ctx
+	{
+		*ssl.native_handle()
+	};
+
+	// Sessions are only resumed by the listener which issued them.
+	const string_view &sid_ctx
+	{
+		name.data(), std::min(name.size(), size_t(SSL_MAX_SID_CTX_LENGTH))
+	};
+
+	SSL_CTX_set_session_id_context(&ctx, reinterpret_cast<const uint8_t *>(sid_ctx.data()), sid_ctx.size());
+	SSL_CTX_set_session_cache_mode(&ctx, SSL_SESS_CACHE_SERVER);
+	SSL_CTX_sess_set_cache_size(&ctx, long(size_t(ssl_session_cache_size)));
+	SSL_CTX_set_timeout(&ctx, long(seconds(ssl_session_timeout).count()));
+
+	if(!opts.get<bool>("ssl_tickets", bool(ssl_tickets)))
+	{
+		ssl.set_options(SSL_OP_NO_TICKET);
+		return;
+	}
+
+	ticket_keys = std::make_unique<ticket_key[]>(2);
+	rotate_ticket_keys();
+
+	SSL_CTX_set_ex_data(&ctx, ircd_net_acceptor_ex_index, this);
+	#if OPENSSL_VERSION_NUMBER >= 0x30000000L && !defined(LIBRESSL_VERSION_NUMBER)
+	SSL_CTX_set_tlsext_ticket_key_evp_cb(&ctx, ircd_net_acceptor_handle_ticket);
+	#else
+	SSL_CTX_set_tlsext_ticket_key_cb(&ctx, ircd_net_acceptor_handle_ticket);
+	#endif
+	log::debug
+	{
+		log, "%s issuing session tickets; key rotation every %ld$s",
+		loghead(*this),
+		seconds(ssl_tickets_rotate).count(),
+	};
+}
+
 void
 ircd::net::acceptor::configure(const json::object &opts)
 {
@@ -1041,6 +1498,7 @@ ircd::net::acceptor::configure(const json::object &opts)
 	configure_ciphers(opts);
 	configure_curves(opts);
 	configure_certs(opts);
+	configure_sessions(opts);
 
 	SSL_CTX_set_alpn_select_cb(ssl.native_handle(), ircd_net_acceptor_handle_alpn, this);
 	SSL_CTX_set_tlsext_servername_callback(ssl.native_handle(), ircd_net_acceptor_handle_sni);
@@ -1299,3 +1757,219 @@ ircd::net::acceptor::configure_password(const json::object &opts)
 		return "foobar";
 	});
 }
+
+//
+// acceptor::offload
+//
+
+ircd::net::acceptor::offload::offload(acceptor &a,
+                                      const size_t &threads,
+                                      const bool &accept)
+:a{a}
+{
+	const unwind_exceptional failed{[this]
+	{
+		close();
+		terminate();
+	}};
+
+	this->threads.reserve(threads);
+	for(size_t i(0); i < threads; ++i)
+		this->threads.emplace_back(&offload::worker, this);
+
+	if(!accept)
+		return;
+
+	this->listeners.reserve(threads);
+	this->accepters.reserve(threads);
+	for(size_t i(0); i < threads; ++i)
+	{
+		const int fd
+		{
+			int(syscall(::socket, a.ep.protocol().family(), SOCK_STREAM | SOCK_CLOEXEC, 0))
+		};
+
+		this->listeners.emplace_back(fd);
+
+		const int one {1};
+		syscall(::setsockopt, fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+		syscall(::setsockopt, fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one));
+		syscall(::bind, fd, a.ep.data(), a.ep.size());
+		syscall(::listen, fd, int(a.backlog));
+		this->accepters.emplace_back(&offload::accepter, this, fd);
+	}
+
+	log::debug
+	{
+		log, "%s accepting on %zu SO_REUSEPORT sockets",
+		loghead(a),
+		this->listeners.size(),
+	};
+}
+
+ircd::net::acceptor::offload::~offload()
+noexcept
+{
+	close();
+	terminate();
+}
+
+/// Join the handshake threads once the jobs remaining have been run.
+void
+ircd::net::acceptor::offload::terminate()
+noexcept
+{
+	{
+		const std::lock_guard lock
+		{
+			mutex
+		};
+
+		termination = true;
+		cond.notify_all();
+	}
+
+	for(auto &thread : threads)
+		thread.join();
+
+	threads.clear();
+}
+
+/// Stop accepting on the offload threads. Shutting down a listening socket
+/// wakes the thread blocked accepting on it.
+void
+ircd::net::acceptor::offload::close()
+noexcept
+{
+	closing = true;
+	for(const auto &fd : listeners)
+		::shutdown(fd, SHUT_RDWR);
+
+	for(auto &thread : accepters)
+		thread.join();
+
+	for(const auto &fd : listeners)
+		::close(fd);
+
+	accepters.clear();
+	listeners.clear();
+}
+
+/// Wake all handshakes in progress on the offload threads.
+void
+ircd::net::acceptor::offload::cancel()
+noexcept
+{
+	for(const auto &handshake : handshakes)
+		handshake->cancel();
+}
+
+void
+ircd::net::acceptor::offload::operator()(job job)
+{
+	const std::lock_guard lock
+	{
+		mutex
+	};
+
+	queue.emplace_back(std::move(job));
+	cond.notify_one();
+}
+
+/// Jobs remaining when terminated are still run; each one posts a result
+/// the main thread is waiting on.
+void
+ircd::net::acceptor::offload::worker()
+noexcept
+{
+	while(1)
+	{
+		std::unique_lock lock
+		{
+			mutex
+		};
+
+		cond.wait(lock, [this]
+		{
+			return termination || !queue.empty();
+		});
+
+		if(queue.empty())
+			return;
+
+		const auto job
+		{
+			std::move(queue.front())
+		};
+
+		queue.pop_front();
+		lock.unlock();
+		job();
+	}
+}
+
+void
+ircd::net::acceptor::offload::accepter(const int fd)
+noexcept
+{
+	static ios::descriptor desc
+	{
+		"ircd::net::acceptor offload accept"
+	};
+
+	while(1)
+	{
+		const int sd
+		{
+			::accept4(fd, nullptr, nullptr, SOCK_CLOEXEC)
+		};
+
+		if(likely(sd >= 0))
+		{
+			++posted;
+			ircd::post(desc, [&a(this->a), sd]
+			{
+				a.accept_offload(sd);
+			});
+
+			continue;
+		}
+
+		const int err(errno);
+		if(err == EINTR || err == ECONNABORTED || err == EPROTO)
+			continue;
+
+		if(closing)
+			return;
+
+		// i.e. out of descriptors; the connection stays queued meanwhile.
+		log::derror
+		{
+			log, "%s offload accept :%s",
+			loghead(a),
+			std::strerror(err),
+		};
+
+		std::this_thread::sleep_for(milliseconds(100));
+	}
+}
+
+//
+// acceptor::offload::handshake
+//
+
+ircd::net::acceptor::offload::handshake::handshake(const int &fd)
+:fd{fd}
+,timer
+{
+	ios::get()
+}
+{
+}
+
+void
+ircd::net::acceptor::offload::handshake::cancel()
+noexcept
+{
+	::shutdown(fd, SHUT_RDWR);
+}
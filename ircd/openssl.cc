@@ -20,6 +20,7 @@
 #include <RB_INC_OPENSSL_RIPEMD_H
 #include <RB_INC_OPENSSL_DH_H
 #include <RB_INC_OPENSSL_TLS1_H
+#include <RB_INC_OPENSSL_RAND_H
 
 // Metaconditions for which OpenSSL API to use. This produces a single #define
 // to simplify further #ifdef's throught this definition file.
@@ -96,6 +97,104 @@ ircd::openssl::server_name(const SSL &ssl)
 	return ::SSL_get_servername(&ssl, type);
 }
 
+//
+// ALPN
+//
+
+void
+ircd::openssl::alpn(SSL &ssl,
+                    const vector_view<const string_view> &protos)
+{
+	// Wire format is each name prefixed by its length in one byte.
+	thread_local char buf[256];
+	window_buffer wb(buf);
+	for(const auto &proto : protos)
+	{
+		assert(size(proto) > 0 && size(proto) < 256);
+		if(unlikely(wb.remaining() < size(proto) + 1))
+			throw error
+			{
+				"Too many ALPN protocols to offer"
+			};
+
+		wb([&proto](const mutable_buffer &out)
+		{
+			out[0] = char(size(proto));
+			return 1 + copy(out + 1, proto);
+		});
+	}
+
+	const auto &list
+	{
+		wb.completed()
+	};
+
+	// Unlike most of the library this returns zero on success.
+	const auto *const ptr(reinterpret_cast<const uint8_t *>(data(list)));
+	if(unlikely(::SSL_set_alpn_protos(&ssl, ptr, size(list)) != 0))
+		throw error
+		{
+			"Failed to set ALPN protocols"
+		};
+}
+
+ircd::string_view
+ircd::openssl::alpn(const SSL &ssl)
+{
+	const uint8_t *data {nullptr};
+	uint len {0};
+	::SSL_get0_alpn_selected(&ssl, &data, &len);
+	return string_view
+	{
+		reinterpret_cast<const char *>(data), len
+	};
+}
+
+//
+// Session
+//
+
+bool
+ircd::openssl::session_reused(const SSL &ssl)
+{
+	return ::SSL_session_reused(const_cast<SSL *>(&ssl));
+}
+
+bool
+ircd::openssl::resumable(const SSL_SESSION &session)
+{
+	#if OPENSSL_VERSION_NUMBER >= 0x10101000L && !defined(LIBRESSL_VERSION_NUMBER)
+	return ::SSL_SESSION_is_resumable(&session);
+	#else
+	return true;
+	#endif
+}
+
+/// Obtain a reference to the session of the connection for resumption by a
+/// later connection. With TLS 1.3 the session is only resumable once the
+/// remote's post-handshake ticket has been received, so the result is null
+/// until then.
+std::shared_ptr<ircd::openssl::SSL_SESSION>
+ircd::openssl::get_session(SSL &ssl)
+{
+	std::shared_ptr<SSL_SESSION> ret
+	{
+		::SSL_get1_session(&ssl), ::SSL_SESSION_free
+	};
+
+	if(ret && !resumable(*ret))
+		ret.reset();
+
+	return ret;
+}
+
+void
+ircd::openssl::set_session(SSL &ssl,
+                           SSL_SESSION &session)
+{
+	call(::SSL_set_session, &ssl, &session);
+}
+
 //
 // Cipher suite
 //
@@ -1281,6 +1380,18 @@ ircd::openssl::read_pem_pub(EVP_PKEY &out_,
 // lib generale
 //
 
+ircd::const_buffer
+ircd::openssl::rand_bytes(const mutable_buffer &out)
+{
+	auto *const data
+	{
+		reinterpret_cast<uint8_t *>(ircd::data(out))
+	};
+
+	call(::RAND_bytes, data, int(size(out)));
+	return out;
+}
+
 void
 ircd::openssl::clear_error()
 {
@@ -23,6 +23,68 @@ decltype(ircd::resource::resources)
 ircd::resource::resources
 {};
 
+/// Space-separated list of path prefixes served when running as a secondary
+/// instance (see ircd::secondary). A bare path allows GET, HEAD and OPTIONS;
+/// a path prefixed by a method and a colon (i.e POST:/path) allows only that
+/// method. Other requests are answered with 421 so the load balancer can
+/// retry them at the primary.
+decltype(ircd::resource::secondary_allow)
+ircd::resource::secondary_allow
+{
+	{ "name", "ircd.resource.secondary.allow" },
+	{ "default",
+		"/_matrix/client/versions"
+		" /_matrix/client/r0/rooms"
+		" /_matrix/client/r0/publicRooms"
+		" POST:/_matrix/client/r0/publicRooms"
+		" /_matrix/client/r0/profile"
+		" /_matrix/federation/v1/backfill"
+		" /_matrix/federation/v1/state"
+		" /_matrix/federation/v1/event"
+		" /_matrix/federation/v1/publicRooms"
+		" POST:/_matrix/federation/v1/publicRooms"
+	},
+};
+
+bool
+ircd::resource::allowed(const string_view &method,
+                        const string_view &path)
+{
+	if(likely(!ircd::secondary))
+		return true;
+
+	const bool safe
+	{
+		method == "GET" || method == "HEAD" || method == "OPTIONS"
+	};
+
+	const string_view &list
+	{
+		secondary_allow
+	};
+
+	return !tokens(list, ' ', token_view_bool{[&method, &path, &safe]
+	(const string_view &entry)
+	{
+		const auto &[entry_method, entry_path]
+		{
+			startswith(entry, '/')?
+				std::make_pair(string_view{}, entry):
+				split(entry, ':')
+		};
+
+		const bool method_match
+		{
+			entry_method?
+				entry_method == method:
+				safe
+		};
+
+		// false to break when matched
+		return !method_match || !startswith(path, entry_path);
+	}});
+}
+
 ircd::resource &
 ircd::resource::find(const string_view &path_)
 {
@@ -429,6 +491,19 @@ try
 		stats->pending
 	};
 
+	const ircd::timer timer;
+	const unwind latency{[this, &timer]
+	{
+		stats->latency(timer.at<microseconds>().count());
+	}};
+
+	// A secondary instance only serves the configured subset of resources.
+	if(unlikely(!resource::allowed(head.method, head.path)))
+		throw http::error
+		{
+			http::MISDIRECTED_REQUEST
+		};
+
 	// Bail out if the method limited the amount of content and it was exceeded.
 	if(head.content_length > opts->payload_max)
 		throw http::error
@@ -659,6 +659,30 @@ ircd::server::peer::link_max_default
 	{ "default",  4L                          }
 };
 
+/// Whether to retain the TLS session of a link for resumption by the next
+/// link opened to the same peer.
+decltype(ircd::server::peer::session_resume)
+ircd::server::peer::session_resume
+{
+	{ "name",     "ircd.server.peer.session_resume" },
+	{ "default",  true                              }
+};
+
+/// Whether to offer HTTP/2 to the remote with ALPN. Links on which the remote
+/// selects it multiplex their tags over streams instead of pipelining.
+decltype(ircd::server::peer::enable_http2)
+ircd::server::peer::enable_http2
+{
+	{ "name",     "ircd.server.peer.enable_http2" },
+	{ "default",  false                           }
+};
+
+decltype(ircd::server::peer::alpn_protocols)
+ircd::server::peer::alpn_protocols
+{
+	"h2", "http/1.1"
+};
+
 decltype(ircd::server::peer::ids)
 ircd::server::peer::ids;
 
@@ -693,6 +717,10 @@ ircd::server::peer::peer(const net::hostport &hostport,
 	// Cert verify this name.
 	this->open_opts.common_name = host(canon);
 
+	// Offer HTTP/2 and fall back to HTTP/1.1 when the remote doesn't select it.
+	if(enable_http2)
+		this->open_opts.alpn = alpn_protocols;
+
 	if(rfc3986::valid(std::nothrow, rfc3986::parser::ip_address, host(canon)))
 		this->remote =
 		{
@@ -1004,6 +1032,12 @@ ircd::server::peer::handle_open(link &link,
 		link.close(net::dc::RST);
 		return;
 	}
+
+	// The session offered in the handshake was not accepted by the remote;
+	// it is discarded so the first response on this link replaces it.
+	if(open_opts.session && link.socket)
+		if(!openssl::session_reused(static_cast<const openssl::SSL &>(*link.socket)))
+			open_opts.session.reset();
 }
 
 void
@@ -1137,6 +1171,9 @@ noexcept try
 		};
 	}
 
+	if(!open_opts.session)
+		save_session(link);
+
 	if(link.tag_committed() >= link.tag_commit_max())
 		link.wait_writable();
 }
@@ -1151,6 +1188,32 @@ catch(const std::exception &e)
 	};
 }
 
+/// Retains the TLS session of the link (after the remote has issued one) so
+/// later links opened to this peer can resume it and skip the full handshake.
+/// The session is dropped when a resumption is refused so the next response
+/// can replace it.
+void
+ircd::server::peer::save_session(const link &link)
+{
+	if(!session_resume || !link.socket)
+		return;
+
+	auto &ssl
+	{
+		static_cast<openssl::SSL &>(*link.socket)
+	};
+
+	open_opts.session = openssl::get_session(ssl);
+	if(!open_opts.session)
+		return;
+
+	log::debug
+	{
+		log, "%s saved session for resumption",
+		loghead(link),
+	};
+}
+
 /// This is where we're notified a link has processed its queue and has no
 /// more work. We can choose whether to close the link or keep it open and
 /// reinstate the read poll; reschedule other work to this link, etc.
@@ -1810,6 +1873,24 @@ ircd::server::link::tag_commit_max_default
 	{ "default",  3L                                }
 };
 
+/// Upper bound on the streams of an HTTP/2 link; the remote's
+/// MAX_CONCURRENT_STREAMS is also honored.
+decltype(ircd::server::link::http2_streams_max)
+ircd::server::link::http2_streams_max
+{
+	{ "name",     "ircd.server.link.http2.streams_max" },
+	{ "default",  100L                                 },
+};
+
+/// Receive window of each HTTP/2 stream. The window of the connection is
+/// this multiplied by streams_max.
+decltype(ircd::server::link::http2_window)
+ircd::server::link::http2_window
+{
+	{ "name",     "ircd.server.link.http2.window" },
+	{ "default",  long(1_MiB)                     },
+};
+
 decltype(ircd::server::link::ids)
 ircd::server::link::ids;
 
@@ -1855,6 +1936,83 @@ ircd::server::loghead(const mutable_buffer &buf,
 	};
 }
 
+/// Connection state of a link on which the remote selected HTTP/2 with ALPN.
+/// Each committed tag is carried by its own stream. The HTTP/1.1 head composed
+/// by the user is translated into a HEADERS frame; the response HEADERS are
+/// translated back into an HTTP/1.1 head, using chunked encoding when there is
+/// no content-length, and fed to the tag with the DATA. The tag's state machine
+/// is thus the same for both protocols.
+struct ircd::server::link::h2
+{
+	struct stream
+	{
+		uint64_t tag {0};                        // tag::state::id
+		int64_t window {0};                      // send window
+		size_t unacked {0};                      // received; not yet updated
+		bool head {false};                       // response head fed to tag
+		bool chunked {false};                    // content fed chunk encoded
+	};
+
+	using header = http2::frame::header;
+	using code = http2::frame::settings::code;
+	using streams_type = std::map<uint32_t, stream>;
+
+	static constexpr const size_t out_max {64_KiB};
+	static constexpr const size_t block_max {256_KiB};
+
+	server::link *link;
+	http2::settings local;
+	http2::settings remote;
+	http2::hpack::table table;
+	streams_type streams;
+	uint32_t next_id {1};
+	int64_t window {65535};                      // connection send window
+	size_t window_local {65535};                 // connection receive window
+	size_t unacked {0};                          // connection received; not updated
+	bool goaway {false};
+	uint32_t continuing {0};                     // stream awaiting CONTINUATION
+	bool continuing_end {false};                 // END_STREAM of that HEADERS
+	std::string block;                           // header block being continued
+	std::string out;                             // frames not yet written
+	std::array<char, sizeof(header) + 16_KiB> in;
+	size_t in_len {0};
+
+	static uint32_t get(const const_buffer &, const size_t &off, const size_t &len = 4);
+	static void put(char *const &, const uint32_t &, const size_t &len = 4);
+	static const_buffer unpadded(const header &, const const_buffer &);
+
+	tag *find(const uint64_t &tag_id);
+	streams_type::iterator find(const tag &);
+	void erase(const tag &);
+
+	void compose(const header &, const const_buffer &payload = {});
+	void update(const uint32_t &id, const size_t &increment);
+	void reset(const uint32_t &id, const enum http2::error::code &);
+
+	void feed(tag &, const const_buffer &, bool &done);
+	bool fail(streams_type::iterator, tag &, std::exception_ptr, const bool &send_reset);
+	bool finish(streams_type::iterator, tag &, const bool &done, const bool &end_stream);
+
+	bool handle_head(const uint32_t &id, const const_buffer &block, const bool &end_stream);
+	bool handle_data(const header &, const const_buffer &);
+	bool handle_headers(const header &, const const_buffer &);
+	bool handle_continuation(const header &, const const_buffer &);
+	bool handle_rst_stream(const header &, const const_buffer &);
+	void handle_settings(const header &, const const_buffer &);
+	void handle_ping(const header &, const const_buffer &);
+	bool handle_goaway(const header &, const const_buffer &);
+	void handle_window_update(const header &, const const_buffer &);
+	bool handle_frame(const header &, const const_buffer &);
+	void handle_readable();
+
+	void send_data(tag &, const uint32_t &id, stream &);
+	void send_head(tag &);
+	bool flush();
+	void handle_writable();
+
+	h2(server::link &);
+};
+
 //
 // link::link
 //
@@ -1897,6 +2055,9 @@ ircd::server::link::submit(request &request)
 void
 ircd::server::link::cancel_all(std::exception_ptr eptr)
 {
+	if(h2)
+		h2->streams.clear();
+
 	for(auto it(begin(queue)); it != end(queue); it = queue.erase(it))
 	{
 		auto &tag{*it};
@@ -1910,6 +2071,10 @@ ircd::server::link::cancel_all(std::exception_ptr eptr)
 void
 ircd::server::link::cancel_committed(std::exception_ptr eptr)
 {
+	// Streams only exist for committed tags.
+	if(h2)
+		h2->streams.clear();
+
 	for(auto it(begin(queue)); it != end(queue); it = queue.erase(it))
 	{
 		auto &tag{*it};
@@ -1971,6 +2136,17 @@ ircd::server::link::cleanup_canceled()
 	// to quickly disperse any queued tags to another link or simply kill this
 	// link if it's timing out.
 	assert(dead <= tag_committed());
+
+	// Canceled streams are reset by the write pass instead; the other streams
+	// on the link are unaffected.
+	if(dead && h2)
+	{
+		if(ready())
+			wait_writable();
+
+		return;
+	}
+
 	if(dead && dead == tag_committed())
 	{
 		log::dwarning
@@ -2026,7 +2202,22 @@ ircd::server::link::handle_open(std::exception_ptr eptr)
 	synack_ts = time<seconds>();
 
 	if(!eptr && !op_fini)
+	{
+		const auto &ssl
+		{
+			static_cast<const openssl::SSL &>(*socket)
+		};
+
+		// The remote selected HTTP/2; the connection is read regardless of
+		// any tags to service the remote's SETTINGS and other frames.
+		if(openssl::alpn(ssl) == "h2")
+		{
+			h2 = std::make_unique<struct h2>(*this);
+			wait_readable();
+		}
+
 		wait_writable();
+	}
 
 	if(peer)
 		peer->handle_open(*this, std::move(eptr));
@@ -2141,6 +2332,9 @@ void
 ircd::server::link::handle_writable_success()
 {
 	assert(socket);
+	if(h2)
+		return h2->handle_writable();
+
 	auto it(begin(queue));
 	while(it != end(queue))
 	{
@@ -2329,6 +2523,9 @@ void
 ircd::server::link::handle_readable_success()
 {
 	assert(socket);
+	if(h2)
+		return h2->handle_readable();
+
 	if(!tag_committed())
 	{
 		discard_read();
@@ -2681,6 +2878,13 @@ size_t
 ircd::server::link::tag_commit_max()
 const
 {
+	if(h2)
+		return std::min
+		(
+			size_t(http2_streams_max),
+			size_t(h2->remote[http2::frame::settings::code::MAX_CONCURRENT_STREAMS])
+		);
+
 	return tag_commit_max_default;
 }
 
@@ -2703,6 +2907,1180 @@ const
 	});
 }
 
+//
+// link::h2
+//
+
+ircd::server::link::h2::h2(server::link &link)
+:link{&link}
+{
+	static const size_t window_max
+	{
+		0x7fffffffUL
+	};
+
+	// No limit is assumed until the remote's SETTINGS arrive.
+	remote[code::MAX_CONCURRENT_STREAMS] = std::numeric_limits<uint32_t>::max();
+
+	local[code::ENABLE_PUSH] = 0;
+	local[code::INITIAL_WINDOW_SIZE] = std::min(size_t(http2_window), window_max);
+	window_local = std::min(size_t(http2_window) * size_t(http2_streams_max), window_max);
+
+	char param[2][6];
+	put(param[0] + 0, code::ENABLE_PUSH, 2);
+	put(param[0] + 2, local[code::ENABLE_PUSH]);
+	put(param[1] + 0, code::INITIAL_WINDOW_SIZE, 2);
+	put(param[1] + 2, local[code::INITIAL_WINDOW_SIZE]);
+
+	out.append(http2::connection_preface);
+	compose(header{sizeof(param), http2::frame::SETTINGS}, const_buffer
+	{
+		param[0], sizeof(param)
+	});
+
+	if(window_local > 65535)
+		update(0, window_local - 65535);
+}
+
+void
+ircd::server::link::h2::handle_writable()
+{
+	if(!flush())
+	{
+		link->wait_writable();
+		return;
+	}
+
+	auto &queue(link->queue);
+	for(auto it(begin(queue)); it != end(queue) && size(out) < out_max; )
+	{
+		auto &tag{*it};
+		if(!tag.committed())
+		{
+			if(tag.abandoned() || tag.canceled() || !tag.request)
+			{
+				it = queue.erase(it);
+				continue;
+			}
+
+			if(goaway || streams.size() >= link->tag_commit_max())
+				break;
+
+			try
+			{
+				send_head(tag);
+			}
+			catch(const std::exception &e)
+			{
+				tag.set_exception(std::current_exception());
+				it = queue.erase(it);
+				continue;
+			}
+		}
+
+		const auto sit
+		{
+			find(tag)
+		};
+
+		// The user has canceled a request on the wire; only its stream is
+		// reset rather than the whole connection as with HTTP/1.1.
+		if(tag.canceled())
+		{
+			if(sit != end(streams))
+			{
+				reset(sit->first, http2::error::CANCEL);
+				streams.erase(sit);
+			}
+
+			it = queue.erase(it);
+			continue;
+		}
+
+		if(sit != end(streams))
+			send_data(tag, sit->first, sit->second);
+
+		++it;
+	}
+
+	if(!flush())
+		link->wait_writable();
+}
+
+bool
+ircd::server::link::h2::flush()
+{
+	if(out.empty())
+		return true;
+
+	const const_buffer written
+	{
+		link->process_write_next(const_buffer
+		{
+			out.data(), out.size()
+		})
+	};
+
+	out.erase(0, size(written));
+	return out.empty();
+}
+
+void
+ircd::server::link::h2::send_head(tag &tag)
+{
+	assert(tag.request);
+	assert(!tag.committed());
+	const auto &req
+	{
+		*tag.request
+	};
+
+	parse::buffer pb{req.out.head};
+	parse::capstan pc{pb, [](char *&read, char *stop)
+	{
+		read = stop;
+	}};
+
+	std::vector<http::header> headers;
+	pc.read += size(req.out.head);
+	const http::request::head head
+	{
+		pc, [&headers](const auto &header)
+		{
+			headers.emplace_back(header);
+		}
+	};
+
+	thread_local char buf[16_KiB];
+	size_t len(0);
+	const auto field{[&len]
+	(const string_view &name, const string_view &value)
+	{
+		len += size(http2::hpack::encode(mutable_buffer{buf + len, sizeof(buf) - len}, name, value));
+	}};
+
+	field(":method", head.method);
+	field(":scheme", "https");
+	if(head.host)
+		field(":authority", head.host);
+
+	field(":path", head.uri);
+	for(const auto &[name, value] : headers)
+	{
+		// Connection-specific fields are not allowed (RFC 7540 8.1.2.2)
+		if(iequals(name, "host") ||
+		   iequals(name, "connection") ||
+		   iequals(name, "keep-alive") ||
+		   iequals(name, "proxy-connection") ||
+		   iequals(name, "transfer-encoding") ||
+		   iequals(name, "upgrade") ||
+		   iequals(name, "te"))
+			continue;
+
+		char lower[128];
+		if(unlikely(size(name) > sizeof(lower)))
+			throw error
+			{
+				"Request header name too long (%zu)", size(name)
+			};
+
+		field(tolower(lower, name), value);
+	}
+
+	const uint32_t id
+	{
+		next_id
+	};
+
+	// Stream identifiers can't be reused; the link is retired before they
+	// are exhausted.
+	next_id += 2;
+	if(unlikely(next_id >= 0x7fffffffU))
+		link->exclude = true;
+
+	const bool end_stream
+	{
+		empty(req.out.content)
+	};
+
+	const size_t frame_max
+	{
+		remote[code::MAX_FRAME_SIZE]
+	};
+
+	auto type(http2::frame::HEADERS);
+	const_buffer block{buf, len}; do
+	{
+		const const_buffer fragment
+		{
+			data(block), std::min(size(block), frame_max)
+		};
+
+		block = const_buffer
+		{
+			data(block) + size(fragment), size(block) - size(fragment)
+		};
+
+		const uint8_t flags
+		(
+			(empty(block)? http2::frame::END_HEADERS: 0) |
+			(end_stream && type == http2::frame::HEADERS? http2::frame::END_STREAM: 0)
+		);
+
+		compose(header{uint32_t(size(fragment)), type, flags, id}, fragment);
+		type = http2::frame::CONTINUATION;
+	}
+	while(!empty(block));
+
+	streams.emplace(id, stream
+	{
+		tag.state.id, remote[code::INITIAL_WINDOW_SIZE]
+	});
+
+	tag.wrote_buffer(req.out.head);
+
+	log::debug
+	{
+		log, "%s starting on tag:%lu stream:%u %zu of %zu: wt:%zu [%s]",
+		loghead(*link),
+		tag.state.id,
+		id,
+		streams.size(),
+		link->tag_count(),
+		tag.write_size(),
+		loghead(req),
+	};
+}
+
+void
+ircd::server::link::h2::send_data(tag &tag,
+                                  const uint32_t &id,
+                                  stream &stream)
+{
+	const int64_t frame_max
+	{
+		remote[code::MAX_FRAME_SIZE]
+	};
+
+	while(tag.write_remaining() && size(out) < out_max)
+	{
+		const const_buffer buffer
+		{
+			tag.make_write_buffer()
+		};
+
+		const int64_t len
+		{
+			std::min({stream.window, window, frame_max, int64_t(size(buffer))})
+		};
+
+		// Blocked by flow control until the remote sends a WINDOW_UPDATE.
+		if(len <= 0)
+			break;
+
+		const const_buffer content
+		{
+			data(buffer), size_t(len)
+		};
+
+		const bool end_stream
+		{
+			size(content) == tag.write_remaining()
+		};
+
+		compose(header
+		{
+			uint32_t(len), http2::frame::DATA, end_stream? http2::frame::END_STREAM: 0, id
+		},
+		content);
+
+		stream.window -= len;
+		window -= len;
+		tag.wrote_buffer(content);
+	}
+}
+
+void
+ircd::server::link::h2::handle_readable()
+try
+{
+	size_t finished(0);
+	while(!link->op_fini)
+	{
+		assert(in_len < in.size());
+		const const_buffer received
+		{
+			link->read(mutable_buffer
+			{
+				in.data() + in_len, in.size() - in_len
+			})
+		};
+
+		if(empty(received))
+			break;
+
+		size_t off(0);
+		in_len += size(received);
+		while(in_len - off >= sizeof(header) && !link->op_fini)
+		{
+			const header head
+			{
+				const_buffer{in.data() + off, sizeof(header)}
+			};
+
+			if(unlikely(head.len > local[code::MAX_FRAME_SIZE]))
+				throw http2::error
+				{
+					http2::error::FRAME_SIZE_ERROR, "%s frame of %u bytes exceeds %u",
+					http2::frame::reflect(head.type),
+					uint(head.len),
+					local[code::MAX_FRAME_SIZE],
+				};
+
+			if(in_len - off < sizeof(header) + head.len)
+				break;
+
+			const const_buffer payload
+			{
+				in.data() + off + sizeof(header), head.len
+			};
+
+			finished += handle_frame(head, payload);
+			off += sizeof(header) + head.len;
+		}
+
+		std::memmove(in.data(), in.data() + off, in_len - off);
+		in_len -= off;
+	}
+
+	if(link->op_fini)
+		return;
+
+	if(goaway && link->queue.empty())
+	{
+		link->close();
+		return;
+	}
+
+	// Windows may have opened and replies to the remote may be pending.
+	if(!out.empty() || !link->queue.empty())
+		link->wait_writable();
+
+	if(finished && link->queue.empty())
+	{
+		assert(link->peer);
+		link->peer->handle_link_done(*link);
+		return;
+	}
+
+	link->wait_readable();
+}
+catch(const http2::error &e)
+{
+	// Later links to this peer won't offer HTTP/2 after the remote got it wrong.
+	assert(link->peer);
+	link->peer->open_opts.alpn = {};
+	throw;
+}
+
+bool
+ircd::server::link::h2::handle_frame(const header &head,
+                                     const const_buffer &payload)
+{
+	if(unlikely(continuing && head.type != http2::frame::CONTINUATION))
+		throw http2::error
+		{
+			http2::error::PROTOCOL_ERROR, "expected CONTINUATION of stream %u; got %s",
+			continuing,
+			http2::frame::reflect(head.type),
+		};
+
+	switch(head.type)
+	{
+		case http2::frame::DATA:
+			return handle_data(head, payload);
+
+		case http2::frame::HEADERS:
+			return handle_headers(head, payload);
+
+		case http2::frame::CONTINUATION:
+			return handle_continuation(head, payload);
+
+		case http2::frame::RST_STREAM:
+			return handle_rst_stream(head, payload);
+
+		case http2::frame::SETTINGS:
+			handle_settings(head, payload);
+			return false;
+
+		case http2::frame::PING:
+			handle_ping(head, payload);
+			return false;
+
+		case http2::frame::GOAWAY:
+			return handle_goaway(head, payload);
+
+		case http2::frame::WINDOW_UPDATE:
+			handle_window_update(head, payload);
+			return false;
+
+		case http2::frame::PUSH_PROMISE:
+			throw http2::error
+			{
+				http2::error::PROTOCOL_ERROR, "PUSH_PROMISE received with push disabled"
+			};
+
+		// Priority is advisory; unknown types are ignored (RFC 7540 4.1).
+		case http2::frame::PRIORITY:
+		default:
+			return false;
+	}
+}
+
+bool
+ircd::server::link::h2::handle_data(const header &head,
+                                    const const_buffer &payload)
+{
+	if(unlikely(!head.stream_id))
+		throw http2::error
+		{
+			http2::error::PROTOCOL_ERROR, "DATA on stream 0"
+		};
+
+	// The whole frame counts against flow control, including padding, even
+	// when the stream is no longer of interest.
+	unacked += head.len;
+	if(unacked >= window_local / 2)
+	{
+		update(0, unacked);
+		unacked = 0;
+	}
+
+	const auto it
+	{
+		streams.find(head.stream_id)
+	};
+
+	if(it == end(streams))
+		return false;
+
+	auto &[id, stream] {*it};
+	const bool end_stream
+	{
+		head.flags & http2::frame::END_STREAM
+	};
+
+	stream.unacked += head.len;
+	if(!end_stream && stream.unacked >= local[code::INITIAL_WINDOW_SIZE] / 2)
+	{
+		update(id, stream.unacked);
+		stream.unacked = 0;
+	}
+
+	auto *const tag
+	{
+		find(stream.tag)
+	};
+
+	if(!tag)
+	{
+		reset(id, http2::error::CANCEL);
+		streams.erase(it);
+		return false;
+	}
+
+	bool done {false}; try
+	{
+		if(unlikely(!stream.head))
+			throw http2::error
+			{
+				http2::error::PROTOCOL_ERROR, "DATA on stream %u before HEADERS", id
+			};
+
+		const const_buffer content
+		{
+			unpadded(head, payload)
+		};
+
+		if(stream.chunked && !empty(content))
+		{
+			char chunk_head[24];
+			const string_view chunk_line
+			{
+				fmt::sprintf
+				{
+					chunk_head, "%lx\r\n", ulong(size(content))
+				}
+			};
+
+			feed(*tag, chunk_line, done);
+			feed(*tag, content, done);
+			feed(*tag, "\r\n"_sv, done);
+		}
+		else feed(*tag, content, done);
+
+		if(stream.chunked && end_stream)
+			feed(*tag, "0\r\n\r\n"_sv, done);
+	}
+	catch(const std::exception &e)
+	{
+		return fail(it, *tag, std::current_exception(), true);
+	}
+
+	return finish(it, *tag, done, end_stream);
+}
+
+bool
+ircd::server::link::h2::handle_headers(const header &head,
+                                       const const_buffer &payload)
+{
+	if(unlikely(!head.stream_id))
+		throw http2::error
+		{
+			http2::error::PROTOCOL_ERROR, "HEADERS on stream 0"
+		};
+
+	const_buffer fragment
+	{
+		unpadded(head, payload)
+	};
+
+	if(head.flags & http2::frame::PRIORITIZED)
+	{
+		if(unlikely(size(fragment) < 5))
+			throw http2::error
+			{
+				http2::error::FRAME_SIZE_ERROR, "HEADERS priority truncated"
+			};
+
+		fragment = const_buffer
+		{
+			data(fragment) + 5, size(fragment) - 5
+		};
+	}
+
+	const bool end_stream
+	{
+		head.flags & http2::frame::END_STREAM
+	};
+
+	if(head.flags & http2::frame::END_HEADERS)
+		return handle_head(head.stream_id, fragment, end_stream);
+
+	continuing = head.stream_id;
+	continuing_end = end_stream;
+	block.assign(data(fragment), size(fragment));
+	return false;
+}
+
+bool
+ircd::server::link::h2::handle_continuation(const header &head,
+                                            const const_buffer &payload)
+{
+	if(unlikely(!continuing || head.stream_id != continuing))
+		throw http2::error
+		{
+			http2::error::PROTOCOL_ERROR, "unexpected CONTINUATION on stream %u",
+			uint(head.stream_id),
+		};
+
+	if(unlikely(size(block) + size(payload) > block_max))
+		throw http2::error
+		{
+			http2::error::ENHANCE_YOUR_CALM, "header block on stream %u exceeds %zu bytes",
+			continuing,
+			block_max,
+		};
+
+	block.append(data(payload), size(payload));
+	if(!(head.flags & http2::frame::END_HEADERS))
+		return false;
+
+	const std::string block
+	{
+		std::move(this->block)
+	};
+
+	const auto id(continuing);
+	continuing = 0;
+	this->block.clear();
+	return handle_head(id, const_buffer{block.data(), block.size()}, continuing_end);
+}
+
+/// The block is always decoded, even for streams no longer of interest, to
+/// keep the decoder's table synchronized with the remote.
+bool
+ircd::server::link::h2::handle_head(const uint32_t &id,
+                                    const const_buffer &block,
+                                    const bool &end_stream)
+{
+	thread_local char scratch[16_KiB], buf[16_KiB];
+	size_t len(0);
+	bool malformed {false}, has_length {false};
+	http::code status {(http::code)0};
+	const auto append{[&len, &malformed]
+	(const string_view &str)
+	{
+		if(unlikely(len + size(str) > sizeof(buf)))
+		{
+			malformed = true;
+			return;
+		}
+
+		len += copy(mutable_buffer{buf + len, sizeof(buf) - len}, str);
+	}};
+
+	http2::hpack::decode(table, block, scratch, [&]
+	(const string_view &name, const string_view &value)
+	{
+		if(startswith(name, ':'))
+		{
+			// Other pseudo-headers are not expected in a response.
+			if(name != ":status")
+				return;
+
+			if(len)
+			{
+				malformed = true;
+				return;
+			}
+
+			try
+			{
+				status = http::status(value);
+			}
+			catch(const std::exception &e)
+			{
+				malformed = true;
+				return;
+			}
+
+			const string_view reason
+			{
+				http::status(status)
+			};
+
+			append("HTTP/1.1 ");
+			append(value);
+			append(" ");
+			append(reason?: "Unknown"_sv);
+			append("\r\n");
+			return;
+		}
+
+		if(!len || has(value, '\r') || has(value, '\n'))
+		{
+			malformed = true;
+			return;
+		}
+
+		if(name == "connection" || name == "transfer-encoding")
+			return;
+
+		has_length |= name == "content-length";
+		append(name);
+		append(": ");
+		append(value);
+		append("\r\n");
+	});
+
+	const auto it
+	{
+		streams.find(id)
+	};
+
+	if(it == end(streams))
+		return false;
+
+	auto &stream
+	{
+		it->second
+	};
+
+	auto *const tag
+	{
+		find(stream.tag)
+	};
+
+	if(!tag)
+	{
+		reset(id, http2::error::CANCEL);
+		streams.erase(it);
+		return false;
+	}
+
+	bool done {false}; try
+	{
+		// Trailers; they are not conveyed to the user.
+		if(stream.head)
+		{
+			if(unlikely(!end_stream))
+				throw http2::error
+				{
+					http2::error::PROTOCOL_ERROR, "trailers on stream %u without END_STREAM", id
+				};
+
+			if(stream.chunked)
+				feed(*tag, "0\r\n\r\n"_sv, done);
+
+			return finish(it, *tag, done, end_stream);
+		}
+
+		if(unlikely(malformed || !status))
+			throw http2::error
+			{
+				http2::error::PROTOCOL_ERROR, "malformed response head on stream %u", id
+			};
+
+		// Informational responses precede the final response.
+		if(uint(status) >= 100 && uint(status) < 200)
+			return false;
+
+		if(!has_length && end_stream)
+			append("content-length: 0\r\n");
+		else if(!has_length)
+			append("transfer-encoding: chunked\r\n");
+
+		append("\r\n");
+		if(unlikely(malformed))
+			throw http2::error
+			{
+				http2::error::INTERNAL_ERROR, "response head on stream %u too large", id
+			};
+
+		stream.head = true;
+		stream.chunked = !has_length && !end_stream;
+		feed(*tag, const_buffer{buf, len}, done);
+	}
+	catch(const std::exception &e)
+	{
+		return fail(it, *tag, std::current_exception(), true);
+	}
+
+	return finish(it, *tag, done, end_stream);
+}
+
+bool
+ircd::server::link::h2::handle_rst_stream(const header &head,
+                                          const const_buffer &payload)
+{
+	if(unlikely(!head.stream_id || size(payload) != 4))
+		throw http2::error
+		{
+			http2::error::PROTOCOL_ERROR, "malformed RST_STREAM"
+		};
+
+	const auto it
+	{
+		streams.find(head.stream_id)
+	};
+
+	if(it == end(streams))
+		return false;
+
+	auto *const tag
+	{
+		find(it->second.tag)
+	};
+
+	if(!tag)
+	{
+		streams.erase(it);
+		return false;
+	}
+
+	const auto code
+	{
+		(enum http2::error::code)get(payload, 0)
+	};
+
+	return fail(it, *tag, make_exception_ptr<http2::error>
+	(
+		code, "stream %u reset by remote", uint(head.stream_id)
+	),
+	false);
+}
+
+void
+ircd::server::link::h2::handle_settings(const header &head,
+                                        const const_buffer &payload)
+{
+	if(unlikely(head.stream_id))
+		throw http2::error
+		{
+			http2::error::PROTOCOL_ERROR, "SETTINGS on stream %u", uint(head.stream_id)
+		};
+
+	if(head.flags & http2::frame::ACK)
+	{
+		if(unlikely(head.len))
+			throw http2::error
+			{
+				http2::error::FRAME_SIZE_ERROR, "SETTINGS ACK with payload"
+			};
+
+		return;
+	}
+
+	if(unlikely(head.len % 6))
+		throw http2::error
+		{
+			http2::error::FRAME_SIZE_ERROR, "SETTINGS of %u bytes", uint(head.len)
+		};
+
+	for(size_t off(0); off < size(payload); off += 6)
+	{
+		const uint16_t id
+		(
+			get(payload, off, 2)
+		);
+
+		const uint32_t value
+		{
+			get(payload, off + 2)
+		};
+
+		// Unknown settings are ignored (RFC 7540 6.5.2)
+		if(!id || id >= code::_NUM_)
+			continue;
+
+		switch(code(id))
+		{
+			// The change applies to the windows of all open streams.
+			case code::INITIAL_WINDOW_SIZE:
+				if(unlikely(value > 0x7fffffffU))
+					throw http2::error
+					{
+						http2::error::FLOW_CONTROL_ERROR, "INITIAL_WINDOW_SIZE %u", value
+					};
+
+				for(auto &it : streams)
+					it.second.window += int64_t(value) - remote[code::INITIAL_WINDOW_SIZE];
+
+				break;
+
+			case code::MAX_FRAME_SIZE:
+				if(unlikely(value < 16_KiB || value > 0xffffffU))
+					throw http2::error
+					{
+						http2::error::PROTOCOL_ERROR, "MAX_FRAME_SIZE %u", value
+					};
+
+				break;
+
+			default:
+				break;
+		}
+
+		remote[code(id)] = value;
+	}
+
+	compose(header{0, http2::frame::SETTINGS, http2::frame::ACK});
+}
+
+void
+ircd::server::link::h2::handle_ping(const header &head,
+                                    const const_buffer &payload)
+{
+	if(unlikely(head.stream_id || size(payload) != 8))
+		throw http2::error
+		{
+			http2::error::PROTOCOL_ERROR, "malformed PING"
+		};
+
+	if(~head.flags & http2::frame::ACK)
+		compose(header{8, http2::frame::PING, http2::frame::ACK}, payload);
+}
+
+bool
+ircd::server::link::h2::handle_goaway(const header &head,
+                                      const const_buffer &payload)
+{
+	if(unlikely(head.stream_id || size(payload) < 8))
+		throw http2::error
+		{
+			http2::error::PROTOCOL_ERROR, "malformed GOAWAY"
+		};
+
+	const uint32_t last
+	{
+		get(payload, 0) & 0x7fffffffU
+	};
+
+	const auto code
+	{
+		(enum http2::error::code)get(payload, 4)
+	};
+
+	log::logf
+	{
+		log, code? log::DERROR: log::DEBUG,
+		"%s GOAWAY last_stream:%u streams:%zu :%s",
+		loghead(*link),
+		last,
+		streams.size(),
+		http2::reflect(code),
+	};
+
+	goaway = true;
+	link->exclude = true;
+
+	// Streams after the last one were not processed by the remote; their
+	// tags are uncommitted and dispersed to other links.
+	for(auto it(streams.upper_bound(last)); it != end(streams); it = streams.erase(it))
+	{
+		auto *const tag
+		{
+			find(it->second.tag)
+		};
+
+		if(!tag)
+			continue;
+
+		if(tag->canceled() || !tag->request)
+		{
+			erase(*tag);
+			continue;
+		}
+
+		tag->state.written = 0;
+	}
+
+	assert(link->peer);
+	link->peer->disperse_uncommitted(*link);
+	return true;
+}
+
+void
+ircd::server::link::h2::handle_window_update(const header &head,
+                                             const const_buffer &payload)
+{
+	if(unlikely(size(payload) != 4))
+		throw http2::error
+		{
+			http2::error::FRAME_SIZE_ERROR, "WINDOW_UPDATE of %u bytes", uint(head.len)
+		};
+
+	const uint32_t increment
+	{
+		get(payload, 0) & 0x7fffffffU
+	};
+
+	if(!head.stream_id)
+	{
+		window += increment;
+		if(unlikely(!increment || window > 0x7fffffffL))
+			throw http2::error
+			{
+				http2::error::FLOW_CONTROL_ERROR, "connection WINDOW_UPDATE %u", increment
+			};
+
+		return;
+	}
+
+	const auto it
+	{
+		streams.find(head.stream_id)
+	};
+
+	if(it != end(streams))
+		it->second.window += increment;
+}
+
+/// Feed a received buffer to the tag as if it were read from the socket.
+/// Anything beyond the end of the tag's response is discarded.
+void
+ircd::server::link::h2::feed(tag &tag,
+                             const const_buffer &buffer,
+                             bool &done)
+{
+	const_buffer remain(buffer);
+	while(!empty(remain) && !done)
+	{
+		const mutable_buffer dst
+		{
+			tag.make_read_buffer()
+		};
+
+		const size_t copied
+		{
+			copy(dst, remain)
+		};
+
+		tag.read_buffer(const_buffer{data(dst), copied}, done, *link);
+		remain = const_buffer
+		{
+			data(remain) + copied, size(remain) - copied
+		};
+	}
+}
+
+/// Conclude the stream if the tag is done or the remote ended the stream.
+/// Returns true if the tag was removed from the queue.
+bool
+ircd::server::link::h2::finish(streams_type::iterator it,
+                               tag &tag,
+                               const bool &done,
+                               const bool &end_stream)
+{
+	if(done)
+	{
+		assert(link->peer);
+		link->peer->handle_tag_done(*link, tag);
+		streams.erase(it);
+		erase(tag);
+		return true;
+	}
+
+	if(end_stream)
+		return fail(it, tag, make_exception_ptr<error>
+		(
+			"Stream %u ended before the response was complete", it->first
+		),
+		false);
+
+	return false;
+}
+
+/// Stream error; the tag receives the exception and the stream is optionally
+/// reset. Other streams on the link are unaffected.
+bool
+ircd::server::link::h2::fail(streams_type::iterator it,
+                             tag &tag,
+                             std::exception_ptr eptr,
+                             const bool &send_reset)
+{
+	log::derror
+	{
+		log, "%s tag:%lu stream:%u :%s",
+		loghead(*link),
+		tag.state.id,
+		it->first,
+		what(eptr),
+	};
+
+	if(send_reset)
+		reset(it->first, http2::error::CANCEL);
+
+	tag.set_exception(std::move(eptr));
+	streams.erase(it);
+	erase(tag);
+	return true;
+}
+
+void
+ircd::server::link::h2::reset(const uint32_t &id,
+                              const enum http2::error::code &code)
+{
+	char payload[4];
+	put(payload, code);
+	compose(header{sizeof(payload), http2::frame::RST_STREAM, 0, id}, payload);
+}
+
+void
+ircd::server::link::h2::update(const uint32_t &id,
+                               const size_t &increment)
+{
+	char payload[4];
+	put(payload, increment);
+	compose(header{sizeof(payload), http2::frame::WINDOW_UPDATE, 0, id}, payload);
+}
+
+void
+ircd::server::link::h2::compose(const header &head,
+                                const const_buffer &payload)
+{
+	char buf[sizeof(header)];
+	out.append(data(head(buf)), sizeof(buf));
+	out.append(data(payload), size(payload));
+}
+
+void
+ircd::server::link::h2::erase(const tag &tag)
+{
+	auto &queue(link->queue);
+	const auto it(std::find_if(begin(queue), end(queue), [&tag]
+	(const auto &tag_)
+	{
+		return &tag_ == &tag;
+	}));
+
+	assert(it != end(queue));
+	queue.erase(it);
+}
+
+ircd::server::link::h2::streams_type::iterator
+ircd::server::link::h2::find(const tag &tag)
+{
+	return std::find_if(begin(streams), end(streams), [&tag]
+	(const auto &stream)
+	{
+		return stream.second.tag == tag.state.id;
+	});
+}
+
+ircd::server::tag *
+ircd::server::link::h2::find(const uint64_t &tag_id)
+{
+	const auto it(std::find_if(begin(link->queue), end(link->queue), [&tag_id]
+	(const auto &tag)
+	{
+		return tag.state.id == tag_id;
+	}));
+
+	return it != end(link->queue)? std::addressof(*it) : nullptr;
+}
+
+ircd::const_buffer
+ircd::server::link::h2::unpadded(const header &head,
+                                 const const_buffer &payload)
+{
+	if(~head.flags & http2::frame::PADDED)
+		return payload;
+
+	const size_t pad
+	{
+		!empty(payload)? get(payload, 0, 1): 0
+	};
+
+	if(unlikely(empty(payload) || pad >= size(payload)))
+		throw http2::error
+		{
+			http2::error::PROTOCOL_ERROR, "padding of %zu exceeds %s payload of %zu",
+			pad,
+			http2::frame::reflect(head.type),
+			size(payload),
+		};
+
+	return const_buffer
+	{
+		data(payload) + 1, size(payload) - 1 - pad
+	};
+}
+
+/// Big-endian integer of len bytes from the payload.
+uint32_t
+ircd::server::link::h2::get(const const_buffer &buf,
+                            const size_t &off,
+                            const size_t &len)
+{
+	assert(off + len <= size(buf));
+	uint32_t ret(0);
+	for(size_t i(0); i < len; ++i)
+		ret = (ret << 8) | uint8_t(buf[off + i]);
+
+	return ret;
+}
+
+void
+ircd::server::link::h2::put(char *const &buf,
+                            const uint32_t &val,
+                            const size_t &len)
+{
+	for(size_t i(0); i < len; ++i)
+		buf[i] = char(val >> (8 * (len - i - 1)));
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 // server/tag.h
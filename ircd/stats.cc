@@ -12,6 +12,10 @@ decltype(ircd::stats::items)
 ircd::stats::items
 {};
 
+decltype(ircd::stats::histograms)
+ircd::stats::histograms
+{};
+
 std::ostream &
 ircd::stats::operator<<(std::ostream &s, const item &item)
 {
@@ -19,6 +23,20 @@ ircd::stats::operator<<(std::ostream &s, const item &item)
 	return s;
 }
 
+std::ostream &
+ircd::stats::operator<<(std::ostream &s, const histogram &h)
+{
+	s << "count " << h.count.load(std::memory_order_relaxed)
+	  << " mean " << h.mean()
+	  << " p50 " << h.percentile(50.0)
+	  << " p90 " << h.percentile(90.0)
+	  << " p99 " << h.percentile(99.0)
+	  << " p99.9 " << h.percentile(99.9)
+	  << " max " << h.max.load(std::memory_order_relaxed);
+
+	return s;
+}
+
 //
 // item
 //
@@ -77,3 +95,118 @@ noexcept
 		items.erase(it);
 	}
 }
+
+//
+// histogram
+//
+
+ircd::stats::histogram::histogram(const json::members &opts)
+:feature_
+{
+	opts
+}
+,feature
+{
+	feature_
+}
+,name
+{
+	unquote(feature.at("name"))
+}
+{
+	if(name.size() > item::NAME_MAX_LEN)
+		throw error
+		{
+			"Stats histogram '%s' name length:%zu exceeds max:%zu",
+			name,
+			name.size(),
+			item::NAME_MAX_LEN
+		};
+
+	if(!histograms.emplace(name, this).second)
+		throw error
+		{
+			"Stats histogram named '%s' already exists", name
+		};
+}
+
+ircd::stats::histogram::~histogram()
+noexcept
+{
+	if(name)
+	{
+		const auto it{histograms.find(name)};
+		assert(data(it->first) == data(name));
+		histograms.erase(it);
+	}
+}
+
+void
+ircd::stats::histogram::clear()
+noexcept
+{
+	for(auto &bucket : this->bucket)
+		bucket.store(0, std::memory_order_relaxed);
+
+	count.store(0, std::memory_order_relaxed);
+	sum.store(0, std::memory_order_relaxed);
+	max.store(0, std::memory_order_relaxed);
+}
+
+ircd::stats::histogram &
+ircd::stats::histogram::operator+=(const histogram &o)
+noexcept
+{
+	static const auto order
+	{
+		std::memory_order_relaxed
+	};
+
+	for(size_t i(0); i < bucket_count; ++i)
+		bucket[i].fetch_add(o.bucket[i].load(order), order);
+
+	count.fetch_add(o.count.load(order), order);
+	sum.fetch_add(o.sum.load(order), order);
+
+	const auto val(o.max.load(order));
+	auto cur(max.load(order));
+	while(val > cur && !max.compare_exchange_weak(cur, val, order));
+	return *this;
+}
+
+/// The value at or below which pct percent of the samples fall. This is the
+/// highest value of the bucket containing that sample, limited by the max.
+uint64_t
+ircd::stats::histogram::percentile(const double &pct)
+const noexcept
+{
+	static const auto order
+	{
+		std::memory_order_relaxed
+	};
+
+	const auto count
+	{
+		this->count.load(order)
+	};
+
+	const auto max
+	{
+		this->max.load(order)
+	};
+
+	if(!count)
+		return 0;
+
+	const uint64_t target
+	{
+		std::max(uint64_t(std::ceil(count * std::clamp(pct, 0.0, 100.0) / 100.0)), 1UL)
+	};
+
+	uint64_t accum(0);
+	for(size_t i(0); i < bucket_count; ++i)
+		if((accum += bucket[i].load(order)) >= target)
+			return std::min(upper(i), max);
+
+	return max;
+}
@@ -29,6 +29,9 @@ ircd::m::acquire::log
 ircd::m::acquire::acquire::acquire(const room &room,
                                    const opts &opts)
 {
+	// Resynchronization is bulk work on behalf of no client.
+	const ctx::this_ctx::background background;
+
 	handle_room(room, opts);
 	ctx::interruption_point();
 
@@ -110,6 +113,8 @@ try
 			if(unlikely(ctx::interruption_requested()))
 				return false;
 
+			ctx::this_ctx::yield_slice();
+
 			if(errors.count(event_id))
 				return true;
 
@@ -203,6 +208,8 @@ try
 		if(unlikely(ctx::interruption_requested()))
 			return false;
 
+		ctx::this_ctx::yield_slice();
+
 		auto it{fail.lower_bound(event_id)};
 		if(it == end(fail) || *it != event_id)
 		{
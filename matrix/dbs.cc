@@ -98,6 +98,11 @@ ircd::m::dbs::init::init(const string_view &servername,
 	// Recall the db directory init manually with the now-updated basepath
 	db::init::directory();
 
+	// A secondary instance tails the events database of the primary process
+	// rather than owning it; see vm::init for the catch-up.
+	if(ircd::secondary)
+		dbopts += "secondary=true;";
+
 	// Open the events database
 	static const string_view &dbname{"events"};
 	events = std::make_shared<database>(dbname, std::move(dbopts), desc::events);
@@ -117,17 +122,24 @@ ircd::m::dbs::init::init(const string_view &servername,
 	// Construct global convenience references for the metadata columns
 	event_idx = db::column{*events, desc::event_idx.name};
 	event_json = db::column{*events, desc::event_json.name};
+	event_bin = db::column{*events, desc::event_bin.name};
 	event_refs = db::domain{*events, desc::event_refs.name};
 	event_horizon = db::domain{*events, desc::event_horizon.name};
 	event_sender = db::domain{*events, desc::event_sender.name};
 	event_type = db::domain{*events, desc::event_type.name};
 	event_state = db::domain{*events, desc::event_state.name};
+	event_relates = db::domain{*events, desc::event_relates.name};
+	event_relates_count = db::domain{*events, desc::event_relates_count.name};
 	room_head = db::domain{*events, desc::room_head.name};
 	room_events = db::domain{*events, desc::room_events.name};
 	room_type = db::domain{*events, desc::room_type.name};
 	room_joined = db::domain{*events, desc::room_joined.name};
 	room_state = db::domain{*events, desc::room_state.name};
 	room_state_space = db::domain{*events, desc::room_state_space.name};
+	user_sync = db::domain{*events, desc::user_sync.name};
+
+	// Populate the event_id filter in the background.
+	event_idx_filter::init();
 }
 
 /// Shuts down the m::dbs subsystem; closes the events database. The extern
@@ -135,6 +147,8 @@ ircd::m::dbs::init::init(const string_view &servername,
 ircd::m::dbs::init::~init()
 noexcept
 {
+	event_idx_filter::fini();
+
 	// Unref DB (should close)
 	events = {};
 
@@ -271,6 +285,9 @@ ircd::m::dbs::_index_event(db::txn &txn,
 	if(opts.appendix.test(appendix::EVENT_JSON))
 		_index_event_json(txn, event, opts);
 
+	if(opts.appendix.test(appendix::EVENT_BIN))
+		_index_event_bin(txn, event, opts);
+
 	if(opts.appendix.test(appendix::EVENT_SENDER))
 		_index_event_sender(txn, event, opts);
 
@@ -280,6 +297,9 @@ ircd::m::dbs::_index_event(db::txn &txn,
 	if(opts.appendix.test(appendix::EVENT_STATE))
 		_index_event_state(txn, event, opts);
 
+	if(opts.appendix.test(appendix::EVENT_RELATES))
+		_index_event_relates(txn, event, opts);
+
 	if(opts.appendix.test(appendix::EVENT_REFS) && opts.event_refs.any())
 		_index_event_refs(txn, event, opts);
 
@@ -356,6 +376,9 @@ ircd::m::dbs::_index_room_redact(db::txn &txn,
 		return;
 	}
 
+	if(opts.appendix.test(appendix::EVENT_RELATES))
+		_index_event_relates_redact(txn, event, opts, target_idx);
+
 	char state_key_buf[event::STATE_KEY_MAX_SIZE];
 	const string_view &state_key
 	{
@@ -485,6 +485,10 @@ ircd::m::dbs::desc::events
 	// Mapping of event_idx to full json
 	event_json,
 
+	// event_idx => binary
+	// Mapping of event_idx to binary encoding (optional)
+	event_bin,
+
 	// event_idx | event_idx
 	// Reverse mapping of the event reference graph.
 	event_refs,
@@ -505,6 +509,14 @@ ircd::m::dbs::desc::events
 	// Mapping of event states, indexed for application features.
 	event_state,
 
+	// event_idx | rel_type, type, event_idx
+	// Mapping of events related to with m.relates_to.
+	event_relates,
+
+	// event_idx | rel_type, type, key => int64_t
+	// Counters of relations made to an event.
+	event_relates_count,
+
 	// (room_id, (depth, event_idx))
 	// Sequence of all events for a room, ever.
 	room_events,
@@ -529,6 +541,10 @@ ircd::m::dbs::desc::events
 	// Mapping of all current head events for a room.
 	room_head,
 
+	// (user_id, filter_id) => (sync snapshot)
+	// Materialized initial sync of a user.
+	user_sync,
+
 	//
 	// These columns are legacy; they have been dropped from the schema.
 	//
@@ -0,0 +1,338 @@
+// The Construct
+//
+// Copyright (C) The Construct Developers, Authors & Contributors
+// Copyright (C) 2016-2020 Jason Volk <jason@zemos.net>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice is present in all copies. The
+// full license for this software is available in the LICENSE file.
+
+decltype(ircd::m::dbs::event_bin)
+ircd::m::dbs::event_bin;
+
+decltype(ircd::m::dbs::event_bin_enable)
+ircd::m::dbs::event_bin_enable
+{
+	{ "name",     "ircd.m.dbs._event_bin.enable" },
+	{ "default",  false                          },
+};
+
+decltype(ircd::m::dbs::desc::event_bin__block__size)
+ircd::m::dbs::desc::event_bin__block__size
+{
+	{ "name",     "ircd.m.dbs._event_bin.block.size" },
+	{ "default",  long(1_KiB)                        },
+};
+
+decltype(ircd::m::dbs::desc::event_bin__meta_block__size)
+ircd::m::dbs::desc::event_bin__meta_block__size
+{
+	{ "name",     "ircd.m.dbs._event_bin.meta_block.size" },
+	{ "default",  512L                                    },
+};
+
+decltype(ircd::m::dbs::desc::event_bin__cache__size)
+ircd::m::dbs::desc::event_bin__cache__size
+{
+	{
+		{ "name",     "ircd.m.dbs._event_bin.cache.size" },
+		{ "default",  long(64_MiB)                       },
+	}, []
+	{
+		const size_t &value{event_bin__cache__size};
+		db::capacity(db::cache(dbs::event_bin), value);
+	}
+};
+
+decltype(ircd::m::dbs::desc::event_bin__cache_comp__size)
+ircd::m::dbs::desc::event_bin__cache_comp__size
+{
+	{
+		{ "name",     "ircd.m.dbs._event_bin.cache_comp.size" },
+		{ "default",  long(0_MiB)                             },
+	}, []
+	{
+		const size_t &value{event_bin__cache_comp__size};
+		db::capacity(db::cache_compressed(dbs::event_bin), value);
+	}
+};
+
+decltype(ircd::m::dbs::desc::event_bin__bloom__bits)
+ircd::m::dbs::desc::event_bin__bloom__bits
+{
+	{ "name",     "ircd.m.dbs._event_bin.bloom.bits" },
+	{ "default",  9L                                 },
+};
+
+const ircd::db::descriptor
+ircd::m::dbs::desc::event_bin
+{
+	// name
+	"_event_bin",
+
+	// explanation
+	R"(Binary encoding of an event.
+
+	event_idx => event_bin
+
+	Optional alternative to _event_json for full event queries. The value is
+	an offset table followed by the property values of the event; see
+	m/dbs/event_bin.h. Written only while ircd.m.dbs._event_bin.enable is set.
+
+	)",
+
+	// typing (key, value)
+	{
+		typeid(uint64_t), typeid(string_view)
+	},
+
+	// options
+	{},
+
+	// comparator
+	{},
+
+	// prefix transform
+	{},
+
+	// drop column
+	false,
+
+	// cache size
+	bool(cache_enable)? -1 : 0, //uses conf item
+
+	// cache size for compressed assets
+	bool(cache_comp_enable)? -1 : 0,
+
+	// bloom filter bits
+	size_t(event_bin__bloom__bits),
+
+	// expect queries hit
+	false,
+
+	// block size
+	size_t(event_bin__block__size),
+
+	// meta_block size
+	size_t(event_bin__meta_block__size),
+};
+
+//
+// indexer
+//
+
+void
+ircd::m::dbs::_index_event_bin(db::txn &txn,
+                               const event &event,
+                               const write_opts &opts)
+{
+	assert(opts.appendix.test(appendix::EVENT_BIN));
+	assert(opts.event_idx);
+
+	// Deletions are always made so the column is cleaned up if the feature
+	// was enabled at some point in the past.
+	if(opts.op == db::op::SET && !event_bin_enable)
+		return;
+
+	const ctx::critical_assertion ca;
+	thread_local char buf[EVENT_BIN_MAX_SIZE];
+	const string_view &key
+	{
+		byte_view<string_view>(opts.event_idx)
+	};
+
+	const string_view &val
+	{
+		opts.op == db::op::SET?
+			string_view{event_bin_encode(buf, event)}:
+			string_view{}
+	};
+
+	db::txn::append
+	{
+		txn, event_bin,
+		{
+			opts.op,   // db::op
+			key,       // key
+			val,       // val
+		}
+	};
+}
+
+//
+// codec
+//
+
+ircd::const_buffer
+ircd::m::dbs::event_bin_encode(const mutable_buffer &out,
+                               const event &event)
+{
+	static_assert(event::size() <= 16);
+
+	size_t i(0);
+	uint16_t present(0);
+	std::array<string_view, event::size()> val;
+	for_each(event, [&i, &present, &val]
+	(const auto &, auto&& _val)
+	{
+		if(defined(json::value(_val)))
+		{
+			val[i] = byte_view<string_view>{_val};
+			present |= 1U << i;
+		}
+
+		++i;
+	});
+
+	const size_t count
+	{
+		size_t(__builtin_popcount(present))
+	};
+
+	const size_t data_size
+	{
+		std::accumulate(begin(val), end(val), size_t(0), []
+		(const size_t &ret, const string_view &val)
+		{
+			return ret + size(val);
+		})
+	};
+
+	const size_t total_size
+	{
+		EVENT_BIN_HEADER_SIZE + sizeof(uint32_t) * count + data_size
+	};
+
+	if(unlikely(total_size > size(out)))
+		throw error
+		{
+			"Binary encoding of %s requires %zu bytes; buffer is %zu.",
+			string_view{event.event_id},
+			total_size,
+			size(out),
+		};
+
+	uint8_t *const header
+	{
+		reinterpret_cast<uint8_t *>(data(out))
+	};
+
+	header[0] = EVENT_BIN_VERSION;
+	header[1] = 0;
+	memcpy(header + 2, &present, sizeof(present));
+
+	uint32_t end_off(0);
+	char *pos(data(out) + EVENT_BIN_HEADER_SIZE);
+	char *data_pos(pos + sizeof(uint32_t) * count);
+	for(size_t j(0); j < val.size(); ++j)
+	{
+		if(!(present & (1U << j)))
+			continue;
+
+		data_pos = std::copy(begin(val[j]), end(val[j]), data_pos);
+		end_off += size(val[j]);
+		memcpy(pos, &end_off, sizeof(end_off));
+		pos += sizeof(end_off);
+	}
+
+	assert(size_t(data_pos - data(out)) == total_size);
+	return const_buffer
+	{
+		data(out), total_size
+	};
+}
+
+/// Assigns the selected properties of the event from the binary encoding.
+/// The event's source is not set; the values reference the input buffer.
+/// Returns false if the input is not a recognized encoding.
+bool
+ircd::m::dbs::event_bin_decode(event &event,
+                               const string_view &bin,
+                               const event::keys::selection &selection)
+{
+	if(unlikely(size(bin) < EVENT_BIN_HEADER_SIZE))
+		return false;
+
+	if(unlikely(uint8_t(bin[0]) != EVENT_BIN_VERSION))
+		return false;
+
+	uint16_t present;
+	memcpy(&present, data(bin) + 2, sizeof(present));
+
+	const size_t count
+	{
+		size_t(__builtin_popcount(present))
+	};
+
+	const size_t table_end
+	{
+		EVENT_BIN_HEADER_SIZE + sizeof(uint32_t) * count
+	};
+
+	if(unlikely(size(bin) < table_end))
+		return false;
+
+	const char *const table
+	{
+		data(bin) + EVENT_BIN_HEADER_SIZE
+	};
+
+	const string_view data_
+	{
+		bin.substr(table_end)
+	};
+
+	size_t i(0), j(0);
+	uint32_t start(0);
+	bool ret(true);
+	for_each(event, [&](const auto &, auto &_val)
+	{
+		using value_type = std::decay_t<decltype(_val)>;
+
+		const bool is_present
+		{
+			bool(present & (1U << i))
+		};
+
+		const bool is_selected
+		{
+			selection.test(i++)
+		};
+
+		const auto clear{[&_val]
+		{
+			if constexpr(std::is_arithmetic<value_type>())
+				_val = value_type(json::undefined_number);
+			else
+				_val = value_type{};
+		}};
+
+		if(!is_present)
+			return clear();
+
+		uint32_t end_off;
+		memcpy(&end_off, table + sizeof(uint32_t) * j++, sizeof(end_off));
+		const string_view slice
+		{
+			likely(start <= end_off && end_off <= size(data_))?
+				data_.substr(start, end_off - start):
+				string_view{}
+		};
+
+		ret &= start <= end_off && end_off <= size(data_);
+		start = end_off;
+
+		if(!is_selected)
+			return clear();
+
+		if constexpr(std::is_arithmetic<value_type>())
+			_val = size(slice) >= sizeof(value_type)?
+				value_type(byte_view<value_type>(slice)):
+				value_type(json::undefined_number);
+		else
+			_val = value_type{slice};
+	});
+
+	return ret;
+}
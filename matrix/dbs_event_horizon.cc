@@ -210,6 +210,7 @@ ircd::m::dbs::_index_event_horizon_resolve(db::txn &txn,
 		_opts.event_idx = event_idx;
 		_opts.appendix.reset();
 		_opts.appendix.set(appendix::EVENT_REFS);
+		_opts.appendix.set(appendix::EVENT_RELATES);
 		_opts.appendix.set(appendix::ROOM_REDACT);
 		_opts.appendix.set(appendix::ROOM_HEAD_RESOLVE);
 		_opts.event_refs = opts.horizon_resolve;
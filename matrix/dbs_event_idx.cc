@@ -168,3 +168,334 @@ ircd::m::dbs::_index_event_id(db::txn &txn,
 		}
 	};
 }
+
+//
+// event_idx_filter
+//
+
+namespace ircd::m::dbs
+{
+	static void event_idx_filter_worker();
+
+	static ctx::dock event_idx_filter_dock;
+	static bool event_idx_filter_request;
+	static ctx::context event_idx_filter_context;
+}
+
+decltype(ircd::m::dbs::event_idx_filter::enable)
+ircd::m::dbs::event_idx_filter::enable
+{
+	{ "name",     "ircd.m.dbs._event_idx.filter.enable" },
+	{ "default",  true                                  },
+};
+
+decltype(ircd::m::dbs::event_idx_filter::bits_per_key)
+ircd::m::dbs::event_idx_filter::bits_per_key
+{
+	{ "name",     "ircd.m.dbs._event_idx.filter.bits" },
+	{ "default",  12L                                 },
+};
+
+decltype(ircd::m::dbs::event_idx_filter::queries)
+ircd::m::dbs::event_idx_filter::queries
+{
+	{ "name", "ircd.m.dbs._event_idx.filter.queries"                  },
+	{ "desc", "Number of event_id existence queries to the filter"    },
+};
+
+decltype(ircd::m::dbs::event_idx_filter::negatives)
+ircd::m::dbs::event_idx_filter::negatives
+{
+	{ "name", "ircd.m.dbs._event_idx.filter.negatives"                },
+	{ "desc", "Number of queries answered by the filter alone"        },
+};
+
+decltype(ircd::m::dbs::event_idx_filter::false_positives)
+ircd::m::dbs::event_idx_filter::false_positives
+{
+	{ "name", "ircd.m.dbs._event_idx.filter.false_positives"          },
+	{ "desc", "Number of positive answers not found in the database"  },
+};
+
+decltype(ircd::m::dbs::event_idx_filter::active)
+ircd::m::dbs::event_idx_filter::active;
+
+decltype(ircd::m::dbs::event_idx_filter::building)
+ircd::m::dbs::event_idx_filter::building;
+
+void
+ircd::m::dbs::event_idx_filter::init()
+{
+	// Events written by the primary never pass through add() on a secondary;
+	// every query there falls through to the database instead.
+	if(ircd::secondary)
+		return;
+
+	event_idx_filter_request = true;
+	event_idx_filter_context = ctx::context
+	{
+		"m.dbs.filter", 512_KiB, event_idx_filter_worker, ctx::context::POST
+	};
+}
+
+void
+ircd::m::dbs::event_idx_filter::fini()
+noexcept
+{
+	// Terminates and joins the worker.
+	event_idx_filter_context = ctx::context{};
+	building.reset();
+	active.reset();
+}
+
+void
+ircd::m::dbs::event_idx_filter_worker()
+{
+	while(1) try
+	{
+		event_idx_filter_dock.wait([]
+		{
+			return event_idx_filter_request;
+		});
+
+		event_idx_filter_request = false;
+		if(event_idx_filter::enable)
+			event_idx_filter::rebuild();
+	}
+	catch(const ctx::interrupted &)
+	{
+		throw;
+	}
+	catch(const std::exception &e)
+	{
+		log::error
+		{
+			log, "event_idx filter worker :%s",
+			e.what(),
+		};
+	}
+}
+
+/// Build a filter from all keys in the column then replace the active filter
+/// with it. Keys written in the meantime are added to both.
+void
+ircd::m::dbs::event_idx_filter::rebuild()
+{
+	static const db::gopts gopts
+	{
+		db::get::NO_CACHE, db::get::NO_CHECKSUM
+	};
+
+	const size_t estimate
+	{
+		size_t(db::property<db::prop_int>(event_idx, "rocksdb.estimate-num-keys"))
+	};
+
+	// Headroom for growth before the next rebuild.
+	const size_t capacity
+	{
+		std::max(estimate + estimate / 2, size_t(1_MiB))
+	};
+
+	if(building)
+		throw m::UNAVAILABLE
+		{
+			"The event_idx filter is already being built."
+		};
+
+	building = std::make_unique<event_idx_filter>(capacity);
+
+	const unwind_exceptional reset{[]
+	{
+		building.reset();
+	}};
+
+	util::timer timer;
+	size_t count(0);
+	const ctx::this_ctx::background background;
+	for(auto it(event_idx.begin(gopts)); it; ++it)
+	{
+		ctx::this_ctx::yield_slice();
+		building->set(it->first);
+		if(++count % 65536 == 0)
+			ctx::yield();
+	}
+
+	active = std::move(building);
+
+	char pbuf[2][48];
+	log::info
+	{
+		log, "event_idx filter built over %zu of %zu keys in %s :%s %zu blocks",
+		count,
+		active->keys,
+		ircd::pretty(pbuf[0], timer.at<milliseconds>(), true),
+		ircd::pretty(pbuf[1], iec(active->blocks.size() * sizeof(block))),
+		active->blocks.size(),
+	};
+}
+
+/// False only when the event_id is certainly not in event_idx.
+bool
+ircd::m::dbs::event_idx_filter::maybe(const string_view &event_id)
+noexcept
+{
+	if(!active || !enable)
+		return true;
+
+	++queries;
+	if(active->test(event_id))
+		return true;
+
+	++negatives;
+	return false;
+}
+
+void
+ircd::m::dbs::event_idx_filter::add(const string_view &event_id)
+noexcept
+{
+	if(building)
+		building->set(event_id);
+
+	if(!active)
+		return;
+
+	active->set(event_id);
+	if(active->keys > active->capacity && !building && !event_idx_filter_request)
+	{
+		event_idx_filter_request = true;
+		event_idx_filter_dock.notify_one();
+	}
+}
+
+/// Add the event_ids written to event_idx by a transaction. This must be
+/// called after the transaction is committed: a rebuild iterating the column
+/// may not see a write committed after it began, so the key has to be added
+/// to the filter being built at that point rather than when composed.
+void
+ircd::m::dbs::event_idx_filter::add(const db::txn &txn)
+{
+	if(!active && !building)
+		return;
+
+	db::for_each(txn, [](const db::delta &delta)
+	{
+		const auto &op(std::get<db::delta::OP>(delta));
+		const auto &col(std::get<db::delta::COL>(delta));
+		if(op == db::op::SET && col == desc::event_idx.name)
+			add(std::get<db::delta::KEY>(delta));
+	});
+}
+
+/// Called when a positive answer from the filter was not in the database.
+void
+ircd::m::dbs::event_idx_filter::missed()
+noexcept
+{
+	if(active && enable)
+		++false_positives;
+}
+
+//
+// event_idx_filter::event_idx_filter
+//
+
+namespace ircd::m::dbs
+{
+	static uint64_t event_idx_filter_mix(uint64_t) noexcept;
+}
+
+ircd::m::dbs::event_idx_filter::event_idx_filter(const size_t &capacity)
+:blocks
+(
+	std::max((capacity * size_t(bits_per_key)) / (sizeof(block) * 8), 1UL)
+)
+,capacity
+{
+	capacity
+}
+{
+}
+
+size_t
+ircd::m::dbs::event_idx_filter::popcount()
+const noexcept
+{
+	size_t ret(0);
+	for(const auto &block : blocks)
+		for(const auto &word : block.word)
+			ret += __builtin_popcountl(word);
+
+	return ret;
+}
+
+void
+ircd::m::dbs::event_idx_filter::set(const string_view &event_id)
+noexcept
+{
+	const uint64_t h
+	{
+		std::hash<string_view>{}(event_id)
+	};
+
+	auto &block
+	{
+		blocks[(__uint128_t(h) * blocks.size()) >> 64]
+	};
+
+	const uint64_t bits
+	{
+		event_idx_filter_mix(h)
+	};
+
+	for(size_t i(0); i < k; ++i)
+	{
+		const auto bit((bits >> (i * 9)) & 511);
+		block.word[bit / 64] |= 1UL << (bit % 64);
+	}
+
+	++keys;
+}
+
+bool
+ircd::m::dbs::event_idx_filter::test(const string_view &event_id)
+const noexcept
+{
+	const uint64_t h
+	{
+		std::hash<string_view>{}(event_id)
+	};
+
+	const auto &block
+	{
+		blocks[(__uint128_t(h) * blocks.size()) >> 64]
+	};
+
+	const uint64_t bits
+	{
+		event_idx_filter_mix(h)
+	};
+
+	for(size_t i(0); i < k; ++i)
+	{
+		const auto bit((bits >> (i * 9)) & 511);
+		if(!(block.word[bit / 64] & (1UL << (bit % 64))))
+			return false;
+	}
+
+	return true;
+}
+
+/// splitmix64 finalizer; decorrelates the in-block bits from the block index.
+uint64_t
+ircd::m::dbs::event_idx_filter_mix(uint64_t x)
+noexcept
+{
+	x ^= x >> 30;
+	x *= 0xbf58476d1ce4e5b9UL;
+	x ^= x >> 27;
+	x *= 0x94d049bb133111ebUL;
+	x ^= x >> 31;
+	return x;
+}
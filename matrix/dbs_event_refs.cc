@@ -16,6 +16,7 @@ namespace ircd::m::dbs
 	static void _index_event_refs_m_relates(db::txn &, const event &, const write_opts &); //query
 	static void _index_event_refs_state(db::txn &, const event &, const write_opts &); // query
 	static void _index_event_refs_auth(db::txn &, const event &, const write_opts &); //query
+	static void _index_event_refs_prev_auth(db::txn &, const event &, const write_opts &); //query
 	static void _index_event_refs_prev(db::txn &, const event &, const write_opts &); //query
 	static bool event_refs__cmp_less(const string_view &a, const string_view &b);
 }
@@ -180,6 +181,9 @@ ircd::m::dbs::_index_event_refs(db::txn &txn,
 	if(opts.event_refs.test(uint(ref::NEXT_AUTH)))
 		_index_event_refs_auth(txn, event, opts);
 
+	if(opts.event_refs.test(uint(ref::PREV_AUTH)))
+		_index_event_refs_prev_auth(txn, event, opts);
+
 	if(opts.event_refs.test(uint(ref::NEXT_STATE)) ||
 	   opts.event_refs.test(uint(ref::PREV_STATE)))
 		_index_event_refs_state(txn, event, opts);
@@ -312,6 +316,55 @@ ircd::m::dbs::_index_event_refs_auth(db::txn &txn,
 	}
 }
 
+// NOTE: QUERY
+void
+ircd::m::dbs::_index_event_refs_prev_auth(db::txn &txn,
+                                          const event &event,
+                                          const write_opts &opts)
+{
+	assert(opts.appendix.test(appendix::EVENT_REFS));
+	assert(opts.event_refs.test(uint(ref::PREV_AUTH)));
+
+	const event::prev prev{event};
+	for(size_t i(0); i < prev.auth_events_count(); ++i)
+	{
+		const event::id &auth_id
+		{
+			prev.auth_event(i)
+		};
+
+		const event::idx &auth_idx
+		{
+			find_event_idx(auth_id, opts)
+		};
+
+		// The reference is made when the horizon resolves.
+		if(!auth_idx)
+		{
+			if(opts.appendix.test(appendix::EVENT_HORIZON))
+				_index_event_horizon(txn, event, opts, auth_id);
+
+			continue;
+		}
+
+		thread_local char buf[EVENT_REFS_KEY_MAX_SIZE];
+		assert(opts.event_idx != 0 && auth_idx != 0);
+		assert(opts.event_idx != auth_idx);
+		const string_view &key
+		{
+			event_refs_key(buf, opts.event_idx, ref::PREV_AUTH, auth_idx)
+		};
+
+		db::txn::append
+		{
+			txn, dbs::event_refs,
+			{
+				opts.op, key
+			}
+		};
+	}
+}
+
 // NOTE: QUERY
 void
 ircd::m::dbs::_index_event_refs_state(db::txn &txn,
@@ -773,6 +826,7 @@ ircd::m::dbs::reflect(const ref &type)
 		case ref::NEXT_AUTH:             return "NEXT_AUTH";
 		case ref::NEXT_STATE:            return "NEXT_STATE";
 		case ref::PREV_STATE:            return "PREV_STATE";
+		case ref::PREV_AUTH:             return "PREV_AUTH";
 		case ref::M_RECEIPT__M_READ:     return "M_RECEIPT__M_READ";
 		case ref::M_RELATES:             return "M_RELATES";
 		case ref::M_ROOM_REDACTION:      return "M_ROOM_REDACTION";
@@ -0,0 +1,663 @@
+// The Construct
+//
+// Copyright (C) The Construct Developers, Authors & Contributors
+// Copyright (C) 2016-2020 Jason Volk <jason@zemos.net>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice is present in all copies. The
+// full license for this software is available in the LICENSE file.
+
+namespace ircd::m::dbs
+{
+	static void _index_event_relates_count(db::txn &, const write_opts &, const event::idx &, const string_view &, const string_view &, const string_view &);
+	static bool event_relates__cmp_less(const string_view &a, const string_view &b);
+}
+
+decltype(ircd::m::dbs::event_relates)
+ircd::m::dbs::event_relates;
+
+decltype(ircd::m::dbs::event_relates_count)
+ircd::m::dbs::event_relates_count;
+
+decltype(ircd::m::dbs::desc::event_relates__block__size)
+ircd::m::dbs::desc::event_relates__block__size
+{
+	{ "name",     "ircd.m.dbs._event_relates.block.size" },
+	{ "default",  512L                                   },
+};
+
+decltype(ircd::m::dbs::desc::event_relates__meta_block__size)
+ircd::m::dbs::desc::event_relates__meta_block__size
+{
+	{ "name",     "ircd.m.dbs._event_relates.meta_block.size" },
+	{ "default",  4096L                                       },
+};
+
+decltype(ircd::m::dbs::desc::event_relates__cache__size)
+ircd::m::dbs::desc::event_relates__cache__size
+{
+	{
+		{ "name",     "ircd.m.dbs._event_relates.cache.size" },
+		{ "default",  long(16_MiB)                           },
+	}, []
+	{
+		const size_t &value{event_relates__cache__size};
+		db::capacity(db::cache(dbs::event_relates), value);
+	}
+};
+
+decltype(ircd::m::dbs::desc::event_relates__cache_comp__size)
+ircd::m::dbs::desc::event_relates__cache_comp__size
+{
+	{
+		{ "name",     "ircd.m.dbs._event_relates.cache_comp.size" },
+		{ "default",  long(0_MiB)                                 },
+	}, []
+	{
+		const size_t &value{event_relates__cache_comp__size};
+		db::capacity(db::cache_compressed(dbs::event_relates), value);
+	}
+};
+
+/// Prefix transform for event_relates. The prefix is the event::idx of the
+/// target being related to.
+///
+const ircd::db::prefix_transform
+ircd::m::dbs::desc::event_relates__pfx
+{
+	"_event_relates",
+	[](const string_view &key)
+	{
+		return size(key) >= sizeof(event::idx);
+	},
+
+	[](const string_view &key)
+	{
+		assert(size(key) >= sizeof(event::idx));
+		return string_view
+		{
+			data(key), data(key) + sizeof(event::idx)
+		};
+	}
+};
+
+/// Comparator for event_relates. Within a target the entries are grouped by
+/// rel_type then type, and sorted from the most recent referer to the least
+/// so pagination starts at the newest relation like the timeline.
+///
+const ircd::db::comparator
+ircd::m::dbs::desc::event_relates__cmp
+{
+	"_event_relates",
+	event_relates__cmp_less,
+	std::equal_to<string_view>{},
+};
+
+const ircd::db::descriptor
+ircd::m::dbs::desc::event_relates
+{
+	// name
+	"_event_relates",
+
+	// explanation
+	R"(Index of relations made by events with an m.relates_to.
+
+	event_idx | rel_type, type, event_idx => --
+
+	The first part of the key is the event being related to. The second part
+	is the rel_type and the type of the event making the relation, followed by
+	the event_idx of that event. Each part is delimited by a null character.
+
+	The prefix transform is in effect; all relations to a target can be
+	iterated, or only those of a rel_type, or a rel_type and type. This serves
+	the client /relations endpoint without fetching every referer.
+
+	)",
+
+	// typing (key, value)
+	{
+		typeid(string_view), typeid(string_view)
+	},
+
+	// options
+	{},
+
+	// comparator
+	event_relates__cmp,
+
+	// prefix transform
+	event_relates__pfx,
+
+	// drop column
+	false,
+
+	// cache size
+	bool(cache_enable)? -1 : 0, //uses conf item
+
+	// cache size for compressed assets
+	bool(cache_comp_enable)? -1 : 0,
+
+	// bloom filter bits
+	0, // no bloom filter because of possible comparator issues
+
+	// expect queries hit
+	false,
+
+	// block size
+	size_t(event_relates__block__size),
+
+	// meta_block size
+	size_t(event_relates__meta_block__size),
+};
+
+decltype(ircd::m::dbs::desc::event_relates_count__block__size)
+ircd::m::dbs::desc::event_relates_count__block__size
+{
+	{ "name",     "ircd.m.dbs._event_relates_count.block.size" },
+	{ "default",  512L                                         },
+};
+
+decltype(ircd::m::dbs::desc::event_relates_count__meta_block__size)
+ircd::m::dbs::desc::event_relates_count__meta_block__size
+{
+	{ "name",     "ircd.m.dbs._event_relates_count.meta_block.size" },
+	{ "default",  4096L                                             },
+};
+
+decltype(ircd::m::dbs::desc::event_relates_count__cache__size)
+ircd::m::dbs::desc::event_relates_count__cache__size
+{
+	{
+		{ "name",     "ircd.m.dbs._event_relates_count.cache.size" },
+		{ "default",  long(8_MiB)                                  },
+	}, []
+	{
+		const size_t &value{event_relates_count__cache__size};
+		db::capacity(db::cache(dbs::event_relates_count), value);
+	}
+};
+
+decltype(ircd::m::dbs::desc::event_relates_count__cache_comp__size)
+ircd::m::dbs::desc::event_relates_count__cache_comp__size
+{
+	{
+		{ "name",     "ircd.m.dbs._event_relates_count.cache_comp.size" },
+		{ "default",  long(0_MiB)                                       },
+	}, []
+	{
+		const size_t &value{event_relates_count__cache_comp__size};
+		db::capacity(db::cache_compressed(dbs::event_relates_count), value);
+	}
+};
+
+/// Prefix transform for event_relates_count. The prefix is the event::idx
+/// of the target being related to.
+///
+const ircd::db::prefix_transform
+ircd::m::dbs::desc::event_relates_count__pfx
+{
+	"_event_relates_count",
+	[](const string_view &key)
+	{
+		return size(key) >= sizeof(event::idx);
+	},
+
+	[](const string_view &key)
+	{
+		assert(size(key) >= sizeof(event::idx));
+		return string_view
+		{
+			data(key), data(key) + sizeof(event::idx)
+		};
+	}
+};
+
+/// Merge operator for event_relates_count. Values are native int64_t; the
+/// operand is added to the existing value so writers never read the counter.
+///
+const ircd::db::merge_closure
+ircd::m::dbs::desc::event_relates_count__merge
+{
+	[](const string_view &key, const db::merge_delta &delta)
+	{
+		const int64_t exist
+		{
+			size(delta.first) >= sizeof(int64_t)?
+				int64_t(byte_view<int64_t>(delta.first)):
+				0L
+		};
+
+		const int64_t update
+		{
+			size(delta.second) >= sizeof(int64_t)?
+				int64_t(byte_view<int64_t>(delta.second)):
+				0L
+		};
+
+		const int64_t value
+		{
+			exist + update
+		};
+
+		return std::string
+		{
+			byte_view<string_view>(value)
+		};
+	}
+};
+
+const ircd::db::descriptor
+ircd::m::dbs::desc::event_relates_count
+{
+	// name
+	"_event_relates_count",
+
+	// explanation
+	R"(Counters of relations made to an event.
+
+	event_idx | rel_type, type, key => int64_t
+
+	The first part of the key is the event being related to. The second part
+	is the rel_type and the type of the event making the relation, followed by
+	the annotation key for m.annotation relations (empty for other rel_types).
+	Each part is delimited by a null character.
+
+	The value is maintained with the merge operator; each relation indexed adds
+	one and each relation redacted subtracts one. This allows aggregations to
+	be reported without iterating the relations themselves.
+
+	)",
+
+	// typing (key, value)
+	{
+		typeid(string_view), typeid(int64_t)
+	},
+
+	// options
+	{},
+
+	// comparator
+	{},
+
+	// prefix transform
+	event_relates_count__pfx,
+
+	// drop column
+	false,
+
+	// cache size
+	bool(cache_enable)? -1 : 0, //uses conf item
+
+	// cache size for compressed assets
+	bool(cache_comp_enable)? -1 : 0,
+
+	// bloom filter bits
+	0,
+
+	// expect queries hit
+	false,
+
+	// block size
+	size_t(event_relates_count__block__size),
+
+	// meta_block size
+	size_t(event_relates_count__meta_block__size),
+
+	// compression
+	{}, // no compression for this column
+
+	// compactor
+	{},
+
+	// compaction priority algorithm
+	"kOldestLargestSeqFirst"s,
+
+	// target_file_size
+	{
+		64_MiB,  // base
+		2L,      // multiplier
+	},
+
+	// max_bytes_for_level[8]
+	{
+		{  32_MiB,    1L }, // max_bytes_for_level_base
+		{      0L,    0L }, // max_bytes_for_level[0]
+		{      0L,    1L }, // max_bytes_for_level[1]
+		{      0L,    1L }, // max_bytes_for_level[2]
+		{      0L,    3L }, // max_bytes_for_level[3]
+		{      0L,    7L }, // max_bytes_for_level[4]
+		{      0L,   15L }, // max_bytes_for_level[5]
+		{      0L,   31L }, // max_bytes_for_level[6]
+	},
+
+	// merge operator
+	event_relates_count__merge,
+};
+
+//
+// indexers
+//
+
+// NOTE: QUERY
+void
+ircd::m::dbs::_index_event_relates(db::txn &txn,
+                                   const event &event,
+                                   const write_opts &opts)
+{
+	assert(opts.appendix.test(appendix::EVENT_RELATES));
+
+	const json::object &content
+	{
+		json::get<"content"_>(event)
+	};
+
+	if(!content.has("m.relates_to"))
+		return;
+
+	if(json::type(content.get("m.relates_to")) != json::OBJECT)
+		return;
+
+	const json::object &m_relates_to
+	{
+		content.get("m.relates_to")
+	};
+
+	const json::string &rel_type
+	{
+		m_relates_to.get("rel_type")
+	};
+
+	const json::string &event_id
+	{
+		m_relates_to.get("event_id")
+	};
+
+	if(!rel_type || !event_id)
+		return;
+
+	if(!valid(m::id::EVENT, event_id))
+		return;
+
+	// Unresolved targets are left to the event_refs indexer which places the
+	// event_horizon marker; we are called again on resolution.
+	const event::idx &target_idx
+	{
+		find_event_idx(event_id, opts)
+	};
+
+	if(!target_idx)
+		return;
+
+	const json::string &key
+	{
+		rel_type == "m.annotation"?
+			m_relates_to.get("key"):
+			string_view{}
+	};
+
+	thread_local char buf[EVENT_RELATES_KEY_MAX_SIZE];
+	assert(opts.event_idx != 0 && target_idx != 0);
+	const string_view &relates_key
+	{
+		event_relates_key(buf, target_idx, rel_type, at<"type"_>(event), opts.event_idx)
+	};
+
+	// The counter is only adjusted when the entry is being created or removed
+	// so re-indexing the same event (or redacting it twice) keeps it correct.
+	const bool exists
+	{
+		opts.allow_queries && db::has(dbs::event_relates, relates_key)
+	};
+
+	if(opts.op == db::op::SET && exists)
+		return;
+
+	if(opts.op == db::op::DELETE && !exists && opts.allow_queries)
+		return;
+
+	db::txn::append
+	{
+		txn, dbs::event_relates,
+		{
+			opts.op, relates_key
+		}
+	};
+
+	_index_event_relates_count(txn, opts, target_idx, rel_type, at<"type"_>(event), key);
+}
+
+/// Called when the redaction of `target_idx` is indexed; removes the relation
+/// it made, if any, and decrements its counter.
+///
+// NOTE: QUERY
+void
+ircd::m::dbs::_index_event_relates_redact(db::txn &txn,
+                                          const event &event,
+                                          const write_opts &opts,
+                                          const event::idx &target_idx)
+{
+	assert(opts.appendix.test(appendix::EVENT_RELATES));
+	assert(json::get<"type"_>(event) == "m.room.redaction");
+
+	if(!opts.allow_queries || opts.op != db::op::SET)
+		return;
+
+	const m::event::fetch target
+	{
+		std::nothrow, target_idx
+	};
+
+	if(!target.valid)
+		return;
+
+	if(!json::get<"content"_>(target).has("m.relates_to"))
+		return;
+
+	write_opts _opts(opts);
+	_opts.op = db::op::DELETE;
+	_opts.event_idx = target_idx;
+	_index_event_relates(txn, target, _opts);
+}
+
+void
+ircd::m::dbs::_index_event_relates_count(db::txn &txn,
+                                         const write_opts &opts,
+                                         const event::idx &target_idx,
+                                         const string_view &rel_type,
+                                         const string_view &type,
+                                         const string_view &key)
+{
+	thread_local char buf[EVENT_RELATES_COUNT_KEY_MAX_SIZE];
+	const string_view &count_key
+	{
+		event_relates_count_key(buf, target_idx, rel_type, type, key)
+	};
+
+	const int64_t value
+	{
+		opts.op == db::op::DELETE? -1L: 1L
+	};
+
+	db::txn::append
+	{
+		txn, dbs::event_relates_count,
+		{
+			db::op::MERGE,
+			count_key,
+			byte_view<string_view>(value),
+		}
+	};
+}
+
+//
+// cmp
+//
+
+bool
+ircd::m::dbs::event_relates__cmp_less(const string_view &a,
+                                      const string_view &b)
+{
+	assert(size(a) >= sizeof(event::idx));
+	assert(size(b) >= sizeof(event::idx));
+	const event::idx target[2]
+	{
+		byte_view<event::idx>(a.substr(0, sizeof(event::idx))),
+		byte_view<event::idx>(b.substr(0, sizeof(event::idx))),
+	};
+
+	if(target[0] < target[1])
+		return true;
+
+	if(target[0] > target[1])
+		return false;
+
+	// After the prefix is the rel_type,\0,type,\0,event_idx
+	const string_view post[2]
+	{
+		a.substr(sizeof(event::idx)),
+		b.substr(sizeof(event::idx)),
+	};
+
+	// These conditions are matched on queries when the user only supplies
+	// the target.
+	if(empty(post[1]))
+		return false;
+
+	if(empty(post[0]))
+		return true;
+
+	const auto &[rel_type_a, type_a, event_idx_a]
+	{
+		event_relates_key(post[0])
+	};
+
+	const auto &[rel_type_b, type_b, event_idx_b]
+	{
+		event_relates_key(post[1])
+	};
+
+	if(rel_type_a < rel_type_b)
+		return true;
+
+	if(rel_type_a > rel_type_b)
+		return false;
+
+	if(type_a < type_b)
+		return true;
+
+	if(type_a > type_b)
+		return false;
+
+	// reverse event_idx to start from highest first
+	if(event_idx_a < event_idx_b)
+		return false;
+
+	if(event_idx_a > event_idx_b)
+		return true;
+
+	// equal is not less; so false
+	return false;
+}
+
+//
+// key
+//
+
+/// The amalgam here is the suffix of the key following the target event::idx.
+/// Missing trailing parts are returned empty, and the referer as -1 so that
+/// a partial key sorts ahead of all complete keys sharing its parts.
+ircd::m::dbs::event_relates_tuple
+ircd::m::dbs::event_relates_key(const string_view &amalgam)
+{
+	const auto &[rel_type, post]
+	{
+		split(amalgam, '\0')
+	};
+
+	const auto &[type, trail]
+	{
+		split(post, '\0')
+	};
+
+	return event_relates_tuple
+	{
+		rel_type,
+		type,
+		likely(size(trail) >= sizeof(event::idx))?
+			event::idx(byte_view<uint64_t>(trail.substr(0, sizeof(event::idx)))):
+			-1UL,
+	};
+}
+
+ircd::string_view
+ircd::m::dbs::event_relates_key(const mutable_buffer &out_,
+                                const event::idx &target,
+                                const string_view &rel_type,
+                                const string_view &type,
+                                const event::idx &referer)
+{
+	assert(size(out_) >= EVENT_RELATES_KEY_MAX_SIZE);
+	mutable_buffer out{out_};
+	consume(out, copy(out, byte_view<string_view>(target)));
+
+	if(!rel_type)
+		return { data(out_), data(out) };
+
+	consume(out, copy(out, trunc(rel_type, event::TYPE_MAX_SIZE)));
+	consume(out, copy(out, '\0'));
+
+	if(!type)
+		return { data(out_), data(out) };
+
+	consume(out, copy(out, trunc(type, event::TYPE_MAX_SIZE)));
+	consume(out, copy(out, '\0'));
+	consume(out, copy(out, byte_view<string_view>(referer)));
+	return { data(out_), data(out) };
+}
+
+/// The amalgam here is the suffix of the key following the target event::idx.
+ircd::m::dbs::event_relates_count_tuple
+ircd::m::dbs::event_relates_count_key(const string_view &amalgam)
+{
+	const auto &[rel_type, post]
+	{
+		split(amalgam, '\0')
+	};
+
+	const auto &[type, key]
+	{
+		split(post, '\0')
+	};
+
+	return event_relates_count_tuple
+	{
+		rel_type, type, key
+	};
+}
+
+ircd::string_view
+ircd::m::dbs::event_relates_count_key(const mutable_buffer &out_,
+                                      const event::idx &target,
+                                      const string_view &rel_type,
+                                      const string_view &type,
+                                      const string_view &key)
+{
+	assert(size(out_) >= EVENT_RELATES_COUNT_KEY_MAX_SIZE);
+	mutable_buffer out{out_};
+	consume(out, copy(out, byte_view<string_view>(target)));
+
+	if(!rel_type)
+		return { data(out_), data(out) };
+
+	consume(out, copy(out, trunc(rel_type, event::TYPE_MAX_SIZE)));
+	consume(out, copy(out, '\0'));
+
+	if(!type)
+		return { data(out_), data(out) };
+
+	consume(out, copy(out, trunc(type, event::TYPE_MAX_SIZE)));
+	consume(out, copy(out, '\0'));
+	consume(out, copy(out, trunc(key, EVENT_RELATES_COUNT_ANNOTATION_MAX_SIZE)));
+	return { data(out_), data(out) };
+}
@@ -0,0 +1,157 @@
+// The Construct
+//
+// Copyright (C) The Construct Developers, Authors & Contributors
+// Copyright (C) 2016-2020 Jason Volk <jason@zemos.net>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice is present in all copies. The
+// full license for this software is available in the LICENSE file.
+
+decltype(ircd::m::dbs::user_sync)
+ircd::m::dbs::user_sync;
+
+decltype(ircd::m::dbs::desc::user_sync__block__size)
+ircd::m::dbs::desc::user_sync__block__size
+{
+	{ "name",     "ircd.m.dbs._user_sync.block.size" },
+	{ "default",  long(64_KiB)                       },
+};
+
+decltype(ircd::m::dbs::desc::user_sync__meta_block__size)
+ircd::m::dbs::desc::user_sync__meta_block__size
+{
+	{ "name",     "ircd.m.dbs._user_sync.meta_block.size" },
+	{ "default",  512L                                    },
+};
+
+decltype(ircd::m::dbs::desc::user_sync__cache__size)
+ircd::m::dbs::desc::user_sync__cache__size
+{
+	{
+		{ "name",     "ircd.m.dbs._user_sync.cache.size" },
+		{ "default",  long(0_MiB)                        },
+	}, []
+	{
+		const size_t &value{user_sync__cache__size};
+		db::capacity(db::cache(dbs::user_sync), value);
+	}
+};
+
+decltype(ircd::m::dbs::desc::user_sync__cache_comp__size)
+ircd::m::dbs::desc::user_sync__cache_comp__size
+{
+	{
+		{ "name",     "ircd.m.dbs._user_sync.cache_comp.size" },
+		{ "default",  long(0_MiB)                             },
+	}, []
+	{
+		const size_t &value{user_sync__cache_comp__size};
+		db::capacity(db::cache_compressed(dbs::user_sync), value);
+	}
+};
+
+decltype(ircd::m::dbs::desc::user_sync__bloom__bits)
+ircd::m::dbs::desc::user_sync__bloom__bits
+{
+	{ "name",     "ircd.m.dbs._user_sync.bloom.bits" },
+	{ "default",  0L                                 },
+};
+
+const ircd::db::prefix_transform
+ircd::m::dbs::desc::user_sync__pfx
+{
+	"_user_sync",
+
+	[](const string_view &key)
+	{
+		return has(key, "\0"_sv);
+	},
+
+	[](const string_view &key)
+	{
+		return split(key, '\0').first;
+	}
+};
+
+const ircd::db::descriptor
+ircd::m::dbs::desc::user_sync
+{
+	// name
+	"_user_sync",
+
+	// explanation
+	R"(Materialized initial /sync of a user.
+
+	[user_id | filter_id] => [sequence:u64][base:u64][JSON]
+
+	The JSON is a /sync response body composed at `sequence` without the
+	items which are specific to a device. The base is the sequence at which
+	the snapshot was last composed from scratch; the snapshot is otherwise
+	advanced by merging linear sync results. This is not indexed from events;
+	it is maintained by the client sync module.
+
+	)",
+
+	// typing (key, value)
+	{
+		typeid(string_view), typeid(string_view)
+	},
+
+	// options
+	{},
+
+	// comparator
+	{},
+
+	// prefix transform
+	user_sync__pfx,
+
+	// drop column
+	false,
+
+	// cache size
+	bool(cache_enable)? -1 : 0, //uses conf item
+
+	// cache size for compressed assets
+	bool(cache_comp_enable)? -1 : 0,
+
+	// bloom filter bits
+	size_t(user_sync__bloom__bits),
+
+	// expect queries hit
+	false,
+
+	// block size
+	size_t(user_sync__block__size),
+
+	// meta_block size
+	size_t(user_sync__meta_block__size),
+
+	// compression
+	"kLZ4Compression;kSnappyCompression"s,
+};
+
+//
+// key
+//
+
+ircd::string_view
+ircd::m::dbs::user_sync_key(const string_view &amalgam)
+{
+	return lstrip(amalgam, '\0');
+}
+
+ircd::string_view
+ircd::m::dbs::user_sync_key(const mutable_buffer &out_,
+                            const id::user &user_id,
+                            const string_view &filter_id)
+{
+	assert(size(filter_id) <= USER_SYNC_FILTER_MAX_SIZE);
+
+	mutable_buffer out{out_};
+	consume(out, copy(out, user_id));
+	consume(out, copy(out, '\0'));
+	consume(out, copy(out, filter_id));
+	return { data(out_), data(out) };
+}
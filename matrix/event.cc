@@ -1036,7 +1036,18 @@ ircd::m::exists(const id::event &event_id)
 		dbs::event_idx
 	};
 
-	return bool(event_id) && has(column, event_id);
+	if(!event_id || !dbs::event_idx_filter::maybe(event_id))
+		return false;
+
+	const bool ret
+	{
+		has(column, event_id)
+	};
+
+	if(!ret)
+		dbs::event_idx_filter::missed();
+
+	return ret;
 }
 
 bool
@@ -14,6 +14,9 @@ namespace ircd::m
 	extern const event::keys event_append_default_keys;
 	extern conf::item<bool> event_append_info;
 	extern log::log event_append_log;
+	extern conf::item<size_t> event_append_relations_scan_max;
+
+	static void event_append_relations(json::stack::object &, const event &, const event::idx &, const event::append::opts &);
 }
 
 decltype(ircd::m::event_append_log)
@@ -30,6 +33,13 @@ ircd::m::event_append_info
 	{ "persist",  false                      },
 };
 
+decltype(ircd::m::event_append_relations_scan_max)
+ircd::m::event_append_relations_scan_max
+{
+	{ "name",     "ircd.m.event.append.relations.scan.max" },
+	{ "default",  64L                                      },
+};
+
 /// Default event property mask of keys which we strip from the event sent
 /// to the client. This mask is applied only if the caller of event::append{}
 /// did not supply their mask to apply. It is also inferior to the user's
@@ -298,6 +308,14 @@ ircd::m::event::append::append(json::stack::object &object,
 			};
 		});
 
+	const bool query_relations
+	{
+		has_event_idx && opts.query_relations && !is_state
+	};
+
+	if(query_relations)
+		event_append_relations(unsigned_, event, *opts.event_idx, opts);
+
 	if(unlikely(event_append_info))
 		log::info
 		{
@@ -318,3 +336,194 @@ ircd::m::event::append::append(json::stack::object &object,
 }}
 {
 }
+
+/// Bundles the aggregations of relations to the event into its unsigned
+/// object. Annotations are reported from the counters; the latest edit and
+/// the thread summary need a short scan of the relations index which is
+/// bounded by the conf item.
+void
+ircd::m::event_append_relations(json::stack::object &unsigned_,
+                                const event &event,
+                                const event::idx &event_idx,
+                                const event::append::opts &opts)
+{
+	const event::relations relations
+	{
+		event_idx
+	};
+
+	if(!relations.has())
+		return;
+
+	const size_t scan_max
+	{
+		event_append_relations_scan_max
+	};
+
+	json::stack::object m_relations
+	{
+		unsigned_, "m.relations"
+	};
+
+	if(relations.has("m.annotation"))
+	{
+		json::stack::object m_annotation
+		{
+			m_relations, "m.annotation"
+		};
+
+		json::stack::array chunk
+		{
+			m_annotation, "chunk"
+		};
+
+		relations.for_each_count("m.annotation", [&chunk]
+		(const string_view &, const string_view &type, const string_view &key, const int64_t &count)
+		{
+			if(count <= 0)
+				return true;
+
+			json::stack::object annotation
+			{
+				chunk
+			};
+
+			json::stack::member
+			{
+				annotation, "type", type
+			};
+
+			json::stack::member
+			{
+				annotation, "key", key
+			};
+
+			json::stack::member
+			{
+				annotation, "count", json::value{count}
+			};
+
+			return true;
+		});
+	}
+
+	// Only edits made by the original sender are considered; the index is
+	// sorted from the most recent so the first found within a type wins.
+	event::idx replace_idx {0};
+	size_t scanned {0};
+	relations.for_each("m.replace", [&]
+	(const event::idx &relation_idx, const string_view &, const string_view &)
+	{
+		if(relation_idx <= replace_idx)
+			return ++scanned < scan_max;
+
+		m::get(std::nothrow, relation_idx, "sender", [&]
+		(const string_view &sender)
+		{
+			if(sender == json::get<"sender"_>(event))
+				replace_idx = relation_idx;
+		});
+
+		return ++scanned < scan_max;
+	});
+
+	if(replace_idx)
+	{
+		const event::fetch replace
+		{
+			std::nothrow, replace_idx
+		};
+
+		if(replace.valid)
+		{
+			json::stack::object m_replace
+			{
+				m_relations, "m.replace"
+			};
+
+			json::stack::member
+			{
+				m_replace, "event_id", replace.event_id
+			};
+
+			json::stack::member
+			{
+				m_replace, "origin_server_ts", json::value{json::get<"origin_server_ts"_>(replace)}
+			};
+
+			json::stack::member
+			{
+				m_replace, "sender", json::get<"sender"_>(replace)
+			};
+		}
+	}
+
+	const size_t thread_count
+	{
+		relations.count("m.thread")
+	};
+
+	if(!thread_count)
+		return;
+
+	event::idx latest_idx {0};
+	bool participated
+	{
+		opts.user_id && json::get<"sender"_>(event) == *opts.user_id
+	};
+
+	scanned = 0;
+	relations.for_each("m.thread", [&]
+	(const event::idx &relation_idx, const string_view &, const string_view &)
+	{
+		latest_idx = std::max(latest_idx, relation_idx);
+		if(opts.user_id && !participated)
+			m::get(std::nothrow, relation_idx, "sender", [&]
+			(const string_view &sender)
+			{
+				participated = sender == *opts.user_id;
+			});
+
+		return ++scanned < scan_max;
+	});
+
+	json::stack::object m_thread
+	{
+		m_relations, "m.thread"
+	};
+
+	const event::fetch latest
+	{
+		std::nothrow, latest_idx
+	};
+
+	if(latest.valid)
+	{
+		json::stack::object latest_event
+		{
+			m_thread, "latest_event"
+		};
+
+		event::append::opts _opts;
+		_opts.event_idx = &latest_idx;
+		_opts.user_id = opts.user_id;
+		_opts.user_room = opts.user_room;
+		_opts.keys = opts.keys;
+		_opts.query_txnid = false;
+		_opts.query_relations = false;
+		event::append
+		{
+			latest_event, latest, _opts
+		};
+	}
+
+	json::stack::member
+	{
+		m_thread, "count", json::value{long(thread_count)}
+	};
+
+	json::stack::member
+	{
+		m_thread, "current_user_participated", json::value{participated}
+	};
+}
@@ -46,6 +46,9 @@ ircd::m::cached(const event::idx &event_idx,
 		event_idx
 	};
 
+	if(event::fetch::should_seek_bin(opts) && db::cached(dbs::event_bin, key, opts.gopts))
+		return true;
+
 	if(event::fetch::should_seek_json(opts))
 		return db::cached(dbs::event_json, key, opts.gopts);
 
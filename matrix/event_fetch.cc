@@ -91,6 +91,11 @@ ircd::m::seek(std::nothrow_t,
 			if((fetch.valid = fetch.assign_from_row(key)))
 				return fetch.valid;
 
+	if(fetch.should_seek_bin(opts))
+		if((fetch.valid = fetch._bin.load(key, opts.gopts)))
+			if((fetch.valid = fetch.assign_from_bin(key)))
+				return fetch.valid;
+
 	if((fetch.valid = fetch._json.load(key, opts.gopts)))
 		fetch.valid = fetch.assign_from_json(key);
 
@@ -190,10 +195,18 @@ ircd::m::event::fetch::fetch(std::nothrow_t,
 {
 	event_idx
 }
+,_bin
+{
+	dbs::event_bin,
+	event_idx && should_seek_bin(opts)?
+		key(&event_idx):
+		string_view{},
+	opts.gopts
+}
 ,_json
 {
 	dbs::event_json,
-	event_idx && should_seek_json(opts)?
+	event_idx && should_seek_json(opts) && !_bin.valid(key(&event_idx))?
 		key(&event_idx):
 		string_view{},
 	opts.gopts
@@ -201,10 +214,10 @@ ircd::m::event::fetch::fetch(std::nothrow_t,
 ,row
 {
 	*dbs::events,
-	event_idx && !_json.valid(key(&event_idx))?
+	event_idx && !_bin.valid(key(&event_idx)) && !_json.valid(key(&event_idx))?
 		key(&event_idx):
 		string_view{},
-	event_idx && !_json.valid(key(&event_idx))?
+	event_idx && !_bin.valid(key(&event_idx)) && !_json.valid(key(&event_idx))?
 		event::keys{opts.keys}:
 		event::keys{event::keys::include{}},
 	cell,
@@ -222,6 +235,8 @@ ircd::m::event::fetch::fetch(std::nothrow_t,
 }
 {
 	valid =
+		event_idx && _bin.valid(key(&event_idx))?
+			assign_from_bin(key(&event_idx)):
 		event_idx && _json.valid(key(&event_idx))?
 			assign_from_json(key(&event_idx)):
 		event_idx?
@@ -235,6 +250,12 @@ ircd::m::event::fetch::fetch(const opts &opts)
 {
 	&opts
 }
+,_bin
+{
+	dbs::event_bin,
+	string_view{},
+	opts.gopts
+}
 ,_json
 {
 	dbs::event_json,
@@ -321,6 +342,42 @@ catch(const json::parse_error &e)
 	return false;
 }
 
+bool
+ircd::m::event::fetch::assign_from_bin(const string_view &key)
+{
+	auto &event
+	{
+		static_cast<m::event &>(*this)
+	};
+
+	assert(_bin.valid(key));
+	assert(fopts);
+	event.source = {};
+	if(unlikely(!dbs::event_bin_decode(event, _bin.val(), fopts->keys)))
+	{
+		log::critical
+		{
+			m::log, "Fetching event:%lu binary from local database :unrecognized encoding",
+			event_idx,
+		};
+
+		return false;
+	}
+
+	const auto event_id
+	{
+		!empty(json::get<"event_id"_>(event))?
+			id{json::get<"event_id"_>(event)}:
+		event_id_buf?
+			id{event_id_buf}:
+			m::event_id(std::nothrow, event_idx, event_id_buf)
+	};
+
+	assert(event_id);
+	event.event_id = event_id;
+	return true;
+}
+
 bool
 ircd::m::event::fetch::assign_from_row(const string_view &key)
 try
@@ -389,6 +446,20 @@ ircd::m::event::fetch::should_seek_json(const opts &opts)
 	return false;
 }
 
+/// The binary query substitutes for the json query when the format is
+/// enabled, unless the user forced the json query to get the source.
+bool
+ircd::m::event::fetch::should_seek_bin(const opts &opts)
+{
+	if(!dbs::event_bin_enable)
+		return false;
+
+	if(opts.query_json_force)
+		return false;
+
+	return should_seek_json(opts);
+}
+
 ircd::string_view
 ircd::m::event::fetch::key(const event::idx *const &event_idx)
 {
@@ -17,6 +17,7 @@ namespace ircd::m::dbs
 size_t
 ircd::m::event::horizon::rebuild()
 {
+	const ctx::this_ctx::background background;
 	m::dbs::write_opts opts;
 	opts.appendix.reset();
 	opts.appendix.set(dbs::appendix::EVENT_HORIZON);
@@ -29,6 +30,7 @@ ircd::m::event::horizon::rebuild()
 	m::events::for_each({0UL, -1UL}, [&ret, &txn, &opts]
 	(const m::event::idx &event_idx, const m::event &event)
 	{
+		ctx::this_ctx::yield_slice();
 		const m::event::prev prev
 		{
 			event
@@ -76,14 +76,25 @@ ircd::m::index(std::nothrow_t,
 	if(!event_id)
 		return false;
 
-	return column(event_id, std::nothrow, [&closure]
-	(const string_view &value)
+	if(!dbs::event_idx_filter::maybe(event_id))
+		return false;
+
+	const bool ret
 	{
-		const event::idx &event_idx
+		column(event_id, std::nothrow, [&closure]
+		(const string_view &value)
 		{
-			byte_view<event::idx>(value)
-		};
+			const event::idx &event_idx
+			{
+				byte_view<event::idx>(value)
+			};
 
-		closure(event_idx);
-	});
+			closure(event_idx);
+		})
+	};
+
+	if(!ret)
+		dbs::event_idx_filter::missed();
+
+	return ret;
 }
@@ -26,6 +26,14 @@ bool
 ircd::m::prefetch(const event::idx &event_idx,
                   const event::fetch::opts &opts)
 {
+	if(event::fetch::should_seek_bin(opts))
+	{
+		if(!event_idx)
+			return false;
+
+		return db::prefetch(dbs::event_bin, byte_view<string_view>{event_idx});
+	}
+
 	if(event::fetch::should_seek_json(opts))
 	{
 		if(!event_idx)
@@ -34,17 +34,27 @@ ircd::m::event::refs::rebuild()
 		column.begin()
 	};
 
+	ctx::pool::opts popts;
+	popts.nice = 4;
+
 	ctx::dock dock;
-	ctx::pool pool;
+	ctx::pool pool
+	{
+		"m.event.refs.rebuild", popts
+	};
+
 	pool.min(pool_size);
 
 	size_t i(0), j(0);
+	const ctx::this_ctx::background background;
 	const ctx::uninterruptible::nothrow ui;
 	for(; it; ++it)
 	{
 		if(ctx::interruption_requested())
 			break;
 
+		ctx::this_ctx::yield_slice();
+
 		const m::event::idx event_idx
 		{
 			byte_view<m::event::idx>(it->first)
@@ -0,0 +1,360 @@
+// The Construct
+//
+// Copyright (C) The Construct Developers, Authors & Contributors
+// Copyright (C) 2016-2020 Jason Volk <jason@zemos.net>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice is present in all copies. The
+// full license for this software is available in the LICENSE file.
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// event/relations.h
+//
+
+/// Indexes the m.relates_to of every event into event_relates. Events which
+/// were redacted are skipped. Relations already in the index are skipped by
+/// the indexer so their counters are not incremented again.
+void
+ircd::m::event::relations::rebuild()
+{
+	static const size_t pool_size{96};
+	static const size_t log_interval{8192};
+
+	db::txn txn
+	{
+		*m::dbs::events
+	};
+
+	auto &column
+	{
+		dbs::event_json
+	};
+
+	auto it
+	{
+		column.begin()
+	};
+
+	ctx::pool::opts popts;
+	popts.nice = 4;
+
+	ctx::dock dock;
+	ctx::pool pool
+	{
+		"m.event.relations.rebuild", popts
+	};
+
+	pool.min(pool_size);
+
+	size_t i(0), j(0);
+	const ctx::this_ctx::background background;
+	const ctx::uninterruptible::nothrow ui;
+	for(; it; ++it)
+	{
+		if(ctx::interruption_requested())
+			break;
+
+		ctx::this_ctx::yield_slice();
+
+		const m::event::idx event_idx
+		{
+			byte_view<m::event::idx>(it->first)
+		};
+
+		const json::object &source
+		{
+			it->second
+		};
+
+		// Cheap filter before dispatching to the pool; the indexer parses
+		// the content properly.
+		if(!ircd::has(source.get("content"), "m.relates_to"))
+			continue;
+
+		std::string event{it->second};
+		pool([&txn, &dock, &i, &j, event(std::move(event)), event_idx]
+		{
+			if(!m::redacted(event_idx))
+			{
+				m::dbs::write_opts wopts;
+				wopts.event_idx = event_idx;
+				wopts.appendix.reset();
+				wopts.appendix.set(dbs::appendix::EVENT_RELATES);
+				m::dbs::write(txn, json::object{event}, wopts);
+			}
+
+			if(++j % log_interval == 0) log::info
+			{
+				m::log, "Relations builder @%zu:%zu of %lu (@idx: %lu)",
+				i,
+				j,
+				m::vm::sequence::retired,
+				event_idx
+			};
+
+			if(j >= i)
+				dock.notify_one();
+		});
+
+		++i;
+	}
+
+	dock.wait([&i, &j]
+	{
+		return i == j;
+	});
+
+	txn();
+}
+
+bool
+ircd::m::event::relations::prefetch()
+const
+{
+	return prefetch(string_view{});
+}
+
+bool
+ircd::m::event::relations::prefetch(const string_view &rel_type)
+const
+{
+	if(unlikely(!idx))
+		return false;
+
+	char buf[dbs::EVENT_RELATES_COUNT_KEY_MAX_SIZE];
+	const string_view key
+	{
+		dbs::event_relates_count_key(buf, idx, rel_type)
+	};
+
+	return db::prefetch(dbs::event_relates_count, key);
+}
+
+bool
+ircd::m::event::relations::has()
+const
+{
+	return has(string_view{});
+}
+
+bool
+ircd::m::event::relations::has(const string_view &rel_type)
+const
+{
+	return !for_each(rel_type, []
+	(const event::idx &, const string_view &, const string_view &)
+	{
+		return false;
+	});
+}
+
+size_t
+ircd::m::event::relations::count()
+const
+{
+	return count(string_view{});
+}
+
+size_t
+ircd::m::event::relations::count(const string_view &rel_type)
+const
+{
+	int64_t ret(0);
+	for_each_count(rel_type, [&ret]
+	(const string_view &, const string_view &, const string_view &, const int64_t &count)
+	{
+		ret += std::max(count, 0L);
+		return true;
+	});
+
+	return ret;
+}
+
+int64_t
+ircd::m::event::relations::count(const string_view &rel_type,
+                                 const string_view &type,
+                                 const string_view &key)
+const
+{
+	assert(rel_type && type);
+	if(unlikely(!idx))
+		return 0;
+
+	char buf[dbs::EVENT_RELATES_COUNT_KEY_MAX_SIZE];
+	const string_view count_key
+	{
+		dbs::event_relates_count_key(buf, idx, rel_type, type, key)
+	};
+
+	int64_t ret(0);
+	dbs::event_relates_count(count_key, std::nothrow, [&ret]
+	(const string_view &value)
+	{
+		if(likely(value.size() >= sizeof(int64_t)))
+			ret = byte_view<int64_t>(value);
+	});
+
+	return ret;
+}
+
+bool
+ircd::m::event::relations::for_each_count(const count_closure &closure)
+const
+{
+	return for_each_count(string_view{}, string_view{}, closure);
+}
+
+bool
+ircd::m::event::relations::for_each_count(const string_view &rel_type,
+                                          const count_closure &closure)
+const
+{
+	return for_each_count(rel_type, string_view{}, closure);
+}
+
+bool
+ircd::m::event::relations::for_each_count(const string_view &rel_type,
+                                          const string_view &type,
+                                          const count_closure &closure)
+const
+{
+	if(unlikely(!idx))
+		return true;
+
+	char buf[dbs::EVENT_RELATES_COUNT_KEY_MAX_SIZE];
+	const string_view key
+	{
+		dbs::event_relates_count_key(buf, idx, rel_type, type)
+	};
+
+	auto it
+	{
+		dbs::event_relates_count.begin(key)
+	};
+
+	for(; it; ++it)
+	{
+		const auto &[_rel_type, _type, _key]
+		{
+			dbs::event_relates_count_key(it->first)
+		};
+
+		if(rel_type && rel_type != _rel_type)
+			break;
+
+		if(type && type != _type)
+			break;
+
+		const int64_t &count
+		{
+			it->second.size() >= sizeof(int64_t)?
+				int64_t(byte_view<int64_t>(it->second)):
+				0L
+		};
+
+		if(!closure(_rel_type, _type, _key, count))
+			return false;
+	}
+
+	return true;
+}
+
+bool
+ircd::m::event::relations::for_each(const closure &closure)
+const
+{
+	return for_each(string_view{}, string_view{}, 0UL, closure);
+}
+
+bool
+ircd::m::event::relations::for_each(const string_view &rel_type,
+                                    const closure &closure)
+const
+{
+	return for_each(rel_type, string_view{}, 0UL, closure);
+}
+
+bool
+ircd::m::event::relations::for_each(const string_view &rel_type,
+                                    const string_view &type,
+                                    const closure &closure)
+const
+{
+	return for_each(rel_type, type, 0UL, closure);
+}
+
+/// Iterate the relations to this event from the most recent to the least
+/// within each type. When `from` is given iteration starts at that referer
+/// (inclusive); its rel_type and type are used to find the position if
+/// `rel_type` or `type` are empty, without restricting the iteration to them.
+bool
+ircd::m::event::relations::for_each(const string_view &rel_type,
+                                    const string_view &type,
+                                    const event::idx &from,
+                                    const closure &closure)
+const
+{
+	if(unlikely(!idx))
+		return true;
+
+	char rel_type_buf[event::TYPE_MAX_SIZE];
+	string_view from_rel_type
+	{
+		rel_type
+	};
+
+	if(from && !rel_type)
+		m::get(std::nothrow, from, "content", [&from_rel_type, &rel_type_buf]
+		(const json::object &content)
+		{
+			const json::object &m_relates_to
+			{
+				content.get("m.relates_to")
+			};
+
+			from_rel_type = strlcpy
+			{
+				rel_type_buf, json::string{m_relates_to.get("rel_type")}
+			};
+		});
+
+	char type_buf[event::TYPE_MAX_SIZE];
+	const string_view &from_type
+	{
+		from && !type?
+			string_view{m::get(std::nothrow, from, "type", type_buf)}:
+			type
+	};
+
+	char buf[dbs::EVENT_RELATES_KEY_MAX_SIZE];
+	const string_view key
+	{
+		dbs::event_relates_key(buf, idx, from_rel_type, from_type, from?: -1UL)
+	};
+
+	auto it
+	{
+		dbs::event_relates.begin(key)
+	};
+
+	for(; it; ++it)
+	{
+		const auto &[_rel_type, _type, event_idx]
+		{
+			dbs::event_relates_key(it->first)
+		};
+
+		if(rel_type && rel_type != _rel_type)
+			break;
+
+		if(type && type != _type)
+			break;
+
+		if(!closure(event_idx, _rel_type, _type))
+			return false;
+	}
+
+	return true;
+}
@@ -11,8 +11,16 @@
 namespace ircd::m::events
 {
 	extern conf::item<size_t> dump_buffer_size;
+	extern conf::item<size_t> rebuild_bin_batch_size;
 }
 
+decltype(ircd::m::events::rebuild_bin_batch_size)
+ircd::m::events::rebuild_bin_batch_size
+{
+	{ "name",     "ircd.m.events.rebuild.bin.batch_size" },
+	{ "default",  8192L                                  },
+};
+
 decltype(ircd::m::events::dump_buffer_size)
 ircd::m::events::dump_buffer_size
 {
@@ -23,6 +31,7 @@ ircd::m::events::dump_buffer_size
 void
 ircd::m::events::rebuild()
 {
+	const ctx::this_ctx::background background;
 	static const event::fetch::opts fopts
 	{
 		event::keys::include {"type", "sender"}
@@ -47,6 +56,7 @@ ircd::m::events::rebuild()
 	for_each(range, [&txn, &wopts, &ret]
 	(const event::idx &event_idx, const m::event &event)
 	{
+		ctx::this_ctx::yield_slice();
 		wopts.event_idx = event_idx;
 		dbs::write(txn, event, wopts);
 		++ret;
@@ -84,6 +94,81 @@ ircd::m::events::rebuild()
 	};
 }
 
+/// Writes the binary encoding of every event from its JSON. The transaction
+/// is committed in batches to bound its size.
+void
+ircd::m::events::rebuild__bin()
+{
+	if(!dbs::event_bin_enable)
+		throw m::UNAVAILABLE
+		{
+			"The binary event format is not enabled (ircd.m.dbs._event_bin.enable)."
+		};
+
+	static const db::gopts gopts
+	{
+		db::get::NO_CACHE, db::get::NO_CHECKSUM
+	};
+
+	db::txn txn
+	{
+		*m::dbs::events
+	};
+
+	dbs::write_opts wopts;
+	wopts.appendix.reset();
+	wopts.appendix.set(dbs::appendix::EVENT_BIN);
+
+	size_t ret(0), err(0);
+	const ctx::this_ctx::background background;
+	for(auto it(dbs::event_json.begin(gopts)); it; ++it) try
+	{
+		ctx::this_ctx::yield_slice();
+		wopts.event_idx = byte_view<uint64_t>(it->first);
+		const json::object source
+		{
+			it->second
+		};
+
+		dbs::write(txn, m::event{source}, wopts);
+		if(++ret % size_t(rebuild_bin_batch_size) != 0)
+			continue;
+
+		txn();
+		txn.clear();
+		log::info
+		{
+			log, "Events binary rebuild %zu of %lu num:%zu err:%zu",
+			wopts.event_idx,
+			vm::sequence::retired,
+			ret,
+			err,
+		};
+	}
+	catch(const ctx::interrupted &)
+	{
+		throw;
+	}
+	catch(const std::exception &e)
+	{
+		++err;
+		log::error
+		{
+			log, "Events binary rebuild idx:%lu :%s",
+			wopts.event_idx,
+			e.what(),
+		};
+	}
+
+	txn();
+	log::notice
+	{
+		log, "Events binary rebuild complete num:%zu err:%zu",
+		ret,
+		err,
+	};
+}
+
 void
 ircd::m::events::dump__file(const string_view &filename)
 {
@@ -22,7 +22,16 @@ namespace ircd::m::fetch
 	extern ctx::dock dock;
 	extern ctx::mutex requests_mutex;
 	extern std::set<request, std::less<>> requests;
+	extern std::map<std::string, score, std::less<>> scores;
+	extern stats::histogram latency;
 	extern ctx::context request_context;
+	extern conf::item<milliseconds> hedge_delay_min;
+	extern conf::item<double> hedge_percentile;
+	extern conf::item<bool> hedge_enable;
+	extern conf::item<bool> select_weighted;
+	extern conf::item<milliseconds> score_prior;
+	extern conf::item<double> score_alpha;
+	extern conf::item<size_t> scores_max;
 	extern conf::item<size_t> backfill_limit_default;
 	extern conf::item<size_t> requests_max;
 	extern conf::item<seconds> timeout;
@@ -32,16 +41,29 @@ namespace ircd::m::fetch
 	static bool timedout(const request &, const system_point &now);
 	static void _check_event(const request &, const m::event &);
 	static void check_response(const request &, const json::object &);
+	static score &score_get(const string_view &origin);
+	static void score_error(const string_view &origin, const system_point &started, const string_view &error, const bool &timedout);
+	static void score_result(const string_view &origin, const system_point &started);
+	static double weight(const string_view &origin);
+	static bool viable(const request &, const string_view &origin);
 	static string_view select_origin(request &, const string_view &);
 	static string_view select_random_origin(request &);
+	static string_view select_weighted_origin(request &);
+	static string_view select_origin(request &);
+	static milliseconds hedge_delay();
+	static bool hedging(const request &, const system_point &now);
+	static void hedge_cancel(request &);
+	static void hedge_swap(request &);
+	static bool hedge(request &);
 	static void finish(request &);
 	static void retry(request &);
+	static std::unique_ptr<server::request> send(request &, const string_view &remote, const mutable_buffer &);
 	static bool start(request &, const string_view &remote);
 	static bool start(request &);
 	static void handle_result(request &);
 	static bool handle(request &);
 
-	static bool request_handle(const decltype(requests)::iterator &);
+	static bool request_handle(const decltype(requests)::iterator &, server::request &);
 	static void request_handle();
 	static size_t request_cleanup();
 	static void request_worker();
@@ -81,6 +103,88 @@ ircd::m::fetch::backfill_limit_default
 	{ "default",  96L                                   },
 };
 
+decltype(ircd::m::fetch::scores_max)
+ircd::m::fetch::scores_max
+{
+	{ "name",     "ircd.m.fetch.scores.max" },
+	{ "default",  4096L                     },
+};
+
+decltype(ircd::m::fetch::score_alpha)
+ircd::m::fetch::score_alpha
+{
+	{ "name",     "ircd.m.fetch.score.alpha" },
+	{ "default",  0.2                        },
+};
+
+decltype(ircd::m::fetch::score_prior)
+ircd::m::fetch::score_prior
+{
+	{ "name",         "ircd.m.fetch.score.prior" },
+	{ "default",      1000L                      },
+	{ "description",
+
+	R"(
+	Response time in milliseconds assumed for a server which has not responded
+	to us yet. Lower values favor trying unknown servers over known ones.
+	)"},
+};
+
+decltype(ircd::m::fetch::select_weighted)
+ircd::m::fetch::select_weighted
+{
+	{ "name",         "ircd.m.fetch.select.weighted" },
+	{ "default",      true                           },
+	{ "description",
+
+	R"(
+	true - Servers are selected at random weighted by their score; the weight
+	is the moving average of successful outcomes divided by the moving average
+	of response time.
+
+	false - Servers are selected uniformly at random.
+	)"},
+};
+
+decltype(ircd::m::fetch::hedge_enable)
+ircd::m::fetch::hedge_enable
+{
+	{ "name",         "ircd.m.fetch.hedge.enable" },
+	{ "default",      true                        },
+	{ "description",
+
+	R"(
+	When an attempt has not responded after the hedge delay, a second attempt
+	is made to the next selected server. The first to respond is used and the
+	other is canceled. The delay is the hedge.percentile of the response time
+	of all successful attempts, but not less than hedge.delay.min.
+	)"},
+};
+
+decltype(ircd::m::fetch::hedge_percentile)
+ircd::m::fetch::hedge_percentile
+{
+	{ "name",     "ircd.m.fetch.hedge.percentile" },
+	{ "default",  95.0                            },
+};
+
+decltype(ircd::m::fetch::hedge_delay_min)
+ircd::m::fetch::hedge_delay_min
+{
+	{ "name",     "ircd.m.fetch.hedge.delay.min" },
+	{ "default",  250L                           },
+};
+
+decltype(ircd::m::fetch::latency)
+ircd::m::fetch::latency
+{
+	{ "name", "ircd.m.fetch.latency"                                   },
+	{ "desc", "Milliseconds from start to success of a fetch attempt"  },
+};
+
+decltype(ircd::m::fetch::scores)
+ircd::m::fetch::scores;
+
 decltype(ircd::m::fetch::dock)
 ircd::m::fetch::dock;
 
@@ -267,22 +371,39 @@ ircd::m::fetch::request_handle()
 		fetch::dock
 	};
 
+	// A request may have a hedged attempt outstanding in addition to its
+	// primary attempt; each attempt is a leg waited on here.
+	using leg = std::pair<decltype(requests)::iterator, server::request *>;
+	std::vector<leg> legs;
+	legs.reserve(requests.size());
+	for(auto it(begin(requests)); it != end(requests); ++it)
+	{
+		auto &request(mutable_cast(*it));
+		if(request.future)
+			legs.emplace_back(it, request.future.get());
+
+		if(request.hedge)
+			legs.emplace_back(it, request.hedge.get());
+	}
+
 	static const auto dereferencer{[]
 	(auto &it) -> server::request &
 	{
-		// If the request doesn't have a server::request future attached
-		// during this pass we reference this default constructed static
-		// instance which when_any() will treat as a no-op.
-		static server::request request_skip;
-		auto &request(mutable_cast(*it));
-		return request.future?
-			*request.future:
-			request_skip;
+		return *it->second;
 	}};
 
 	auto next
 	{
-		ctx::when_any(requests.begin(), requests.end(), dereferencer)
+		ctx::when_any(legs.begin(), legs.end(), dereferencer)
+	};
+
+	// When hedging, the cleanup which starts the hedged attempts has to run
+	// at least as often as the hedge delay.
+	const milliseconds wait
+	{
+		hedge_enable?
+			std::min(milliseconds(seconds(timeout)), hedge_delay()):
+			milliseconds(seconds(timeout))
 	};
 
 	bool timedout{true};
@@ -292,7 +413,7 @@ ircd::m::fetch::request_handle()
 			lock
 		};
 
-		timedout = !next.wait(seconds(timeout), std::nothrow);
+		timedout = !next.wait(wait, std::nothrow);
 	};
 
 	if(likely(!timedout))
@@ -302,8 +423,8 @@ ircd::m::fetch::request_handle()
 			next.get()
 		};
 
-		if(it != end(requests))
-			if(!request_handle(it))
+		if(it != end(legs))
+			if(!request_handle(it->first, *it->second))
 				return;
 	}
 
@@ -311,13 +432,18 @@ ircd::m::fetch::request_handle()
 }
 
 bool
-ircd::m::fetch::request_handle(const decltype(requests)::iterator &it)
+ircd::m::fetch::request_handle(const decltype(requests)::iterator &it,
+                               server::request &leg)
 {
 	auto &request
 	{
 		mutable_cast(*it)
 	};
 
+	// The hedged attempt responded first; it becomes the primary attempt.
+	if(request.hedge.get() == &leg)
+		hedge_swap(request);
+
 	if(!request.finished)
 		if(!handle(request))
 			return false;
@@ -343,7 +469,13 @@ try
 			start(request);
 
 		else if(!request.finished && timedout(request, now))
+		{
+			score_error(request.origin, request.last, "timeout", true);
 			retry(request);
+		}
+
+		else if(!request.finished && hedging(request, now))
+			hedge(request);
 	}
 
 	auto it(begin(requests)); while(it != end(requests))
@@ -392,9 +524,9 @@ try
 		request.started = ircd::now<system_point>();
 
 	if(!request.origin)
-		select_random_origin(request);
+		request.origin = select_origin(request);
 
-	for(; request.origin; select_random_origin(request))
+	for(; request.origin; request.origin = select_origin(request))
 	{
 		if(start(request, request.origin))
 			return true;
@@ -436,57 +568,7 @@ try
 	if(!request.started)
 		request.started = request.last;
 
-	switch(request.opts.op)
-	{
-		case op::noop:
-			break;
-
-		case op::auth:
-		{
-			fed::event_auth::opts opts;
-			opts.remote = remote;
-			request.future = std::make_unique<fed::event_auth>
-			(
-				request.opts.room_id,
-				request.opts.event_id,
-				request.buf,
-				std::move(opts)
-			);
-
-			break;
-		}
-
-		case op::event:
-		{
-			fed::event::opts opts;
-			opts.remote = remote;
-			request.future = std::make_unique<fed::event>
-			(
-				request.opts.event_id,
-				request.buf,
-				std::move(opts)
-			);
-
-			break;
-		}
-
-		case op::backfill:
-		{
-			fed::backfill::opts opts;
-			opts.remote = remote;
-			opts.limit = request.opts.backfill_limit;
-			opts.limit = opts.limit?: size_t(backfill_limit_default);
-			opts.event_id = request.opts.event_id;
-			request.future = std::make_unique<fed::backfill>
-			(
-				request.opts.room_id,
-				request.buf,
-				std::move(opts)
-			);
-
-			break;
-		}
-	}
+	request.future = send(request, remote, request.buf);
 
 	log::debug
 	{
@@ -535,6 +617,7 @@ catch(const server::error &e)
 		e.what(),
 	};
 
+	score_error(remote, request.last, e.what(), false);
 	return false;
 }
 catch(const std::exception &e)
@@ -552,6 +635,118 @@ catch(const std::exception &e)
 	return false;
 }
 
+std::unique_ptr<ircd::server::request>
+ircd::m::fetch::send(request &request,
+                     const string_view &remote,
+                     const mutable_buffer &buf)
+{
+	switch(request.opts.op)
+	{
+		case op::noop:
+			break;
+
+		case op::auth:
+		{
+			fed::event_auth::opts opts;
+			opts.remote = remote;
+			return std::make_unique<fed::event_auth>
+			(
+				request.opts.room_id,
+				request.opts.event_id,
+				buf,
+				std::move(opts)
+			);
+		}
+
+		case op::event:
+		{
+			fed::event::opts opts;
+			opts.remote = remote;
+			return std::make_unique<fed::event>
+			(
+				request.opts.event_id,
+				buf,
+				std::move(opts)
+			);
+		}
+
+		case op::backfill:
+		{
+			fed::backfill::opts opts;
+			opts.remote = remote;
+			opts.limit = request.opts.backfill_limit;
+			opts.limit = opts.limit?: size_t(backfill_limit_default);
+			opts.event_id = request.opts.event_id;
+			return std::make_unique<fed::backfill>
+			(
+				request.opts.room_id,
+				buf,
+				std::move(opts)
+			);
+		}
+	}
+
+	return nullptr;
+}
+
+ircd::string_view
+ircd::m::fetch::select_origin(request &request)
+{
+	string_view ret;
+	if(select_weighted)
+		ret = select_weighted_origin(request);
+
+	// The weighted selection comes up empty if the origins of the room
+	// changed between its passes; the random selection is the fallback.
+	if(!ret)
+		ret = select_random_origin(request);
+
+	return ret;
+}
+
+ircd::string_view
+ircd::m::fetch::select_weighted_origin(request &request)
+{
+	const m::room::origins origins
+	{
+		request.opts.room_id
+	};
+
+	double sum(0.0);
+	origins.for_each(m::room::origins::closure{[&request, &sum]
+	(const string_view &origin)
+	{
+		if(viable(request, origin))
+			sum += weight(origin);
+	}});
+
+	if(!sum)
+		return {};
+
+	double select
+	{
+		sum * rand::integer(0, UINT32_MAX) / double(UINT32_MAX)
+	};
+
+	// copies the selected origin into the attempted set.
+	string_view ret;
+	origins.for_each(m::room::origins::closure_bool{[&request, &select, &ret]
+	(const string_view &origin)
+	{
+		if(!viable(request, origin))
+			return true;
+
+		select -= weight(origin);
+		if(select > 0.0)
+			return true;
+
+		ret = select_origin(request, origin);
+		return false;
+	}});
+
+	return ret;
+}
+
 ircd::string_view
 ircd::m::fetch::select_random_origin(request &request)
 {
@@ -561,34 +756,21 @@ ircd::m::fetch::select_random_origin(request &request)
 	};
 
 	// copies randomly selected origin into the attempted set.
-	const auto closure{[&request]
+	string_view ret;
+	const auto closure{[&request, &ret]
 	(const string_view &origin)
 	{
-		select_origin(request, origin);
+		ret = select_origin(request, origin);
 	}};
 
-	// Tests if origin is potentially viable
 	const auto proffer{[&request]
 	(const string_view &origin)
 	{
-		// Don't want to request from myself.
-		if(my_host(origin))
-			return false;
-
-		// Don't want to use a peer we already tried and failed with.
-		if(request.attempted.count(origin))
-			return false;
-
-		// Don't want to use a peer marked with an error by ircd::server
-		if(fed::errant(origin))
-			return false;
-
-		return true;
+		return viable(request, origin);
 	}};
 
-	request.origin = {};
 	origins.random(closure, proffer);
-	return request.origin;
+	return ret;
 }
 
 ircd::string_view
@@ -600,16 +782,292 @@ ircd::m::fetch::select_origin(request &request,
 		request.attempted.emplace(std::string{origin})
 	};
 
-	request.origin = *iit.first;
-	return request.origin;
+	return *iit.first;
+}
+
+/// Tests if origin is potentially viable
+bool
+ircd::m::fetch::viable(const request &request,
+                       const string_view &origin)
+{
+	// Don't want to request from myself.
+	if(my_host(origin))
+		return false;
+
+	// Don't want to use a peer we already tried and failed with.
+	if(request.attempted.count(origin))
+		return false;
+
+	// Don't want to use a peer marked with an error by ircd::server
+	if(fed::errant(origin))
+		return false;
+
+	return true;
+}
+
+/// Selection weight of an origin. Servers which have only failed retain a
+/// small weight so a recovery can eventually be noticed.
+double
+ircd::m::fetch::weight(const string_view &origin)
+{
+	const auto it
+	{
+		scores.find(origin)
+	};
+
+	const bool known
+	{
+		it != end(scores) && it->second.latency > 0.0
+	};
+
+	const double latency
+	{
+		known?
+			it->second.latency:
+			double(milliseconds(score_prior).count())
+	};
+
+	const double success
+	{
+		it != end(scores)?
+			it->second.success:
+			1.0
+	};
+
+	return std::max(success, 0.01) / std::max(latency, 1.0);
+}
+
+//
+// hedging
+//
+
+bool
+ircd::m::fetch::hedge(request &request)
+try
+{
+	assert(!request.finished);
+	assert(request.future && !request.hedge);
+
+	const string_view origin
+	{
+		select_origin(request)
+	};
+
+	if(!origin)
+		return false;
+
+	if(!request.hedge_buf)
+		request.hedge_buf = unique_buffer<mutable_buffer>
+		{
+			size(request.buf)
+		};
+
+	request.hedged = ircd::now<system_point>();
+	request.hedge = send(request, origin, request.hedge_buf);
+	request.hedge_origin = origin;
+
+	log::debug
+	{
+		log, "Hedging %s request for %s in %s from '%s' with '%s'",
+		reflect(request.opts.op),
+		string_view{request.opts.event_id},
+		string_view{request.opts.room_id},
+		string_view{request.origin},
+		string_view{request.hedge_origin},
+	};
+
+	dock.notify_all();
+	return true;
+}
+catch(const ctx::interrupted &e)
+{
+	throw;
+}
+catch(const std::exception &e)
+{
+	log::derror
+	{
+		log, "Hedging %s request for %s in %s :%s",
+		reflect(request.opts.op),
+		string_view{request.opts.event_id},
+		string_view{request.opts.room_id},
+		e.what(),
+	};
+
+	return false;
+}
+
+/// The hedged attempt takes the place of the primary attempt and vice versa.
+void
+ircd::m::fetch::hedge_swap(request &request)
+{
+	std::swap(request.future, request.hedge);
+	std::swap(request.origin, request.hedge_origin);
+	std::swap(request.last, request.hedged);
+	std::swap(request.buf, request.hedge_buf);
+}
+
+void
+ircd::m::fetch::hedge_cancel(request &request)
+{
+	if(!request.hedge)
+		return;
+
+	server::cancel(*request.hedge);
+	request.hedge.reset(nullptr);
+	request.hedge_origin = {};
+}
+
+bool
+ircd::m::fetch::hedging(const request &request,
+                        const system_point &now)
+{
+	if(!hedge_enable)
+		return false;
+
+	if(!request.future || request.hedge)
+		return false;
+
+	if(request.opts.attempt_limit && request.attempted.size() >= request.opts.attempt_limit)
+		return false;
+
+	return request.last + hedge_delay() < now;
+}
+
+ircd::milliseconds
+ircd::m::fetch::hedge_delay()
+{
+	// Until there is a useful sample of response times nothing is hedged
+	// earlier than it would have timed out.
+	if(latency.count.load(std::memory_order_relaxed) < 64)
+		return seconds(timeout);
+
+	const milliseconds pct
+	{
+		long(latency.percentile(hedge_percentile))
+	};
+
+	return std::max(pct, milliseconds(hedge_delay_min));
+}
+
+//
+// scoreboard
+//
+
+bool
+ircd::m::fetch::score::for_each(const closure &closure)
+{
+	for(const auto &[origin, score] : scores)
+		if(!closure(origin, score))
+			return false;
+
+	return true;
+}
+
+void
+ircd::m::fetch::score_result(const string_view &origin,
+                             const system_point &started)
+{
+	const auto elapsed
+	{
+		duration_cast<milliseconds>(ircd::now<system_point>() - started)
+	};
+
+	latency(elapsed.count());
+
+	const double alpha(score_alpha);
+	auto &score(score_get(origin));
+	score.latency = score.latency > 0.0?
+		alpha * elapsed.count() + (1.0 - alpha) * score.latency:
+		elapsed.count();
+
+	score.success = alpha + (1.0 - alpha) * score.success;
+	score.requests += 1;
+	score.last = ircd::now<system_point>();
+}
+
+void
+ircd::m::fetch::score_error(const string_view &origin,
+                            const system_point &started,
+                            const string_view &error,
+                            const bool &timedout)
+{
+	if(!origin)
+		return;
+
+	const auto elapsed
+	{
+		duration_cast<milliseconds>(ircd::now<system_point>() - started)
+	};
+
+	const double alpha(score_alpha);
+	auto &score(score_get(origin));
+
+	// An error response says nothing about how fast the server is, but the
+	// time spent waiting on a timeout does.
+	if(timedout)
+		score.latency = score.latency > 0.0?
+			alpha * elapsed.count() + (1.0 - alpha) * score.latency:
+			elapsed.count();
+
+	score.success = (1.0 - alpha) * score.success;
+	score.requests += 1;
+	score.errors += 1;
+	score.last = ircd::now<system_point>();
+	score.error = error;
+}
+
+ircd::m::fetch::score &
+ircd::m::fetch::score_get(const string_view &origin)
+{
+	const auto it
+	{
+		scores.find(origin)
+	};
+
+	if(it != end(scores))
+		return it->second;
+
+	// The scoreboard is full; the server heard from least recently is evicted.
+	if(scores.size() >= size_t(scores_max))
+	{
+		const auto oldest
+		{
+			std::min_element(begin(scores), end(scores), []
+			(const auto &a, const auto &b)
+			{
+				return a.second.last < b.second.last;
+			})
+		};
+
+		scores.erase(oldest);
+	}
+
+	const auto iit
+	{
+		scores.emplace(std::string{origin}, score{})
+	};
+
+	return iit.first->second;
 }
 
+
 bool
 ircd::m::fetch::handle(request &request)
 {
 	if(likely(request.future))
 		handle_result(request);
 
+	// The attempt failed while a hedged attempt is still outstanding; rather
+	// than starting another, the hedged attempt becomes the primary attempt.
+	if(request.eptr && request.hedge)
+	{
+		request.eptr = std::exception_ptr{};
+		hedge_swap(request);
+		hedge_cancel(request);
+		return false;
+	}
+
 	if(!request.eptr)
 		finish(request);
 	else
@@ -633,6 +1091,7 @@ try
 	};
 
 	check_response(request, content);
+	score_result(request.origin, request.last);
 
 	char pbuf[48];
 	log::debug
@@ -650,6 +1109,7 @@ try
 catch(...)
 {
 	request.eptr = std::current_exception();
+	score_error(request.origin, request.last, what(request.eptr), false);
 
 	log::derror
 	{
@@ -677,6 +1137,15 @@ try
 
 	request.eptr = std::exception_ptr{};
 	request.origin = {};
+
+	// A hedged attempt is still outstanding; it becomes the primary attempt
+	// rather than starting another.
+	if(request.hedge)
+	{
+		hedge_swap(request);
+		return;
+	}
+
 	start(request);
 }
 catch(...)
@@ -688,6 +1157,7 @@ catch(...)
 void
 ircd::m::fetch::finish(request &request)
 {
+	hedge_cancel(request);
 	request.finished = ircd::now<system_point>();
 
 	#if 0
@@ -1046,5 +1516,6 @@ ircd::m::fetch::request::~request()
 noexcept
 {
 	//TODO: bad things unless this first here
+	hedge.reset(nullptr);
 	future.reset(nullptr);
 }
@@ -28,6 +28,9 @@ ircd::m::gossip::gossip::gossip(const room::id &room_id,
 		opts.event_id
 	};
 
+	// Gossip is a courtesy to the remote; it never runs ahead of clients.
+	const ctx::this_ctx::background background;
+
 	const m::event::refs refs
 	{
 		m::index(std::nothrow, event_id)
@@ -84,10 +87,20 @@ ircd::m::gossip::gossip::gossip(const room::id &room_id,
 			top, "pdus"
 		};
 
-		m::event::fetch event;
+		// The source JSON is sent verbatim.
+		m::event::fetch::opts fopts;
+		fopts.query_json_force = true;
+		m::event::fetch event
+		{
+			fopts
+		};
+
 		for(assert(ret == 0); ret < i; ++ret)
+		{
+			ctx::this_ctx::yield_slice();
 			if(seek(std::nothrow, event, next_idx.at(ret)))
 				pdus.append(event.source);
+		}
 	}
 
 	const string_view txn
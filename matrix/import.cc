@@ -0,0 +1,459 @@
+// The Construct
+//
+// Copyright (C) The Construct Developers, Authors & Contributors
+// Copyright (C) 2016-2020 Jason Volk <jason@zemos.net>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice is present in all copies. The
+// full license for this software is available in the LICENSE file.
+
+namespace ircd::m::import
+{
+	using writer = db::database::sst::writer;
+
+	static event::idx sequence();
+	static size_t ingest(import &, db::txn &, const string_view &dir);
+	static void validate(import &, const opts &);
+}
+
+decltype(ircd::m::import::log)
+ircd::m::import::log
+{
+	"m.import"
+};
+
+decltype(ircd::m::import::batch_size)
+ircd::m::import::batch_size
+{
+	{ "name",     "ircd.m.import.batch.size" },
+	{ "default",  4096L                      },
+};
+
+decltype(ircd::m::import::buffer_size)
+ircd::m::import::buffer_size
+{
+	{ "name",     "ircd.m.import.buffer.size" },
+	{ "default",  long(4_MiB)                 },
+};
+
+decltype(ircd::m::import::buffer_max)
+ircd::m::import::buffer_max
+{
+	{ "name",     "ircd.m.import.buffer.max" },
+	{ "default",  long(64_MiB)               },
+};
+
+ircd::m::import::import::import(const string_view &path,
+                                const opts &opts)
+{
+	// The importer assigns the sequence numbers itself; evals are held from
+	// taking any for its duration. An eval already holding one would collide.
+	if(!vm::eval::list.empty() || vm::sequence::hold)
+		throw error
+		{
+			"Cannot import while %zu evaluations are in progress",
+			vm::eval::list.size(),
+		};
+
+	const scope_notify release
+	{
+		vm::sequence::dock
+	};
+
+	const scope_restore hold
+	{
+		vm::sequence::hold, true
+	};
+
+	// Sequence numbers reserved for a batch which was never ingested are
+	// given back.
+	const unwind unreserve{[]
+	{
+		vm::sequence::committed = vm::sequence::retired;
+		vm::sequence::uncommitted = vm::sequence::retired;
+	}};
+
+	const fs::fd file
+	{
+		path
+	};
+
+	const std::string dir
+	{
+		opts.dir?
+			std::string{opts.dir}:
+			fs::path_string(fs::path_views
+			{
+				fs::base::db, "import"
+			})
+	};
+
+	if(!fs::is_dir(dir))
+		fs::mkdir(dir);
+
+	const size_t batch_max
+	{
+		opts.batch?: size_t(batch_size)
+	};
+
+	unique_buffer<mutable_buffer> buf
+	{
+		size_t(buffer_size)
+	};
+
+	// The batch is composed in one transaction which is never committed; its
+	// contents are sorted into SST files instead. A second transaction holds
+	// only the event_id => event_idx mappings of the batch; the indexers
+	// consult it to resolve references between events within the batch.
+	db::txn txn
+	{
+		*dbs::events
+	};
+
+	db::txn idx
+	{
+		*dbs::events
+	};
+
+	// The event_ids in the batch, which aren't found in the database yet.
+	std::set<std::string, std::less<>> ids;
+
+	dbs::write_opts wopts;
+	wopts.interpose = &idx;
+	wopts.json_source = opts.json_source;
+
+	size_t count(0);
+	const auto flush{[&]
+	{
+		if(!count)
+			return;
+
+		files += ingest(*this, txn, dir);
+		dbs::event_idx_filter::add(idx);
+		imported += count;
+		batches += 1;
+		count = 0;
+
+		txn.clear();
+		idx.clear();
+		ids.clear();
+
+		// The batch is now visible in the database.
+		vm::sequence::retired = std::max(vm::sequence::retired, range.second);
+		vm::sequence::dock.notify_all();
+
+		log::info
+		{
+			log, "Imported %zu events in %zu batches and %zu files; read:%zu skipped:%zu idx:%lu",
+			imported,
+			batches,
+			files,
+			read,
+			skipped,
+			range.second,
+		};
+	}};
+
+	size_t foff(0);
+	while(!opts.limit || imported + count < opts.limit)
+	{
+		const string_view read
+		{
+			fs::read(file, buf, foff)
+		};
+
+		size_t boff(0);
+		json::vector vector
+		{
+			read
+		};
+
+		for(; boff < size(read) && (!opts.limit || imported + count < opts.limit); ) try
+		{
+			const json::object object
+			{
+				*begin(vector)
+			};
+
+			boff += size(string_view{object});
+			vector = json::vector
+			{
+				data(read) + boff, size(read) - boff
+			};
+
+			event::id::buf event_id;
+			const m::event event
+			{
+				event_id, object
+			};
+
+			this->read += 1;
+			if(!event.event_id || !json::get<"room_id"_>(event))
+			{
+				skipped += 1;
+				continue;
+			}
+
+			if(opts.exists && (m::exists(event.event_id) || ids.count(event.event_id)))
+			{
+				skipped += 1;
+				continue;
+			}
+
+			wopts.event_idx = sequence();
+			range.first = range.first?: wopts.event_idx;
+			range.second = wopts.event_idx;
+
+			// Any partial write is rolled back if the event can't be indexed.
+			{
+				const db::txn::checkpoint checkpoint
+				{
+					txn
+				};
+
+				dbs::write(txn, event, wopts);
+			}
+
+			db::txn::append
+			{
+				idx, dbs::event_idx,
+				{
+					db::op::SET,
+					string_view{event.event_id},
+					byte_view<string_view>(wopts.event_idx)
+				}
+			};
+
+			ids.emplace(event.event_id);
+			if(++count >= batch_max)
+				flush();
+		}
+		catch(const json::parse_error &e)
+		{
+			// Incomplete object at the end of the buffer; read again from it.
+			break;
+		}
+		catch(const ctx::interrupted &)
+		{
+			throw;
+		}
+		catch(const std::exception &e)
+		{
+			skipped += 1;
+			log::derror
+			{
+				log, "Skipping event at offset %zu :%s",
+				foff + boff,
+				e.what(),
+			};
+		}
+
+		foff += boff;
+		if(boff)
+			continue;
+
+		// Nothing more could be parsed from the buffer. At the end of the
+		// file only whitespace may remain; otherwise the object at this
+		// offset is truncated or doesn't fit and the buffer is grown for it.
+		if(read.find_first_not_of(" \t\r\n") == read.npos)
+			break;
+
+		if(size(read) < size(buf))
+			throw error
+			{
+				"Truncated or malformed event at offset %zu of `%s'",
+				foff,
+				path,
+			};
+
+		if(size(buf) >= size_t(buffer_max))
+			throw error
+			{
+				"Event at offset %zu of `%s' exceeds the maximum buffer of %s",
+				foff,
+				path,
+				pretty(iec(size_t(buffer_max))),
+			};
+
+		buf = unique_buffer<mutable_buffer>
+		{
+			std::min(size(buf) * 2, size_t(buffer_max))
+		};
+	}
+
+	flush();
+	validate(*this, opts);
+
+	log::notice
+	{
+		log, "Import of `%s' complete; imported:%zu skipped:%zu idx:%lu:%lu sampled:%zu failed:%zu",
+		path,
+		imported,
+		skipped,
+		range.first,
+		range.second,
+		sampled,
+		failed,
+	};
+}
+
+/// Reserve the next sequence number. Evals are held from sequencing while
+/// the import is in progress, so they are sequenced after it.
+ircd::m::event::idx
+ircd::m::import::sequence()
+{
+	const event::idx ret
+	{
+		++vm::sequence::committed
+	};
+
+	vm::sequence::uncommitted = std::max(vm::sequence::uncommitted, ret);
+	return ret;
+}
+
+size_t
+ircd::m::import::ingest(import &import,
+                        db::txn &txn,
+                        const string_view &dir)
+{
+	std::map<string_view, std::unique_ptr<writer>> writers;
+	db::for_each(txn, [&writers, &dir, &import]
+	(const db::delta &delta)
+	{
+		const auto &op(std::get<db::delta::OP>(delta));
+		const auto &col(std::get<db::delta::COL>(delta));
+		const auto &key(std::get<db::delta::KEY>(delta));
+		const auto &val(std::get<db::delta::VAL>(delta));
+
+		auto it
+		{
+			writers.lower_bound(col)
+		};
+
+		if(it == end(writers) || it->first != col)
+		{
+			db::column column
+			{
+				(*dbs::events)[col]
+			};
+
+			const string_view filename
+			{
+				fmt::sprintf
+				{
+					fs::name_scratch, "%s.%zu.sst",
+					db::name(column),
+					import.batches,
+				}
+			};
+
+			const auto path
+			{
+				fs::path_string(fs::path_views
+				{
+					dir, filename
+				})
+			};
+
+			auto _writer
+			{
+				std::make_unique<writer>(column, path)
+			};
+
+			it = writers.emplace_hint(it, db::name(column), std::move(_writer));
+		}
+
+		it->second->append(op, key, val);
+	});
+
+	size_t ret(0);
+	for(auto &[name, writer] : writers)
+	{
+		const auto info
+		{
+			writer->finish()
+		};
+
+		if(info.entries)
+		{
+			db::column column(writer->column);
+			db::ingest(column, info.path);
+			++ret;
+		}
+
+		fs::remove(std::nothrow, writer->path);
+	}
+
+	return ret;
+}
+
+void
+ircd::m::import::validate(import &import,
+                          const opts &opts)
+{
+	if(!opts.sample || !import.range.first)
+		return;
+
+	m::event::fetch event;
+	for(auto event_idx(import.range.first); event_idx <= import.range.second; event_idx += opts.sample)
+	{
+		// Sequence numbers of events which failed to index are skipped.
+		if(!seek(std::nothrow, event, event_idx))
+			continue;
+
+		const m::event::conforms report
+		{
+			event, vm::default_opts.non_conform.report
+		};
+
+		import.sampled += 1;
+		if(!report.clean())
+		{
+			import.failed += 1;
+			char buf[512];
+			log::error
+			{
+				log, "Imported event %s idx:%lu does not conform :%s",
+				string_view{event.event_id},
+				event_idx,
+				report.string(buf),
+			};
+
+			continue;
+		}
+
+		// The relation counters are written with merges which were resolved
+		// by the SST writer; they must agree with the relations indexed.
+		const m::event::relations relations
+		{
+			event_idx
+		};
+
+		size_t indexed(0);
+		relations.for_each([&indexed]
+		(const event::idx &, const string_view &, const string_view &)
+		{
+			++indexed;
+			return true;
+		});
+
+		const size_t counted
+		{
+			relations.count()
+		};
+
+		if(likely(counted == indexed))
+			continue;
+
+		import.failed += 1;
+		log::error
+		{
+			log, "Imported event %s idx:%lu relation counters:%zu indexed:%zu mismatch",
+			string_view{event.event_id},
+			event_idx,
+			counted,
+			indexed,
+		};
+	}
+}
@@ -271,7 +271,12 @@ catch(const ctx::timeout &e)
 
 namespace ircd::m
 {
+	static string_view keys_get_key(const mutable_buffer &, const string_view &, const string_view &);
+	static bool keys_get_remote(const string_view &, const string_view &, const keys::closure &);
+
 	extern conf::item<milliseconds> keys_get_timeout;
+	static std::set<std::string, std::less<>> keys_get_pending; // "server key_id"
+	static ctx::dock keys_get_dock;
 }
 
 decltype(ircd::m::keys_get_timeout)
@@ -318,11 +323,67 @@ try
 			server_name
 		};
 
-	log::debug
+	return keys_get_remote(server_name, key_id, closure);
+}
+catch(const ctx::timeout &e)
+{
+	throw m::error
 	{
-		log, "Keys for %s not cached; querying network...",
+		http::REQUEST_TIMEOUT, "M_TIMEOUT",
+		"Failed to fetch keys for '%s' in time",
 		server_name
 	};
+}
+
+/// Queries the server itself for its keys, bypassing the cache; the keys
+/// received are verified and cached.
+bool
+ircd::m::keys_get_remote(const string_view &server_name,
+                         const string_view &key_id,
+                         const keys::closure &closure)
+{
+	char keybuf[512];
+	const string_view &pending_key
+	{
+		keys_get_key(keybuf, server_name, key_id)
+	};
+
+	// Another context is already querying the network for this key; rather
+	// than making a duplicate request we wait for it and take its result.
+	if(keys_get_pending.count(pending_key))
+	{
+		log::debug
+		{
+			log, "Keys for %s (%s) already being queried; waiting...",
+			server_name,
+			key_id,
+		};
+
+		keys_get_dock.wait([&pending_key]
+		{
+			return !keys_get_pending.count(pending_key);
+		});
+
+		return keys::cache::get(server_name, key_id, closure);
+	}
+
+	const auto pending
+	{
+		keys_get_pending.emplace(pending_key).first
+	};
+
+	const unwind done{[&pending]
+	{
+		keys_get_pending.erase(pending);
+		keys_get_dock.notify_all();
+	}};
+
+	log::debug
+	{
+		log, "Keys for %s (%s) querying network...",
+		server_name,
+		key_id,
+	};
 
 	const unique_buffer<mutable_buffer> buf
 	{
@@ -367,20 +428,22 @@ try
 			server_name,
 		};
 
-		cache::set(keys);
+		keys::cache::set(keys);
 		closure(keys);
 		return true;
 	}
 
 	return false;
 }
-catch(const ctx::timeout &e)
+
+ircd::string_view
+ircd::m::keys_get_key(const mutable_buffer &buf,
+                      const string_view &server_name,
+                      const string_view &key_id)
 {
-	throw m::error
+	return fmt::sprintf
 	{
-		http::REQUEST_TIMEOUT, "M_TIMEOUT",
-		"Failed to fetch keys for '%s' in time",
-		server_name
+		buf, "%s %s", server_name, key_id
 	};
 }
 
@@ -493,6 +556,9 @@ ircd::m::keys::cache::set(const json::object &keys)
 	if(!exists(node_room.room_id))
 		create(node_room, me());
 
+	// Decoded keys for this server are stale now.
+	pk::clear(server_name);
+
 	const auto send_to_cache{[&node_room, &keys]
 	(const json::object::member &member)
 	{
@@ -584,6 +650,287 @@ ircd::m::keys::cache::for_each(const string_view &server_name,
 	});
 }
 
+//
+// m::keys::pk
+//
+
+decltype(ircd::m::keys::pk::cache_max)
+ircd::m::keys::pk::cache_max
+{
+	{ "name",     "ircd.keys.pk.cache.max" },
+	{ "default",  16384L                   },
+};
+
+decltype(ircd::m::keys::pk::negative_ttl)
+ircd::m::keys::pk::negative_ttl
+{
+	{ "name",     "ircd.keys.pk.negative.ttl" },
+	{ "default",  60L                         },
+};
+
+decltype(ircd::m::keys::pk::hits)
+ircd::m::keys::pk::hits
+{
+	{ "name", "ircd.keys.pk.hits"                                     },
+	{ "desc", "Number of public keys found decoded in the cache"      },
+};
+
+decltype(ircd::m::keys::pk::misses)
+ircd::m::keys::pk::misses
+{
+	{ "name", "ircd.keys.pk.misses"                                   },
+	{ "desc", "Number of public keys which had to be decoded"         },
+};
+
+decltype(ircd::m::keys::pk::negatives)
+ircd::m::keys::pk::negatives
+{
+	{ "name", "ircd.keys.pk.negatives"                                },
+	{ "desc", "Number of lookups answered by a negative entry"        },
+};
+
+decltype(ircd::m::keys::pk::cache)
+ircd::m::keys::pk::cache;
+
+decltype(ircd::m::keys::pk::lru)
+ircd::m::keys::pk::lru;
+
+namespace ircd::m
+{
+	static void keys_pk_decode(keys::pk::entry &, const string_view &key_id, const json::object &keys);
+	static void keys_pk_refresh(keys::pk::entry &, const string_view &server_name, const string_view &key_id);
+	static void keys_pk_insert(const string_view &key, keys::pk::entry);
+	static void keys_pk_touch(keys::pk::entry &);
+	static decltype(keys::pk::cache)::iterator keys_pk_erase(decltype(keys::pk::cache)::iterator);
+}
+
+bool
+ircd::m::keys::pk::get(const string_view &server_name,
+                       const string_view &key_id,
+                       const closure &closure)
+{
+	char keybuf[512];
+	const string_view &key
+	{
+		keys_get_key(keybuf, server_name, key_id)
+	};
+
+	auto it(cache.find(key));
+	if(it != end(cache) && !it->second.found)
+	{
+		if(it->second.expires > ircd::time<milliseconds>())
+		{
+			++negatives;
+			keys_pk_touch(it->second);
+			if(it->second.eptr)
+				std::rethrow_exception(it->second.eptr);
+
+			return false;
+		}
+
+		keys_pk_erase(it);
+		it = end(cache);
+	}
+
+	const bool refresh
+	{
+		it != end(cache)
+		&& it->second.valid_until_ts < ircd::time<milliseconds>()
+		&& it->second.expires <= ircd::time<milliseconds>()
+	};
+
+	if(it != end(cache) && !refresh)
+	{
+		// Copied out because the closure may yield and the entry could be
+		// invalidated by another context meanwhile.
+		const ed25519::pk pk
+		{
+			it->second.key
+		};
+
+		++hits;
+		keys_pk_touch(it->second);
+		closure(pk);
+		return true;
+	}
+
+	entry ent;
+	if(refresh)
+	{
+		++hits;
+		ent = it->second;
+	}
+	else try
+	{
+		++misses;
+		m::keys::get(server_name, key_id, [&ent, &key_id]
+		(const json::object &keys)
+		{
+			keys_pk_decode(ent, key_id, keys);
+		});
+	}
+	catch(const ctx::interrupted &)
+	{
+		throw;
+	}
+	catch(const std::exception &)
+	{
+		ent.eptr = std::current_exception();
+		ent.expires = ircd::time<milliseconds>() + milliseconds(seconds(negative_ttl)).count();
+		keys_pk_insert(key, ent);
+		throw;
+	}
+
+	if(ent.found && ent.valid_until_ts < ircd::time<milliseconds>())
+		keys_pk_refresh(ent, server_name, key_id);
+
+	if(!ent.found || ent.valid_until_ts < ircd::time<milliseconds>())
+		ent.expires = ircd::time<milliseconds>() + milliseconds(seconds(negative_ttl)).count();
+
+	keys_pk_insert(key, ent);
+	if(!ent.found)
+		return false;
+
+	closure(ent.key);
+	return true;
+}
+
+size_t
+ircd::m::keys::pk::clear(const string_view &server_name)
+{
+	char keybuf[512];
+	const string_view &prefix
+	{
+		keys_get_key(keybuf, server_name, string_view{})
+	};
+
+	size_t ret(0);
+	auto it(cache.lower_bound(prefix));
+	while(it != end(cache) && startswith(it->first, prefix))
+	{
+		it = keys_pk_erase(it);
+		++ret;
+	}
+
+	return ret;
+}
+
+bool
+ircd::m::keys::pk::for_each(const entry_closure &closure)
+{
+	for(const auto &[key, ent] : cache)
+		if(!closure(key, ent))
+			return false;
+
+	return true;
+}
+
+/// The key has expired; its server is asked for its current keys. When that
+/// fails or the key is still expired the one held is kept, since events
+/// signed while it was valid still verify with it.
+void
+ircd::m::keys_pk_refresh(keys::pk::entry &ent,
+                         const string_view &server_name,
+                         const string_view &key_id)
+try
+{
+	if(my_host(server_name))
+		return;
+
+	keys::pk::entry fresh;
+	keys_get_remote(server_name, key_id, [&fresh, &key_id]
+	(const json::object &keys)
+	{
+		keys_pk_decode(fresh, key_id, keys);
+	});
+
+	if(fresh.found)
+		ent = fresh;
+}
+catch(const ctx::interrupted &)
+{
+	throw;
+}
+catch(const std::exception &e)
+{
+	log::derror
+	{
+		log, "Failed to refresh expired key '%s' for '%s' :%s",
+		key_id,
+		server_name,
+		e.what(),
+	};
+}
+
+void
+ircd::m::keys_pk_decode(keys::pk::entry &ent,
+                        const string_view &key_id,
+                        const json::object &keys)
+{
+	const json::object &verify_keys
+	{
+		keys["verify_keys"]
+	};
+
+	const json::object &old_verify_keys
+	{
+		keys["old_verify_keys"]
+	};
+
+	const json::object &verify_key
+	{
+		verify_keys.has(key_id)?
+			verify_keys.get(key_id):
+			old_verify_keys.get(key_id)
+	};
+
+	const json::string &keyb64
+	{
+		verify_key["key"]
+	};
+
+	if(!keyb64)
+		return;
+
+	b64decode(ent.key, keyb64);
+	ent.valid_until_ts = keys.get<time_t>("valid_until_ts", 0L);
+	ent.found = true;
+}
+
+void
+ircd::m::keys_pk_insert(const string_view &key,
+                        keys::pk::entry ent)
+{
+	auto &cache(keys::pk::cache);
+	auto &lru(keys::pk::lru);
+
+	// Another context may have inserted this key while this one yielded.
+	auto it(cache.find(key));
+	if(it != end(cache))
+		keys_pk_erase(it);
+
+	while(!lru.empty() && cache.size() >= size_t(keys::pk::cache_max))
+		keys_pk_erase(cache.find(lru.front()));
+
+	it = cache.emplace(std::string(key), std::move(ent)).first;
+	it->second.lru = lru.emplace(end(lru), it->first);
+}
+
+void
+ircd::m::keys_pk_touch(keys::pk::entry &ent)
+{
+	auto &lru(keys::pk::lru);
+	lru.splice(end(lru), lru, ent.lru);
+}
+
+decltype(ircd::m::keys::pk::cache)::iterator
+ircd::m::keys_pk_erase(decltype(keys::pk::cache)::iterator it)
+{
+	assert(it != end(keys::pk::cache));
+	keys::pk::lru.erase(it->second.lru);
+	return keys::pk::cache.erase(it);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 // (internal) ed25519 support sanity test
@@ -98,19 +98,7 @@ ircd::m::node::keys::get(const string_view &key_id,
                          const ed25519_closure &closure)
 const
 {
-	return get(key_id, key_closure{[&closure]
-	(const json::string &keyb64)
-	{
-		const ed25519::pk pk
-		{
-			[&keyb64](auto &buf)
-			{
-				b64decode(buf, keyb64);
-			}
-		};
-
-		closure(pk);
-	}});
+	return m::keys::pk::get(node.node_id, key_id, closure);
 }
 
 bool
@@ -15,6 +15,8 @@ namespace ircd::m
 	static void check_room_auth_rule_6(const m::event &, room::auth::hookdata &);
 	static void check_room_auth_rule_3(const m::event &, room::auth::hookdata &);
 	static void check_room_auth_rule_2(const m::event &, room::auth::hookdata &);
+	static bool auth_chain_prev(const event::idx &, const event::closure_idx_bool &);
+	static bool auth_chain_walk(const event::idx &, const event::closure_idx_bool &);
 
 	extern hook::site<room::auth::hookdata &> room_auth_hook;
 }
@@ -808,7 +810,7 @@ ircd::m::room::auth::chain::depth()
 const
 {
 	size_t ret(0);
-	for_each([&ret](const auto &)
+	auth_chain_walk(idx, [&ret](const auto &)
 	{
 		++ret;
 		return true;
@@ -822,7 +824,7 @@ ircd::m::room::auth::chain::has(const string_view &type)
 const
 {
 	bool ret(false);
-	for_each([&type, &ret]
+	auth_chain_walk(idx, [&type, &ret]
 	(const auto &idx)
 	{
 		m::get(std::nothrow, idx, "type", [&type, &ret]
@@ -837,50 +839,123 @@ const
 	return ret;
 }
 
+bool
+ircd::m::room::auth::chain::has(const event::idx &event_idx)
+const
+{
+	return !auth_chain_walk(idx, [&event_idx]
+	(const auto &idx)
+	{
+		return idx != event_idx;
+	});
+}
+
 bool
 ircd::m::room::auth::chain::for_each(const closure &closure)
 const
 {
-	m::event::fetch e, a;
+	std::vector<event::idx> ae;
+	auth_chain_walk(idx, [&ae]
+	(const auto &idx)
+	{
+		ae.emplace_back(idx);
+		return true;
+	});
+
+	std::sort(begin(ae), end(ae));
+	for(const auto &idx : ae)
+		if(!closure(idx))
+			return false;
+
+	return true;
+}
+
+/// Breadth-first walk of the auth chain using the PREV_AUTH references; no
+/// events are fetched. Each event in the chain is given to the closure once
+/// in the order it is discovered; false from the closure stops the walk and
+/// returns false.
+bool
+ircd::m::auth_chain_walk(const event::idx &idx,
+                         const event::closure_idx_bool &closure)
+{
 	std::set<event::idx> ae;
 	std::deque<event::idx> aq {idx}; do
 	{
 		const auto idx(aq.front());
 		aq.pop_front();
-		if(!seek(std::nothrow, e, idx))
-			continue;
-
-		const m::event::prev prev{e};
-		for(size_t i(0); i < prev.auth_events_count() && i < 4; ++i)
+		const bool ok
 		{
-			const m::event::id &auth_event_id
-			{
-				prev.auth_event(i)
-			};
-
-			const auto &auth_event_idx
+			auth_chain_prev(idx, [&closure, &ae, &aq]
+			(const event::idx &auth_idx)
 			{
-				m::index(std::nothrow, auth_event_id)
-			};
-
-			if(!auth_event_idx)
-				continue;
+				auto it(ae.lower_bound(auth_idx));
+				if(it != end(ae) && *it == auth_idx)
+					return true;
+
+				ae.emplace_hint(it, auth_idx);
+				aq.emplace_back(auth_idx);
+				return closure(auth_idx);
+			})
+		};
 
-			auto it(ae.lower_bound(auth_event_idx));
-			if(it == end(ae) || *it != auth_event_idx)
-			{
-				seek(std::nothrow, a, auth_event_idx);
-				ae.emplace_hint(it, auth_event_idx);
-				if(a.valid)
-					aq.emplace_back(auth_event_idx);
-			}
-		}
+		if(!ok)
+			return false;
 	}
 	while(!aq.empty());
 
-	for(const auto &idx : ae)
-		if(!closure(idx))
+	return true;
+}
+
+/// Iterate the auth_events of an event by index. Events written before the
+/// PREV_AUTH references were made have none; for these the event is fetched
+/// and its auth_events are resolved instead. m.room.create is the only event
+/// properly without auth_events and takes that branch to no effect.
+bool
+ircd::m::auth_chain_prev(const event::idx &idx,
+                         const event::closure_idx_bool &closure)
+{
+	const event::refs refs
+	{
+		idx
+	};
+
+	bool found(false);
+	const bool ret
+	{
+		refs.for_each(dbs::ref::PREV_AUTH, [&closure, &found]
+		(const event::idx &auth_idx, const dbs::ref &)
+		{
+			found = true;
+			return closure(auth_idx);
+		})
+	};
+
+	if(found)
+		return ret;
+
+	const m::event::fetch event
+	{
+		std::nothrow, idx
+	};
+
+	if(!event.valid)
+		return true;
+
+	const m::event::prev prev
+	{
+		event
+	};
+
+	for(size_t i(0); i < prev.auth_events_count(); ++i)
+	{
+		const auto &auth_idx
+		{
+			m::index(std::nothrow, prev.auth_event(i))
+		};
+
+		if(auth_idx && !closure(auth_idx))
 			return false;
+	}
 
 	return true;
 }
@@ -11,19 +11,22 @@
 namespace ircd::m::bootstrap
 {
 	struct pkg;
+	struct reader;
+	struct pipeline;
 	using send_join_response = std::tuple<json::object, unique_buffer<mutable_buffer>>;
 
 	static event::id::buf make_join(const string_view &host, const room::id &, const user::id &, const mutable_buffer &);
-	static send_join_response send_join(const string_view &host, const room::id &, const event::id &, const json::object &event);
+	static send_join_response send_join(const string_view &host, const room::id &, const event::id &, const json::object &event, pipeline *const & = nullptr);
 	static void broadcast_join(const room &, const event &, const string_view &exclude);
 	static void fetch_keys(const json::array &events);
 	static void eval_auth_chain(const json::array &auth_chain, vm::opts);
-	static void eval_state(const json::array &state, vm::opts);
+	static void eval_state(const json::array &state, vm::opts, const std::set<std::string, std::less<>> &verified = {});
 	static void backfill(const string_view &host, const room::id &, const event::id &, vm::opts);
 	static void worker(pkg);
 
 	extern conf::item<seconds> make_join_timeout;
 	extern conf::item<seconds> send_join_timeout;
+	extern conf::item<bool> send_join_prefetch;
 	extern conf::item<seconds> backfill_timeout;
 	extern conf::item<size_t> backfill_limit;
 	extern log::log log;
@@ -37,6 +40,69 @@ struct ircd::m::bootstrap::pkg
 	std::string room_version;
 };
 
+/// Incremental reader for the arrays of a send_join response. The response
+/// is fed as it is received, in whatever fragments it arrives; each element
+/// of the auth_chain and state arrays is copied out and handed to the closure
+/// as soon as it is complete. Nothing else in the response is retained.
+struct ircd::m::bootstrap::reader
+{
+	using closure = std::function<void (const string_view &array, std::string &&)>;
+
+	closure emit;
+	std::vector<char> stack;
+	std::string key;
+	std::string element;
+	string_view array;
+	size_t depth {0};
+	bool quoted {false};
+	bool escaped {false};
+	bool keying {false};
+	bool expect_key {false};
+
+	void operator()(const string_view &);
+
+	reader(closure);
+};
+
+/// Evaluates the send_join response while it is still being received. The
+/// reader hands each event to a background context which fetches the keys
+/// that signed it, evaluates the auth_chain as the auth_events of each event
+/// become available, and verifies the signatures of the state; by the time a
+/// large response has finished downloading most of that work is done.
+struct ircd::m::bootstrap::pipeline
+{
+	struct item;
+	using key = std::pair<std::string, std::string>;
+
+	vm::opts vmopts;
+	bootstrap::reader reader;
+	std::deque<item> queue;
+	std::set<key> keys;
+	std::map<std::string, std::pair<std::string, size_t>, std::less<>> blocked;
+	std::multimap<std::string, std::string, std::less<>> dependents;
+	std::set<std::string, std::less<>> verified;
+	size_t received {0};
+	size_t evaluated {0};
+	size_t fetched {0};
+	bool done {false};
+	ctx::dock dock;
+	ctx::context worker;
+
+	void fetch_keys(const std::deque<item> &);
+	void eval_auth(std::string source);
+	void verify_state(const std::string &source);
+	void operator()(const const_buffer &, const const_buffer &) noexcept;
+	void work();
+
+	pipeline(const vm::opts &);
+};
+
+struct ircd::m::bootstrap::pipeline::item
+{
+	bool auth {false};
+	std::string source;
+};
+
 decltype(ircd::m::bootstrap::log)
 ircd::m::bootstrap::log
 {
@@ -71,6 +137,20 @@ ircd::m::bootstrap::send_join_timeout
 	{ "default",  90L  /* spinappse */                       },
 };
 
+decltype(ircd::m::bootstrap::send_join_prefetch)
+ircd::m::bootstrap::send_join_prefetch
+{
+	{ "name",         "ircd.client.rooms.join.send_join.prefetch" },
+	{ "default",      true                                        },
+	{ "description",
+
+	R"(
+	Fetch keys, evaluate the auth_chain and verify the state of the send_join
+	response while it is still being received rather than only after it has
+	been received in full.
+	)"}
+};
+
 decltype(ircd::m::bootstrap::make_join_timeout)
 ircd::m::bootstrap::make_join_timeout
 {
@@ -155,9 +235,11 @@ try
 		128_KiB
 	};
 
+	m::event::fetch::opts fopts;
+	fopts.query_json_force = true;
 	const m::event::fetch event
 	{
-		event_id
+		event_id, fopts
 	};
 	assert(event.valid);
 	assert(event.source);
@@ -224,10 +306,25 @@ try
 		host
 	};
 
+	m::vm::opts vmopts;
+	vmopts.infolog_accept = false;
+	vmopts.warnlog &= ~vm::fault::EXISTS;
+	vmopts.nothrows = -1;
+	vmopts.room_version = room_version;
+	vmopts.fetch_state = false;
+	vmopts.fetch_prev = false;
+
+	std::unique_ptr<m::bootstrap::pipeline> pipeline
+	{
+		m::bootstrap::send_join_prefetch?
+			std::make_unique<m::bootstrap::pipeline>(vmopts):
+			nullptr
+	};
+
 	assert(event.source);
 	const auto &[response, buf]
 	{
-		m::bootstrap::send_join(host, room_id, event_id, event.source)
+		m::bootstrap::send_join(host, room_id, event_id, event.source, pipeline.get())
 	};
 
 	const json::array &auth_chain
@@ -251,19 +348,34 @@ try
 		auth_chain.size(),
 	};
 
-	m::vm::opts vmopts;
-	vmopts.infolog_accept = false;
-	vmopts.warnlog &= ~vm::fault::EXISTS;
-	vmopts.nothrows = -1;
-	vmopts.room_version = room_version;
-	vmopts.fetch_state = false;
-	vmopts.fetch_prev = false;
+	// The pipeline finishes what it has already started; anything it missed
+	// is picked up by the complete pass over the response here. Events it
+	// has already evaluated are skipped as they exist.
+	std::set<std::string, std::less<>> verified;
+	if(pipeline)
+	{
+		pipeline->done = true;
+		pipeline->dock.notify_all();
+		pipeline->worker.join();
+		verified = std::move(pipeline->verified);
+		pipeline.reset();
+	}
 
 	m::bootstrap::fetch_keys(auth_chain);
+
+	// The keys for the state are fetched while the auth_chain is evaluated.
+	ctx::context state_keys
+	{
+		"m.bootstrap.keys", [&state]
+		{
+			m::bootstrap::fetch_keys(state);
+		}
+	};
+
 	m::bootstrap::eval_auth_chain(auth_chain, vmopts);
+	state_keys.join();
 
-	m::bootstrap::fetch_keys(state);
-	m::bootstrap::eval_state(state, vmopts);
+	m::bootstrap::eval_state(state, vmopts, verified);
 
 	m::bootstrap::backfill(host, room_id, event_id, vmopts);
 
@@ -505,18 +617,57 @@ catch(const std::exception &e)
 
 void
 ircd::m::bootstrap::eval_state(const json::array &state,
-                               vm::opts vmopts)
+                               vm::opts vmopts,
+                               const std::set<std::string, std::less<>> &verified)
 try
 {
 	log::info
 	{
-		log, "Evaluating %zu state events...",
+		log, "Evaluating %zu state events (%zu verified)...",
 		state.size(),
+		verified.size(),
+	};
+
+	if(verified.empty())
+	{
+		m::vm::eval
+		{
+			state, vmopts
+		};
+
+		return;
+	}
+
+	// The signatures of some of the state were already verified while the
+	// response was received; those are evaluated without verifying them
+	// again. The auth_events of the state are all in the auth_chain, so the
+	// two partitions do not depend on each other.
+	std::vector<m::event::id::buf> ids(state.size());
+	std::vector<m::event> events;
+	events.reserve(state.size());
+	for(const json::object &source : state)
+		events.emplace_back(ids.at(events.size()), source, vmopts.room_version);
+
+	std::sort(begin(events), end(events));
+	const size_t verified_count
+	(
+		std::distance(begin(events), std::stable_partition(begin(events), end(events), [&verified]
+		(const m::event &event)
+		{
+			return verified.count(string_view{event.event_id});
+		}))
+	);
+
+	auto noverify(vmopts);
+	noverify.verify = false;
+	m::vm::eval
+	{
+		vector_view<m::event>(events.data(), verified_count), noverify
 	};
 
 	m::vm::eval
 	{
-		state, vmopts
+		vector_view<m::event>(events.data() + verified_count, events.size() - verified_count), vmopts
 	};
 }
 catch(const std::exception &e)
@@ -612,11 +763,395 @@ catch(const std::exception &e)
 	//throw;
 }
 
+//
+// pipeline
+//
+
+ircd::m::bootstrap::pipeline::pipeline(const vm::opts &vmopts)
+:vmopts
+{
+	vmopts
+}
+,reader
+{
+	[this](const string_view &array, std::string &&source)
+	{
+		queue.emplace_back(item
+		{
+			array == "auth_chain", std::move(source)
+		});
+
+		++received;
+		dock.notify();
+	}
+}
+,worker
+{
+	"m.bootstrap.pipeline", 128_KiB, [this]
+	{
+		work();
+	}
+}
+{
+	this->vmopts.fetch = false;
+}
+
+void
+ircd::m::bootstrap::pipeline::work()
+{
+	while(!done)
+	{
+		dock.wait([this]
+		{
+			return done || !queue.empty();
+		});
+
+		// Whatever remains once the response is complete is left for the
+		// complete pass, which evaluates it all at once.
+		if(done)
+			break;
+
+		auto items
+		{
+			std::move(queue)
+		};
+
+		queue.clear();
+		fetch_keys(items);
+		for(auto &item : items) try
+		{
+			if(item.auth)
+				eval_auth(std::move(item.source));
+			else
+				verify_state(item.source);
+		}
+		catch(const ctx::interrupted &)
+		{
+			throw;
+		}
+		catch(const std::exception &e)
+		{
+			log::derror
+			{
+				log, "Pipeline %s event :%s",
+				item.auth? "auth_chain": "state",
+				e.what(),
+			};
+		}
+	}
+
+	log::debug
+	{
+		log, "Pipelined %zu of %zu events; evaluated:%zu verified:%zu blocked:%zu keys:%zu fetched:%zu",
+		evaluated + verified.size(),
+		received,
+		evaluated,
+		verified.size(),
+		blocked.size(),
+		keys.size(),
+		fetched,
+	};
+}
+
+void
+ircd::m::bootstrap::pipeline::fetch_keys(const std::deque<item> &items)
+try
+{
+	std::vector<m::fed::key::server_key> queries;
+	for(const auto &item : items)
+	{
+		const json::object &event
+		{
+			item.source
+		};
+
+		for(const auto &[server_name, signatures] : json::object(event["signatures"]))
+			for(const auto &[key_id, signature] : json::object(signatures))
+			{
+				const auto &[it, inserted]
+				{
+					keys.emplace(server_name, key_id)
+				};
+
+				if(inserted)
+					queries.emplace_back(it->first, it->second);
+			}
+	}
+
+	if(!queries.empty())
+		fetched += m::keys::fetch(queries);
+}
+catch(const ctx::interrupted &)
+{
+	throw;
+}
+catch(const std::exception &e)
+{
+	log::derror
+	{
+		log, "Error when fetching keys for %zu pipelined events :%s",
+		items.size(),
+		e.what(),
+	};
+}
+
+/// The auth_chain is not received in any particular order. An event is only
+/// evaluated once all of its auth_events exist; until then it waits on the
+/// first one missing, and is reconsidered when that one is evaluated.
+void
+ircd::m::bootstrap::pipeline::eval_auth(std::string source)
+{
+	std::vector<std::string> work;
+	work.emplace_back(std::move(source));
+	while(!work.empty())
+	{
+		std::string source
+		{
+			std::move(work.back())
+		};
+
+		work.pop_back();
+		m::event::id::buf event_id_buf;
+		const m::event event
+		{
+			event_id_buf, json::object{source}, vmopts.room_version
+		};
+
+		const m::event::prev prev
+		{
+			event
+		};
+
+		const std::string event_id
+		{
+			event.event_id
+		};
+
+		size_t missing(0);
+		for(size_t i(0); i < prev.auth_events_count(); ++i)
+			if(!m::exists(prev.auth_event(i)))
+			{
+				if(!missing++)
+					dependents.emplace(prev.auth_event(i), event_id);
+			}
+
+		if(missing)
+		{
+			blocked.emplace(event_id, std::make_pair(std::move(source), missing));
+			continue;
+		}
+
+		m::vm::eval
+		{
+			event, vmopts
+		};
+
+		if(!m::exists(event.event_id))
+			continue;
+
+		++evaluated;
+		const auto range
+		{
+			dependents.equal_range(event_id)
+		};
+
+		for(auto it(range.first); it != range.second; it = dependents.erase(it))
+		{
+			const auto bit
+			{
+				blocked.find(it->second)
+			};
+
+			if(bit == end(blocked))
+				continue;
+
+			work.emplace_back(std::move(bit->second.first));
+			blocked.erase(bit);
+		}
+	}
+}
+
+void
+ircd::m::bootstrap::pipeline::verify_state(const std::string &source)
+{
+	m::event::id::buf event_id_buf;
+	const m::event event
+	{
+		event_id_buf, json::object{source}, vmopts.room_version
+	};
+
+	if(m::verify(event))
+		verified.emplace(event.event_id);
+}
+
+/// Invoked by server:: as more of the response is received; this does not
+/// yield, it only copies out complete events and wakes the worker.
+void
+ircd::m::bootstrap::pipeline::operator()(const const_buffer &buffer,
+                                         const const_buffer &)
+noexcept try
+{
+	reader(string_view{buffer});
+}
+catch(const std::exception &e)
+{
+	log::derror
+	{
+		log, "Pipeline stopped reading after %zu events :%s",
+		received,
+		e.what(),
+	};
+
+	// The reader is out of step with the response; the rest is left for
+	// the complete pass.
+	reader.emit = {};
+	reader.depth = 0;
+}
+
+//
+// reader
+//
+
+ircd::m::bootstrap::reader::reader(closure emit)
+:emit
+{
+	std::move(emit)
+}
+{
+}
+
+void
+ircd::m::bootstrap::reader::operator()(const string_view &buf)
+{
+	if(!emit)
+		return;
+
+	for(const char &c : buf)
+	{
+		// A chunked response presents the chunk terminators here. Outside a
+		// string these are whitespace, and inside one they can only be the
+		// terminators because JSON does not allow them unescaped.
+		if(c == '\r' || c == '\n')
+			continue;
+
+		const bool inside
+		{
+			depth && stack.size() > depth
+		};
+
+		if(quoted)
+		{
+			if(inside)
+				element.push_back(c);
+			else if(keying)
+				key.push_back(c);
+
+			if(escaped)
+				escaped = false;
+			else if(c == '\\')
+				escaped = true;
+			else if(c == '"')
+			{
+				quoted = false;
+				if(keying)
+				{
+					keying = false;
+					key.pop_back();
+				}
+			}
+
+			continue;
+		}
+
+		switch(c)
+		{
+			case '"':
+				quoted = true;
+				if(inside)
+					element.push_back(c);
+				else if(expect_key)
+				{
+					keying = true;
+					key.clear();
+				}
+				break;
+
+			case '{':
+			case '[':
+				if(inside)
+					element.push_back(c);
+				else if(depth && stack.size() == depth)
+					element.assign(1, c);
+				else if(!depth && c == '[' && !stack.empty() && stack.size() <= 2 && stack.back() == '{')
+				{
+					// Only the members of the response object are considered;
+					// the same names can appear anywhere within an event.
+					array =
+						key == "auth_chain"? "auth_chain"_sv:
+						key == "state"? "state"_sv:
+						string_view{};
+
+					if(array)
+						depth = stack.size() + 1;
+				}
+
+				stack.push_back(c);
+				expect_key = c == '{';
+				break;
+
+			case '}':
+			case ']':
+				if(unlikely(stack.empty()))
+					throw m::BAD_JSON
+					{
+						"Unbalanced '%c' in response", c
+					};
+
+				if(inside)
+					element.push_back(c);
+
+				stack.pop_back();
+				expect_key = false;
+				if(depth && inside && stack.size() == depth)
+				{
+					emit(array, std::move(element));
+					element.clear();
+				}
+				else if(depth && stack.size() < depth)
+				{
+					depth = 0;
+					array = {};
+				}
+				break;
+
+			case ',':
+				if(inside)
+					element.push_back(c);
+				else
+					expect_key = !stack.empty() && stack.back() == '{';
+				break;
+
+			case ':':
+				if(inside)
+					element.push_back(c);
+				else
+					expect_key = false;
+				break;
+
+			default:
+				if(inside)
+					element.push_back(c);
+				break;
+		}
+	}
+}
+
 ircd::m::bootstrap::send_join_response
 ircd::m::bootstrap::send_join(const string_view &host,
                               const m::room::id &room_id,
                               const m::event::id &event_id,
-                              const json::object &event)
+                              const json::object &event,
+                              pipeline *const &pipeline)
 try
 {
 	const unique_buffer<mutable_buffer> buf
@@ -625,6 +1160,9 @@ try
 	};
 
 	m::fed::send_join::opts opts{host};
+	if(pipeline)
+		opts.in.progress = std::ref(*pipeline);
+
 	m::fed::send_join send_join
 	{
 		room_id, event_id, event, buf, std::move(opts)
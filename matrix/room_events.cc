@@ -15,6 +15,36 @@ ircd::m::room::events::viewport_size
 	{ "default",  48L                                },
 };
 
+decltype(ircd::m::room::events::readahead_min)
+ircd::m::room::events::readahead_min
+{
+	{ "name",     "ircd.m.room.events.readahead.min" },
+	{ "default",  4L                                 },
+};
+
+decltype(ircd::m::room::events::readahead_max)
+ircd::m::room::events::readahead_max
+{
+	{ "name",     "ircd.m.room.events.readahead.max" },
+	{ "default",  64L                                },
+};
+
+/// State for room::events::readahead(). The leading iterator runs ahead of
+/// the cursor in the direction of travel issuing a prefetch at each position.
+struct ircd::m::room::events::window
+{
+	db::domain::const_iterator it;      // leading iterator
+	size_t limit {0};                   // total positions the caller will visit
+	size_t count {0};                   // positions visited by the cursor
+	size_t ahead {0};                   // positions the leading iterator is ahead
+	bool ascending {false};             // direction of the leading iterator
+	bool stale {true};                  // leading iterator must restart at cursor
+	steady_point last;                  // time of the cursor's last move
+	microseconds interval {0us};        // smoothed interval between moves
+
+	size_t size() const;
+};
+
 std::pair<int64_t, ircd::m::event::idx>
 ircd::m::viewport(const room &room)
 {
@@ -307,6 +337,176 @@ ircd::m::room::events::events(const m::room &room,
 		seek(1);
 }
 
+ircd::m::room::events::~events()
+noexcept
+{
+}
+
+bool
+ircd::m::room::events::readahead(const size_t &limit,
+                                 const bool &ascending)
+{
+	if(!limit || !readahead_max)
+	{
+		_window.reset();
+		return false;
+	}
+
+	if(!_window)
+		_window = std::make_unique<window>();
+
+	auto &w(*_window);
+	w.limit = limit;
+	w.count = 0;
+	w.ahead = 0;
+	w.ascending = ascending;
+	w.stale = true;
+	w.interval = 0us;
+	w.last = now<steady_point>();
+
+	// Open the window from the current position; the cursor is included as
+	// it is the first event the caller will fetch.
+	advance(ascending);
+	w.count = 0;
+	w.interval = 0us;
+	return bool(*this);
+}
+
+void
+ircd::m::room::events::advance(const bool &ascending)
+{
+	assert(_window);
+	auto &w(*_window);
+
+	const auto now
+	{
+		ircd::now<steady_point>()
+	};
+
+	const auto elapsed
+	{
+		duration_cast<microseconds>(now - w.last)
+	};
+
+	w.interval = w.interval > 0us?
+		(w.interval * 3 + elapsed) / 4:
+		elapsed;
+
+	w.last = now;
+	++w.count;
+	if(!bool(*this))
+		return;
+
+	const size_t size
+	{
+		w.size()
+	};
+
+	if(!size)
+		return;
+
+	assert(_event.fopts);
+	const auto &fopts(*_event.fopts);
+
+	// Restart the leading iterator at the cursor when it was invalidated,
+	// when the caller turned around, or when the cursor overran it.
+	if(w.stale || w.ascending != ascending || (!w.ahead && w.it))
+	{
+		w.it = dbs::room_events.begin(it->first);
+		w.ascending = ascending;
+		w.stale = false;
+		w.ahead = 0;
+		if(w.it)
+			m::prefetch(std::get<1>(dbs::room_events_key(w.it->first)), fopts);
+	}
+	else if(w.ahead)
+		--w.ahead;
+
+	bool moved(false);
+	while(w.it && w.ahead < size)
+	{
+		if(ascending)
+			--w.it;
+		else
+			++w.it;
+
+		if(!w.it)
+			break;
+
+		const auto event_idx
+		{
+			std::get<1>(dbs::room_events_key(w.it->first))
+		};
+
+		m::prefetch(event_idx, fopts);
+		++w.ahead;
+		moved = true;
+	}
+
+	// Warm the room_events keys beyond the window for the leading iterator.
+	if(moved && w.it)
+	{
+		const auto depth
+		{
+			std::get<0>(dbs::room_events_key(w.it->first))
+		};
+
+		if(ascending)
+			preseek(depth + size);
+		else if(depth > size)
+			preseek(depth - size);
+	}
+}
+
+/// Number of positions to keep ahead of the cursor. This approximates the
+/// number of moves the caller makes during one database fetch, using the
+/// average latency measured by the db::prefetcher. Until the caller's pace is
+/// known the window is fully opened so the first page is requested at once.
+size_t
+ircd::m::room::events::window::size()
+const
+{
+	const auto *const ticker
+	{
+		db::prefetcher?
+			db::prefetcher->ticker.get():
+			nullptr
+	};
+
+	const microseconds latency
+	{
+		ticker && ticker->fetched?
+			ticker->accum_req_fin / long(ticker->fetched):
+			0us
+	};
+
+	const size_t moves
+	{
+		interval > 0us?
+			size_t(latency / interval) + 1:
+			-1UL
+	};
+
+	const size_t remain
+	{
+		limit > count?
+			limit - count:
+			0UL
+	};
+
+	const size_t max
+	{
+		std::min(size_t(readahead_max), remain)
+	};
+
+	const size_t min
+	{
+		std::min(size_t(readahead_min), max)
+	};
+
+	return std::clamp(moves, min, max);
+}
+
 bool
 ircd::m::room::events::prefetch()
 {
@@ -379,6 +579,9 @@ ircd::m::room::events::seek(const uint64_t &depth)
 	};
 
 	this->it = dbs::room_events.begin(seek_key);
+	if(_window)
+		_window->stale = true;
+
 	return bool(*this);
 }
 
@@ -400,6 +603,9 @@ try
 	};
 
 	this->it = dbs::room_events.begin(seek_key);
+	if(_window)
+		_window->stale = true;
+
 	if(!bool(*this))
 		return false;
 
@@ -589,6 +795,7 @@ namespace ircd::m::dbs
 size_t
 ircd::m::room::events::horizon::rebuild()
 {
+	const ctx::this_ctx::background background;
 	m::dbs::write_opts opts;
 	opts.appendix.reset();
 	opts.appendix.set(dbs::appendix::EVENT_HORIZON);
@@ -605,6 +812,7 @@ ircd::m::room::events::horizon::rebuild()
 
 	for(; it; --it)
 	{
+		ctx::this_ctx::yield_slice();
 		const m::event &event{*it};
 		const event::prev prev_events{event};
 
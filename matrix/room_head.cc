@@ -347,6 +347,7 @@ ircd::m::room::head::reset(const head &head)
 size_t
 ircd::m::room::head::rebuild(const head &head)
 {
+	const ctx::this_ctx::background background;
 	size_t ret{0};
 	static const m::event::fetch::opts fopts
 	{
@@ -370,6 +371,7 @@ ircd::m::room::head::rebuild(const head &head)
 	opts.op = db::op::SET;
 	for(; it; ++it)
 	{
+		ctx::this_ctx::yield_slice();
 		const m::event &event{*it};
 		opts.event_idx = it.event_idx();
 		opts.appendix.reset();
@@ -913,6 +913,7 @@ ircd::m::room::state::prev(const event::idx &event_idx,
 
 ircd::m::room::state::rebuild::rebuild(const room::id &room_id)
 {
+	const ctx::this_ctx::background background;
 	const m::event::id::buf event_id
 	{
 		m::head(room_id)
@@ -946,6 +947,7 @@ ircd::m::room::state::rebuild::rebuild(const room::id &room_id)
 	present_state.for_each([&opts, &txn, &deleted]
 	(const auto &type, const auto &state_key, const auto &event_idx)
 	{
+		ctx::this_ctx::yield_slice();
 		const m::event::fetch &event
 		{
 			std::nothrow, event_idx
@@ -966,6 +968,7 @@ ircd::m::room::state::rebuild::rebuild(const room::id &room_id)
 	history.for_each([&opts, &txn, &added, &room_id, &check_auth]
 	(const auto &type, const auto &state_key, const auto &depth, const auto &event_idx)
 	{
+		ctx::this_ctx::yield_slice();
 		const m::event::fetch &event
 		{
 			std::nothrow, event_idx
@@ -194,6 +194,7 @@ const
 
 ircd::m::room::state::space::rebuild::rebuild(const room::id &room_id)
 {
+	const ctx::this_ctx::background background;
 	db::txn txn
 	{
 		*m::dbs::events
@@ -215,6 +216,7 @@ ircd::m::room::state::space::rebuild::rebuild(const room::id &room_id)
 	size_t state_count(0), messages_count(0), state_deleted(0);
 	for(; it; ++it, ++messages_count) try
 	{
+		ctx::this_ctx::yield_slice();
 		const m::event::idx &event_idx
 		{
 			it.event_idx()
@@ -12,8 +12,13 @@ namespace ircd::m::rooms::summary
 {
 	static void chunk_remote(const room &, json::stack::object &o);
 	static void chunk_local(const room &, json::stack::object &o);
+	static size_t index_build();
+	static void index_ready();
 
 	extern hookfn<vm::eval &> create_public_room;
+	extern hookfn<vm::eval &> index_summary;
+	extern hookfn<vm::eval &> index_delist;
+	extern hookfn<vm::eval &> index_refresh;
 }
 
 /// Create the public rooms room during initial database bootstrap.
@@ -43,6 +48,359 @@ ircd::m::rooms::summary::create_public_room
 	}
 };
 
+/// Update the index from each summary set in the public rooms room.
+decltype(ircd::m::rooms::summary::index_summary)
+ircd::m::rooms::summary::index_summary
+{
+	{
+		{ "_site",       "vm.effect"           },
+		{ "room_id",     "!public"             },
+		{ "type",        "ircd.rooms.summary"  },
+	},
+	[](const m::event &event, m::vm::eval &)
+	{
+		const auto &[room_id, origin]
+		{
+			unmake_state_key(at<"state_key"_>(event))
+		};
+
+		index::set(room_id, origin, json::get<"content"_>(event));
+	}
+};
+
+/// Summaries are delisted by redacting them in the public rooms room.
+decltype(ircd::m::rooms::summary::index_delist)
+ircd::m::rooms::summary::index_delist
+{
+	{
+		{ "_site",       "vm.effect"         },
+		{ "room_id",     "!public"           },
+		{ "type",        "m.room.redaction"  },
+	},
+	[](const m::event &event, m::vm::eval &)
+	{
+		const auto event_idx
+		{
+			m::index(std::nothrow, at<"redacts"_>(event))
+		};
+
+		m::get(std::nothrow, event_idx, "state_key", []
+		(const string_view &state_key)
+		{
+			const auto &[room_id, origin]
+			{
+				unmake_state_key(state_key)
+			};
+
+			index::del(room_id, origin);
+		});
+	}
+};
+
+/// Recompute the chunk of a listed local room when its state changes; this
+/// includes memberships which change the ranking.
+decltype(ircd::m::rooms::summary::index_refresh)
+ircd::m::rooms::summary::index_refresh
+{
+	{
+		{ "_site",       "vm.effect"  },
+	},
+	[](const m::event &event, m::vm::eval &)
+	{
+		if(!defined(json::get<"state_key"_>(event)))
+			return;
+
+		index::refresh(m::room::id{at<"room_id"_>(event)});
+	}
+};
+
+//
+// rooms::summary::index
+//
+
+decltype(ircd::m::rooms::summary::index::enable)
+ircd::m::rooms::summary::index::enable
+{
+	{ "name",     "ircd.m.rooms.summary.index.enable" },
+	{ "default",  true                                },
+};
+
+decltype(ircd::m::rooms::summary::index::ranked)
+ircd::m::rooms::summary::index::ranked;
+
+decltype(ircd::m::rooms::summary::index::joined)
+ircd::m::rooms::summary::index::joined;
+
+decltype(ircd::m::rooms::summary::index::counts)
+ircd::m::rooms::summary::index::counts;
+
+decltype(ircd::m::rooms::summary::index::mutex)
+ircd::m::rooms::summary::index::mutex;
+
+decltype(ircd::m::rooms::summary::index::built)
+ircd::m::rooms::summary::index::built;
+
+/// Whether listings should be served from the index. A secondary instance
+/// doesn't evaluate the events which maintain it, so the index would only
+/// ever reflect the database as it was when first built.
+bool
+ircd::m::rooms::summary::index::available()
+{
+	return enable && !ircd::secondary;
+}
+
+bool
+ircd::m::rooms::summary::index::for_each(const string_view &origin,
+                                         const room::id &since,
+                                         const closure &closure)
+{
+	index_ready();
+	key start
+	{
+		origin, std::numeric_limits<long>::min(), std::string{}
+	};
+
+	if(since)
+	{
+		char state_key_buf[event::STATE_KEY_MAX_SIZE];
+		const auto it
+		{
+			joined.find(make_state_key(state_key_buf, since, origin))
+		};
+
+		if(it != end(joined))
+			start = key
+			{
+				origin, -it->second, since
+			};
+	}
+
+	auto it(ranked.lower_bound(start));
+	while(it != end(ranked) && std::get<0>(it->first) == origin)
+	{
+		// The closure may yield and the index may change meanwhile; the entry
+		// is copied and the iteration resumes after its key.
+		const auto entry
+		{
+			*it
+		};
+
+		const room::id room_id
+		{
+			std::get<2>(entry.first)
+		};
+
+		if(!closure(room_id, json::object{entry.second}))
+			return false;
+
+		it = ranked.upper_bound(entry.first);
+	}
+
+	return true;
+}
+
+size_t
+ircd::m::rooms::summary::index::count(const string_view &origin)
+{
+	index_ready();
+	const auto it
+	{
+		counts.find(origin)
+	};
+
+	return it != end(counts)?
+		it->second:
+		0UL;
+}
+
+size_t
+ircd::m::rooms::summary::index::rebuild()
+{
+	// Not given to yield_slice(); readers wait on the mutex throughout, as
+	// they do for the first build, once built is cleared.
+	const ctx::this_ctx::background background;
+	const std::lock_guard lock
+	{
+		mutex
+	};
+
+	built = false;
+	return index_build();
+}
+
+bool
+ircd::m::rooms::summary::index::refresh(const room &room)
+{
+	char state_key_buf[event::STATE_KEY_MAX_SIZE];
+	if(!joined.count(make_state_key(state_key_buf, room.room_id, my_host())))
+		return false;
+
+	const unique_buffer<mutable_buffer> buf
+	{
+		48_KiB
+	};
+
+	const json::object chunk
+	{
+		get(buf, room)
+	};
+
+	set(room.room_id, my_host(), chunk);
+	return true;
+}
+
+bool
+ircd::m::rooms::summary::index::del(const room::id &room_id,
+                                    const string_view &origin)
+{
+	char state_key_buf[event::STATE_KEY_MAX_SIZE];
+	const auto it
+	{
+		joined.find(make_state_key(state_key_buf, room_id, origin))
+	};
+
+	if(it == end(joined))
+		return false;
+
+	ranked.erase(key
+	{
+		origin, -it->second, room_id
+	});
+
+	joined.erase(it);
+	const auto cit
+	{
+		counts.find(origin)
+	};
+
+	assert(cit != end(counts));
+	if(cit != end(counts) && !--cit->second)
+		counts.erase(cit);
+
+	return true;
+}
+
+void
+ircd::m::rooms::summary::index::set(const room::id &room_id,
+                                    const string_view &origin,
+                                    const json::object &chunk)
+{
+	const long num
+	{
+		chunk.get<long>("num_joined_members", 0L)
+	};
+
+	char state_key_buf[event::STATE_KEY_MAX_SIZE];
+	const string_view state_key
+	{
+		make_state_key(state_key_buf, room_id, origin)
+	};
+
+	auto it
+	{
+		joined.lower_bound(state_key)
+	};
+
+	if(it != end(joined) && it->first == state_key)
+	{
+		ranked.erase(key
+		{
+			origin, -it->second, room_id
+		});
+
+		it->second = num;
+	}
+	else
+	{
+		joined.emplace_hint(it, std::string{state_key}, num);
+		auto cit(counts.lower_bound(origin));
+		if(cit == end(counts) || cit->first != origin)
+			cit = counts.emplace_hint(cit, std::string{origin}, 0UL);
+
+		++cit->second;
+	}
+
+	ranked.insert_or_assign(key
+	{
+		origin, -num, room_id
+	},
+	std::string{chunk});
+}
+
+void
+ircd::m::rooms::summary::index_ready()
+{
+	if(likely(index::built))
+		return;
+
+	const std::lock_guard lock
+	{
+		index::mutex
+	};
+
+	if(!index::built)
+		index_build();
+}
+
+size_t
+ircd::m::rooms::summary::index_build()
+{
+	assert(index::mutex.locked());
+	index::ranked.clear();
+	index::joined.clear();
+	index::counts.clear();
+
+	const m::room::id::buf public_room_id
+	{
+		"public", my_host()
+	};
+
+	const m::room::state state
+	{
+		public_room_id
+	};
+
+	const unique_buffer<mutable_buffer> buf
+	{
+		48_KiB
+	};
+
+	state.for_each("ircd.rooms.summary", [&buf]
+	(const string_view &type, const string_view &state_key, const event::idx &event_idx)
+	{
+		const auto &[room_id, origin]
+		{
+			unmake_state_key(state_key)
+		};
+
+		// Local rooms are summarized from their present state; the chunk in
+		// the summary event may be stale.
+		if(my_host(origin) && exists(room_id))
+		{
+			index::set(room_id, origin, get(buf, m::room{room_id}));
+			return true;
+		}
+
+		m::get(std::nothrow, event_idx, "content", [&room_id, &origin]
+		(const json::object &content)
+		{
+			index::set(room_id, origin, content);
+		});
+
+		return true;
+	});
+
+	index::built = true;
+	log::info
+	{
+		log, "Public rooms directory index built with %zu rooms from %zu servers",
+		index::ranked.size(),
+		index::counts.size(),
+	};
+
+	return index::ranked.size();
+}
+
 //
 // rooms::summary::fetch
 //
@@ -229,6 +229,10 @@ ircd::m::sync::item::item(std::string name,
 {
 	opts.get<bool>("phased", false)
 }
+,snapshot
+{
+	opts.get<bool>("snapshot", true)
+}
 {
 	log::debug
 	{
@@ -261,6 +265,9 @@ try
 	if(data.phased && !phased && int64_t(data.range.first) < 0)
 		return false;
 
+	if(data.snapshot && !snapshot)
+		return false;
+
 	#ifdef RB_DEBUG
 	sync::stats stats
 	{
@@ -342,6 +349,9 @@ try
 	if(!enable)
 		return false;
 
+	if(data.snapshot && !snapshot)
+		return false;
+
 	return _linear(data);
 }
 catch(const std::bad_function_call &e)
@@ -26,6 +26,23 @@ ircd::m::vm::default_copts;
 decltype(ircd::m::vm::default_opts)
 ircd::m::vm::default_opts;
 
+namespace ircd::m::vm
+{
+	extern conf::item<milliseconds> secondary_interval;
+	static void secondary_worker();
+
+	static ctx::context secondary_context;
+}
+
+/// Period between attempts by a secondary instance to catch up with the
+/// primary. This bounds the staleness of what the secondary serves.
+decltype(ircd::m::vm::secondary_interval)
+ircd::m::vm::secondary_interval
+{
+	{ "name",     "ircd.m.vm.secondary.interval" },
+	{ "default",  1000L                          },
+};
+
 //
 // init
 //
@@ -40,6 +57,12 @@ ircd::m::vm::init::init()
 	vm::ready = true;
 	vm::dock.notify_all();
 
+	if(ircd::secondary)
+		secondary_context = ctx::context
+		{
+			"m.vm.secondary", 512_KiB, secondary_worker, ctx::context::POST
+		};
+
 	log::info
 	{
 		log, "BOOT %s @%lu [%s] db:%lu",
@@ -55,6 +78,8 @@ ircd::m::vm::init::init()
 ircd::m::vm::init::~init()
 noexcept
 {
+	// Terminates and joins the catch-up worker.
+	secondary_context = ctx::context{};
 	vm::ready = false;
 
 	if(!eval::list.empty())
@@ -110,6 +135,55 @@ noexcept
 	assert(retired == sequence::retired);
 }
 
+/// Worker for a secondary instance. Periodically replays the primary's writes
+/// into the events database and advances the sequence counters so that the
+/// newly visible events are served.
+void
+ircd::m::vm::secondary_worker()
+{
+	while(1) try
+	{
+		ctx::sleep(milliseconds(secondary_interval));
+		db::catchup(*dbs::events);
+
+		event::id::buf event_id;
+		const auto retired
+		{
+			sequence::get(event_id)
+		};
+
+		if(retired <= sequence::retired)
+			continue;
+
+		log::debug
+		{
+			log, "Caught up with primary @%lu -> @%lu [%s] db:%lu",
+			sequence::retired,
+			retired,
+			string_view{event_id},
+			db::sequence(*dbs::events),
+		};
+
+		sequence::retired = retired;
+		sequence::committed = retired;
+		sequence::uncommitted = retired;
+		sequence::dock.notify_all();
+		vm::dock.notify_all();
+	}
+	catch(const ctx::interrupted &)
+	{
+		throw;
+	}
+	catch(const std::exception &e)
+	{
+		log::error
+		{
+			log, "Failed to catch up with primary :%s",
+			e.what()
+		};
+	}
+}
+
 //
 // m/vm.h
 //
@@ -190,6 +264,9 @@ ircd::m::vm::sequence::committed;
 decltype(ircd::m::vm::sequence::uncommitted)
 ircd::m::vm::sequence::uncommitted;
 
+decltype(ircd::m::vm::sequence::hold)
+ircd::m::vm::sequence::hold;
+
 uint64_t
 ircd::m::vm::sequence::min()
 {
@@ -12,6 +12,7 @@ namespace ircd::m::vm
 {
 	template<class... args> static fault handle_error(const opts &, const fault &, const string_view &fmt, args&&... a);
 	template<class T> static void call_hook(hook::site<T> &, eval &, const event &, T&& data);
+	static stats::histogram &phase_histogram(const hook::base::site &);
 	static size_t calc_txn_reserve(const opts &, const event &);
 	static void write_commit(eval &);
 	static void write_append(eval &, const event &);
@@ -36,8 +37,14 @@ namespace ircd::m::vm
 	extern conf::item<bool> log_commit_debug;
 	extern conf::item<bool> log_accept_debug;
 	extern conf::item<bool> log_accept_info;
+
+	/// Time spent in each phase in microseconds, keyed by the hook site.
+	extern std::map<const hook::base::site *, std::unique_ptr<stats::histogram>> phase_histograms;
 }
 
+decltype(ircd::m::vm::phase_histograms)
+ircd::m::vm::phase_histograms;
+
 decltype(ircd::m::vm::log_commit_debug)
 ircd::m::vm::log_commit_debug
 {
@@ -548,6 +555,13 @@ ircd::m::vm::execute_pdu(eval &eval,
 			};
 	}
 
+	// Wait while something else is assigning sequence numbers (i.e. a bulk
+	// import); none may be taken by an eval in the meantime.
+	sequence::dock.wait([]
+	{
+		return !sequence::hold;
+	});
+
 	// Obtain sequence number here.
 	const auto *const &top(eval::seqmax());
 	eval.sequence_shared[0] = 0;
@@ -819,6 +833,7 @@ ircd::m::vm::write_commit(eval &eval)
 	#endif
 
 	txn();
+	dbs::event_idx_filter::add(txn);
 
 	#ifdef RB_DEBUG
 	const auto db_seq_after(db::sequence(*m::dbs::events));
@@ -874,6 +889,17 @@ try
 		eval.phase, std::addressof(hook)
 	};
 
+	auto &histogram
+	{
+		phase_histogram(hook)
+	};
+
+	const ircd::timer timer;
+	const unwind timed{[&histogram, &timer]
+	{
+		histogram(timer.at<microseconds>().count());
+	}};
+
 	hook(event, std::forward<T>(data));
 
 	#if 0
@@ -925,6 +951,37 @@ catch(const std::exception &e)
 	throw;
 }
 
+/// The histogram for the phase is registered on first use as
+/// ircd.m.<site name>, e.g. ircd.m.vm.eval.
+ircd::stats::histogram &
+ircd::m::vm::phase_histogram(const hook::base::site &site)
+{
+	auto it
+	{
+		phase_histograms.lower_bound(&site)
+	};
+
+	if(it == end(phase_histograms) || it->first != &site)
+	{
+		char buf[128];
+		const string_view name
+		{
+			fmt::sprintf
+			{
+				buf, "ircd.m.%s", site.name()
+			}
+		};
+
+		it = phase_histograms.emplace_hint(it, &site, std::make_unique<stats::histogram>(json::members
+		{
+			{ "name", name }
+		}));
+	}
+
+	assert(it->second);
+	return *it->second;
+}
+
 template<class... args>
 ircd::m::vm::fault
 ircd::m::vm::handle_error(const vm::opts &opts,
@@ -159,6 +159,15 @@ get__publicrooms(client &client,
 		since,
 	};
 
+	// Unfiltered listings are served from the ranked directory index.
+	const bool indexed
+	{
+		m::rooms::summary::index::available()
+		&& !opts.search_term
+		&& !opts.room_alias
+		&& !opts.user_id
+	};
+
 	size_t count{0};
 	m::room::id::buf prev_batch_buf; //TODO: XXX
 	m::room::id::buf next_batch_buf;
@@ -166,18 +175,33 @@ get__publicrooms(client &client,
 	{
 		json::stack::member chunk_m{top, "chunk"};
 		json::stack::array chunk{chunk_m};
-		m::rooms::for_each(opts, [&](const m::room::id &room_id)
-		{
-			if(++count > limit)
+		if(indexed)
+			m::rooms::summary::index::for_each(opts.server, since, [&]
+			(const m::room::id &room_id, const json::object &summary)
+			{
+				if(++count > limit)
+				{
+					next_batch_buf = room_id;
+					return false;
+				}
+
+				json::stack::object obj{chunk};
+				obj.append(summary);
+				return true;
+			});
+		else
+			m::rooms::for_each(opts, [&](const m::room::id &room_id)
 			{
-				next_batch_buf = room_id;
-				return false;
-			}
-
-			json::stack::object obj{chunk};
-			m::rooms::summary::get(obj, room_id);
-			return true;
-		});
+				if(++count > limit)
+				{
+					next_batch_buf = room_id;
+					return false;
+				}
+
+				json::stack::object obj{chunk};
+				m::rooms::summary::get(obj, room_id);
+				return true;
+			});
 	}
 
 	// To count the total we clear the since token, otherwise the count
@@ -185,7 +209,9 @@ get__publicrooms(client &client,
 	opts.room_id = {};
 	const size_t total_rooms_count_estimate
 	{
-		m::rooms::count(opts)
+		indexed?
+			m::rooms::summary::index::count(opts.server):
+			m::rooms::count(opts)
 	};
 
 	json::stack::member
@@ -168,6 +168,7 @@ get__context(client &client,
 		if(before)
 			--before;
 
+		before.readahead(limit);
 		for(size_t i(0); i < limit && before; --before, ++i)
 		{
 			const m::event &event{*before};
@@ -208,6 +209,7 @@ get__context(client &client,
 		if(after)
 			++after;
 
+		after.readahead(limit, true);
 		for(size_t i(0); i < limit && after; ++after, ++i)
 		{
 			const m::event &event{*after};
@@ -131,6 +131,7 @@ get__messages(client &client,
 		room
 	};
 
+	it.readahead(page.limit, page.dir != 'b');
 	for(; it; page.dir == 'b'? --it : ++it)
 	{
 		const m::event &event
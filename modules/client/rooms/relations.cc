@@ -12,13 +12,29 @@
 
 using namespace ircd;
 
-static void
+conf::item<size_t>
+relations_limit_default
+{
+	{ "name",     "ircd.client.rooms.relations.limit.default" },
+	{ "default",  32L                                         },
+};
+
+conf::item<size_t>
+relations_limit_max
+{
+	{ "name",     "ircd.client.rooms.relations.limit.max" },
+	{ "default",  256L                                  },
+};
+
+static m::event::idx
 relations_chunk(client &client,
                 const m::resource::request &request,
                 const m::room::id &room_id,
-                const m::event::id &event_id,
+                const m::event::idx &event_idx,
                 const string_view &rel_type,
                 const string_view &type,
+                const m::event::idx &from,
+                const size_t &limit,
                 json::stack::array &chunk);
 
 m::resource::response
@@ -80,6 +96,70 @@ get__relations(client &client,
 		url::decode(type_buf, request.parv[4])
 	};
 
+	const m::event::idx event_idx
+	{
+		index(std::nothrow, event_id)
+	};
+
+	const m::event::fetch event
+	{
+		std::nothrow, event_idx
+	};
+
+	if(!event.valid || !visible(event, request.user_id))
+		throw m::NOT_FOUND
+		{
+			"Cannot get relations about %s which is not found.",
+			string_view{event_id}
+		};
+
+	const size_t limit
+	{
+		std::min(request.query.get<size_t>("limit", size_t(relations_limit_default)), size_t(relations_limit_max))
+	};
+
+	// The token is the event_id of the first relation of the next page. The
+	// index is grouped by rel_type; when no rel_type was given the iteration
+	// seeks to the token within its group and carries on through the rest.
+	m::event::id::buf from_id;
+	if(!empty(request.query["from"]))
+		from_id = url::decode(from_id, request.query.at("from"));
+
+	const m::event::idx from_idx
+	{
+		from_id?
+			index(std::nothrow, from_id):
+			0UL
+	};
+
+	// The token must be a relation, i.e. have a rel_type to seek with.
+	char from_rel_type_buf[m::event::TYPE_MAX_SIZE];
+	string_view from_rel_type
+	{
+		rel_type
+	};
+
+	if(from_idx && !rel_type)
+		m::get(std::nothrow, from_idx, "content", [&from_rel_type, &from_rel_type_buf]
+		(const json::object &content)
+		{
+			const json::object &m_relates_to
+			{
+				content.get("m.relates_to")
+			};
+
+			from_rel_type = strlcpy
+			{
+				from_rel_type_buf, json::string{m_relates_to.get("rel_type")}
+			};
+		});
+
+	if(from_id && (!from_idx || !from_rel_type))
+		throw m::BAD_REQUEST
+		{
+			"query parameter 'from' is not a valid token"
+		};
+
 	m::resource::response::chunked response
 	{
 		client, http::OK
@@ -95,97 +175,108 @@ get__relations(client &client,
 		out
 	};
 
-	json::stack::array chunk
+	// Send the original event
+	if(!from_idx)
 	{
-		top, "chunk"
-	};
+		json::stack::object original_event
+		{
+			top, "original_event"
+		};
+
+		m::event::append::opts opts;
+		opts.event_idx = &event_idx;
+		opts.user_id = &request.user_id;
+		opts.query_txnid = false;
+		m::event::append
+		{
+			original_event, event, opts
+		};
+	}
+
+	m::event::idx next_idx {0};
+	{
+		json::stack::array chunk
+		{
+			top, "chunk"
+		};
+
+		next_idx = relations_chunk(client, request, room_id, event_idx, rel_type, type, from_idx, limit, chunk);
+	}
+
+	m::event::id::buf next_batch;
+	if(next_idx)
+		json::stack::member
+		{
+			top, "next_batch", m::event_id(std::nothrow, next_idx, next_batch)
+		};
 
-	relations_chunk(client, request, room_id, event_id, rel_type, type, chunk);
 	return std::move(response);
 }
 
-void
+/// Appends up to `limit` relations to the event from the index, starting at
+/// `from` if given. Returns the event_idx of the relation which would start
+/// the next page, or zero if there are no more.
+m::event::idx
 relations_chunk(client &client,
                 const m::resource::request &request,
                 const m::room::id &room_id,
-                const m::event::id &event_id,
+                const m::event::idx &event_idx,
                 const string_view &rel_type,
                 const string_view &type,
+                const m::event::idx &from,
+                const size_t &limit,
                 json::stack::array &chunk)
 try
 {
-	const auto append{[&chunk, &request]
-	(const auto &event_idx, const m::event &event)
-	{
-		m::event::append::opts opts;
-		opts.event_idx = &event_idx;
-		opts.user_id = &request.user_id;
-		opts.query_txnid = false;
-		m::event::append
-		{
-			chunk, event, opts
-		};
-	}};
-
-	m::event::idx event_idx
+	const m::event::relations relations
 	{
-		index(std::nothrow, event_id)
+		event_idx
 	};
 
-	m::event::fetch event
+	size_t count(0);
+	m::event::idx ret {0};
+	m::event::fetch event;
+	relations.for_each(rel_type, type, from, [&]
+	(const m::event::idx &relation_idx, const string_view &, const string_view &)
 	{
-		std::nothrow, event_idx
-	};
-
-	const auto each_ref{[&event, &append, &rel_type, &request]
-	(const m::event::idx &event_idx, const m::dbs::ref &)
-	{
-		if(!seek(std::nothrow, event, event_idx))
-			return true;
-
-		const json::object &m_relates_to
+		if(count >= limit)
 		{
-			at<"content"_>(event).get("m.relates_to")
-		};
+			ret = relation_idx;
+			return false;
+		}
 
-		const json::string &_rel_type
-		{
-			m_relates_to.get("rel_type")
-		};
-
-		if(_rel_type != rel_type)
+		if(!seek(std::nothrow, event, relation_idx))
 			return true;
 
 		if(!visible(event, request.user_id))
 			return true;
 
-		append(event_idx, event);
-		return true;
-	}};
-
-	if(!event.valid)
-		return;
-
-	if(!visible(event, request.user_id))
-		return;
+		m::event::append::opts opts;
+		opts.event_idx = &relation_idx;
+		opts.user_id = &request.user_id;
+		opts.query_txnid = false;
+		count += m::event::append
+		{
+			chunk, event, opts
+		};
 
-	// Send the original event
-	append(event_idx, event);
+		return true;
+	});
 
-	// Send all the referencees
-	const m::event::refs refs{event_idx};
-	refs.for_each(m::dbs::ref::M_RELATES, each_ref);
+	return ret;
 }
 catch(const std::exception &e)
 {
 	log::error
 	{
-		m::log, "relations in %s for %s rel_type:%s type:%s by %s :%s",
+		m::log, "relations in %s for %lu rel_type:%s type:%s by %s :%s",
 		string_view{room_id},
-		string_view{event_id},
+		event_idx,
 		rel_type,
 		type,
 		string_view{request.user_id},
 		e.what(),
 	};
+
+	return 0;
 }
@@ -116,9 +116,11 @@ get__state(client &client,
 	if(!type)
 		return get__state(client, request, state);
 
+	m::event::fetch::opts fopts;
+	fopts.query_json_force = true;
 	const m::event::fetch event
 	{
-		state.get(type, state_key)
+		state.get(type, state_key), fopts
 	};
 
 	if(!visible(event, request.user_id))
@@ -41,12 +41,21 @@ namespace ircd::m::sync::longpoll
 	static void fini() noexcept;
 }
 
+namespace ircd::m::sync::snapshot
+{
+	static bool handle(data &);
+	static void fini() noexcept;
+
+	extern conf::item<bool> enable;
+}
+
 ircd::mapi::header
 IRCD_MODULE
 {
 	"Client 6.2.1 :Sync", nullptr, []
 	{
 		ircd::m::sync::longpoll::fini();
+		ircd::m::sync::snapshot::fini();
 	}
 };
 
@@ -279,6 +288,21 @@ ircd::m::sync::handle_get(client &client,
 		log, "request %s", loghead(data)
 	};
 
+	// An initial sync is satisfied from the user's stored snapshot when one
+	// is available, in lieu of the polylog (phased or not).
+	const bool should_snapshot
+	{
+		snapshot::enable
+		&& initial_sync
+		&& !phased_range
+		&& empty(args.since_token.second)
+		&& !args.next_batch_token
+		&& !args.semaphore
+	};
+
+	if(should_snapshot && snapshot::handle(data))
+		return std::move(response);
+
 	// Pre-determine if longpoll sync mode should be used. This may
 	// indicate false now but after conducting a linear or even polylog
 	// sync if we don't find any events for the client then we might
@@ -1006,6 +1030,823 @@ ircd::m::sync::longpoll::polled(data &data,
 	return true;
 }
 
+//
+// snapshot
+//
+// Materialized initial sync. The result of a polylog initial sync for a user
+// (and filter) is stored in the _user_sync column along with the sequence
+// number it was composed at. An initial sync is then satisfied by the
+// snapshot with the rooms changed since that sequence number recomposed,
+// together with a polylog of the items which are specific to the requesting
+// device; these are not part of the snapshot.
+//
+// Snapshots are created in the background for users with many rooms on the
+// first initial sync which misses. A vm hook marks rooms with new events;
+// the snapshots of their local members are periodically advanced in the
+// background by recomposing the sections of the rooms with new events. Once
+// the snapshot has been advanced too far it is composed from scratch again.
+
+namespace ircd::m::sync::snapshot
+{
+	using value = std::tuple<event::idx, event::idx, string_view>;
+
+	static value unpack(const string_view &);
+	static std::string read(const m::user::id &, const string_view &filter_id);
+	static void write(const m::user::id &, const string_view &filter_id, const event::idx &seq, const event::idx &base, const string_view &json);
+	static bool exists(const m::user::id &);
+	static sync::args make_args(const string_view &filter_id);
+	static size_t proffer_device(data &, const mutable_buffer &);
+	static std::string compose(data &);
+	static std::set<std::string, std::less<>> changed(const json::vector &);
+	static void splice(json::stack::object &, const json::object &prior, const json::object &fresh, const std::set<std::string, std::less<>> &changed);
+	static void build(const m::user::id &, const string_view &filter_id);
+	static void refresh(const m::user::id &, const string_view &filter_id);
+	static void refresh(const m::user::id &);
+	static void request(const m::user::id &, const string_view &filter_id);
+	static void handle_notify(const m::event &, m::vm::eval &);
+	static void worker();
+
+	extern conf::item<size_t> rooms_min;
+	extern conf::item<size_t> size_max;
+	extern conf::item<size_t> rebuild_delta;
+	extern conf::item<milliseconds> interval;
+	extern std::set<std::pair<std::string, std::string>> queue;
+	extern std::set<std::string, std::less<>> dirty;
+	extern ctx::dock dock;
+	extern m::hookfn<m::vm::eval &> notified;
+	extern ctx::context worker_context;
+}
+
+decltype(ircd::m::sync::snapshot::enable)
+ircd::m::sync::snapshot::enable
+{
+	{ "name",     "ircd.client.sync.snapshot.enable" },
+	{ "default",  true                               },
+};
+
+decltype(ircd::m::sync::snapshot::rooms_min)
+ircd::m::sync::snapshot::rooms_min
+{
+	{ "name",     "ircd.client.sync.snapshot.rooms.min"                  },
+	{ "default",  64L                                                    },
+	{ "help",     "Minimum joined rooms for a user to receive a snapshot" },
+};
+
+decltype(ircd::m::sync::snapshot::size_max)
+ircd::m::sync::snapshot::size_max
+{
+	{ "name",     "ircd.client.sync.snapshot.size.max"                    },
+	{ "default",  long(16_MiB)                                            },
+	{ "help",     "Snapshot size which forces composition from scratch"   },
+};
+
+decltype(ircd::m::sync::snapshot::rebuild_delta)
+ircd::m::sync::snapshot::rebuild_delta
+{
+	{ "name",     "ircd.client.sync.snapshot.rebuild.delta"                       },
+	{ "default",  65536L                                                          },
+	{ "help",     "Events since the last composition from scratch to force another" },
+};
+
+decltype(ircd::m::sync::snapshot::interval)
+ircd::m::sync::snapshot::interval
+{
+	{ "name",     "ircd.client.sync.snapshot.interval"                 },
+	{ "default",  15 * 1000L                                           },
+	{ "help",     "Milliseconds to coalesce activity between updates"  },
+};
+
+decltype(ircd::m::sync::snapshot::queue)
+ircd::m::sync::snapshot::queue;
+
+decltype(ircd::m::sync::snapshot::dirty)
+ircd::m::sync::snapshot::dirty;
+
+decltype(ircd::m::sync::snapshot::dock)
+ircd::m::sync::snapshot::dock;
+
+decltype(ircd::m::sync::snapshot::notified)
+ircd::m::sync::snapshot::notified
+{
+	handle_notify,
+	{
+		{ "_site",  "vm.notify" },
+	}
+};
+
+decltype(ircd::m::sync::snapshot::worker_context)
+ircd::m::sync::snapshot::worker_context
+{
+	"m.sync.snap", 1_MiB, &worker, context::POST,
+};
+
+void
+ircd::m::sync::snapshot::fini()
+noexcept
+{
+	worker_context.terminate();
+	worker_context.join();
+}
+
+/// Serve an initial sync from the snapshot. Returns false without any output
+/// when there is no usable snapshot, in which case the normal modes proceed.
+bool
+ircd::m::sync::snapshot::handle(data &data)
+{
+	assert(data.args);
+	const auto &filter_id
+	{
+		data.args->filter_id
+	};
+
+	if(size(filter_id) > dbs::USER_SYNC_FILTER_MAX_SIZE)
+		return false;
+
+	const std::string val
+	{
+		read(data.user, filter_id)
+	};
+
+	if(empty(val))
+	{
+		if(data.user_rooms.count("join") >= size_t(rooms_min))
+			request(data.user, filter_id);
+
+		return false;
+	}
+
+	const auto &[seq, base, json]
+	{
+		unpack(val)
+	};
+
+	if(seq > data.range.second)
+		return false;
+
+	// Too far behind for the linear catch-up; have the worker advance it.
+	if(data.range.second - seq > size_t(linear_delta_max))
+	{
+		request(data.user, filter_id);
+		return false;
+	}
+
+	const scope_restore phased
+	{
+		data.phased, false
+	};
+
+	const unique_buffer<mutable_buffer> buf
+	{
+		std::max(size_t(linear_buffer_size), size_t(128_KiB))
+	};
+
+	// The items excluded from the snapshot are composed with a polylog
+	// through the present. The linear catch-up from the snapshot's sequence
+	// is restricted to the snapshot's items so nothing is sent twice; the
+	// rooms it finds changed are recomposed and replace their sections.
+	window_buffer wb{buf};
+	string_view device;
+	std::string fresh;
+	std::set<std::string, std::less<>> affected;
+	std::pair<event::idx, bool> proffered; try
+	{
+		wb([&data](const mutable_buffer &buf)
+		{
+			return proffer_device(data, buf);
+		});
+
+		device = wb.completed();
+
+		const scope_restore snapshot
+		{
+			data.snapshot, true
+		};
+
+		const scope_restore range_first
+		{
+			data.range.first, seq
+		};
+
+		proffered = linear_proffer(data, wb);
+
+		const auto &[last, completed]
+		{
+			proffered
+		};
+
+		if(last)
+		{
+			const string_view linear
+			{
+				wb.completed() + size(device)
+			};
+
+			affected = changed(json::vector{linear});
+
+			const scope_restore range
+			{
+				data.range, m::events::range
+				{
+					0UL, completed? data.range.second: last + 1
+				}
+			};
+
+			const scope_restore rooms_only
+			{
+				data.rooms_only, &affected
+			};
+
+			fresh = compose(data);
+		}
+	}
+	catch(const ctx::interrupted &)
+	{
+		throw;
+	}
+	catch(const std::exception &e)
+	{
+		log::derror
+		{
+			log, "snapshot %s seq:%lu :%s",
+			loghead(data),
+			seq,
+			e.what(),
+		};
+
+		return false;
+	}
+
+	const auto &[last, completed]
+	{
+		proffered
+	};
+
+	const auto next
+	{
+		completed?
+			data.range.second:
+			std::min(last + 1, data.range.second)
+	};
+
+	json::stack::object top
+	{
+		*data.out
+	};
+
+	char since_buf[64];
+	json::stack::member
+	{
+		top, "next_batch", json::value
+		{
+			make_since(since_buf, next), json::STRING
+		}
+	};
+
+	for(const auto &[name, value] : json::object{device})
+		json::stack::member
+		{
+			top, name, json::value
+			{
+				value, json::type(value)
+			}
+		};
+
+	if(last)
+		splice(top, json, fresh, affected);
+	else
+		for(const auto &[name, value] : json::object{json})
+			json::stack::member
+			{
+				top, name, json::value
+				{
+					value, json::type(value)
+				}
+			};
+
+	log::debug
+	{
+		log, "request %s snapshot seq:%lu base:%lu size:%zu last:%lu complete @%lu",
+		loghead(data),
+		seq,
+		base,
+		size(json),
+		last,
+		next,
+	};
+
+	return true;
+}
+
+/// Polylog of the items excluded from the snapshot into one object.
+size_t
+ircd::m::sync::snapshot::proffer_device(data &data,
+                                        const mutable_buffer &buf)
+{
+	json::stack out{buf};
+	const scope_restore their_out
+	{
+		data.out, &out
+	};
+
+	json::stack::object top
+	{
+		*data.out
+	};
+
+	m::sync::for_each(string_view{}, [&data]
+	(item &item)
+	{
+		if(item.snapshot)
+			return true;
+
+		json::stack::checkpoint checkpoint
+		{
+			*data.out
+		};
+
+		json::stack::object object
+		{
+			*data.out, item.member_name()
+		};
+
+		if(!item.polylog(data))
+			checkpoint.committing(false);
+
+		return true;
+	});
+
+	top.~object();
+	return size(out.completed());
+}
+
+/// Polylog of the items included in the snapshot into one object.
+std::string
+ircd::m::sync::snapshot::compose(data &data)
+{
+	std::string ret;
+	const unique_buffer<mutable_buffer> buf
+	{
+		size_t(buffer_size)
+	};
+
+	json::stack out
+	{
+		buf, [&ret](const const_buffer &buf)
+		{
+			ret.append(buffer::data(buf), size(buf));
+			return buf;
+		},
+		size_t(flush_hiwat)
+	};
+
+	const scope_restore their_out
+	{
+		data.out, &out
+	};
+
+	{
+		json::stack::object top
+		{
+			out
+		};
+
+		m::sync::for_each(string_view{}, [&data]
+		(item &item)
+		{
+			json::stack::checkpoint checkpoint
+			{
+				*data.out
+			};
+
+			json::stack::object object
+			{
+				*data.out, item.member_name()
+			};
+
+			if(item.polylog(data))
+				data.out->invalidate_checkpoints();
+			else
+				checkpoint.committing(false);
+
+			return true;
+		});
+	}
+
+	out.flush(true);
+	return ret;
+}
+
+/// Rooms appearing in the output of a linear sync.
+std::set<std::string, std::less<>>
+ircd::m::sync::snapshot::changed(const json::vector &linear)
+{
+	std::set<std::string, std::less<>> ret;
+	for(const json::object object : linear)
+		for(const auto &[membership, rooms] : json::object{object["rooms"]})
+			for(const auto &[room_id, room] : json::object{rooms})
+				ret.emplace(room_id);
+
+	return ret;
+}
+
+/// Everything outside of the rooms is taken from the fresh polylog. The
+/// rooms which changed are taken from the fresh polylog under their current
+/// membership; the rest are carried over from the prior snapshot.
+void
+ircd::m::sync::snapshot::splice(json::stack::object &top,
+                                const json::object &prior,
+                                const json::object &fresh,
+                                const std::set<std::string, std::less<>> &changed)
+{
+	for(const auto &[name, value] : fresh)
+		if(name != "rooms")
+			json::stack::member
+			{
+				top, name, json::value
+				{
+					value, json::type(value)
+				}
+			};
+
+	const json::object prior_rooms
+	{
+		prior["rooms"]
+	};
+
+	const json::object fresh_rooms
+	{
+		fresh["rooms"]
+	};
+
+	json::stack::object rooms
+	{
+		top, "rooms"
+	};
+
+	for(const auto &membership : {"join", "invite", "leave", "ban"})
+	{
+		json::stack::object section
+		{
+			rooms, membership
+		};
+
+		for(const auto &[room_id, room] : json::object{prior_rooms[membership]})
+			if(!changed.count(room_id))
+				json::stack::member
+				{
+					section, room_id, json::object{room}
+				};
+
+		for(const auto &[room_id, room] : json::object{fresh_rooms[membership]})
+			json::stack::member
+			{
+				section, room_id, json::object{room}
+			};
+	}
+}
+
+/// Compose the snapshot from scratch with a polylog.
+void
+ircd::m::sync::snapshot::build(const m::user::id &user_id,
+                               const string_view &filter_id)
+{
+	const sync::args args
+	{
+		make_args(filter_id)
+	};
+
+	sync::stats stats;
+	sync::data data
+	{
+		user_id,
+		{ 0UL, vm::sequence::retired + 1 },
+		nullptr,
+		nullptr,
+		&stats,
+		&args,
+	};
+
+	data.snapshot = true;
+	const std::string ret
+	{
+		compose(data)
+	};
+
+	write(user_id, filter_id, data.range.second, data.range.second, ret);
+
+	char pbuf[48];
+	log::info
+	{
+		log, "snapshot %s composed seq:%lu size:%s",
+		loghead(data),
+		data.range.second,
+		pretty(pbuf, iec(size(ret))),
+	};
+}
+
+/// Advance the snapshot over the events since it was last written. A linear
+/// sync over those events finds the rooms which have changed; their sections
+/// are recomposed with a polylog and replace those of the snapshot, along
+/// with the items outside of the rooms. Composes it from scratch when that's
+/// not reasonable.
+void
+ircd::m::sync::snapshot::refresh(const m::user::id &user_id,
+                                 const string_view &filter_id)
+{
+	const std::string val
+	{
+		read(user_id, filter_id)
+	};
+
+	if(empty(val))
+		return build(user_id, filter_id);
+
+	const auto &[seq, base, json]
+	{
+		unpack(val)
+	};
+
+	const event::idx next
+	{
+		vm::sequence::retired + 1
+	};
+
+	if(seq >= next)
+		return;
+
+	if(next - base > size_t(rebuild_delta) || size(json) > size_t(size_max))
+		return build(user_id, filter_id);
+
+	const sync::args args
+	{
+		make_args(filter_id)
+	};
+
+	sync::data data
+	{
+		user_id, { seq, next }, nullptr, nullptr, nullptr, &args,
+	};
+
+	data.snapshot = true;
+
+	const unique_buffer<mutable_buffer> buf
+	{
+		std::max(size_t(linear_buffer_size), size_t(128_KiB))
+	};
+
+	window_buffer wb{buf};
+	const auto &[last, completed]
+	{
+		linear_proffer(data, wb)
+	};
+
+	const auto advanced
+	{
+		completed? next : last + 1
+	};
+
+	if(!last)
+		return write(user_id, filter_id, advanced, base, json);
+
+	const auto affected
+	{
+		changed(json::vector{wb.completed()})
+	};
+
+	const scope_restore range
+	{
+		data.range, m::events::range{0UL, advanced}
+	};
+
+	const scope_restore rooms_only
+	{
+		data.rooms_only, &affected
+	};
+
+	const std::string fresh
+	{
+		compose(data)
+	};
+
+	const unique_buffer<mutable_buffer> out_buf
+	{
+		size(json) + size(fresh) + 64_KiB
+	};
+
+	json::stack out{out_buf};
+	{
+		json::stack::object top
+		{
+			out
+		};
+
+		splice(top, json, fresh, affected);
+	}
+
+	write(user_id, filter_id, advanced, base, out.completed());
+}
+
+void
+ircd::m::sync::snapshot::refresh(const m::user::id &user_id)
+{
+	char buf[dbs::USER_SYNC_KEY_MAX_SIZE];
+	const string_view &key
+	{
+		dbs::user_sync_key(buf, user_id)
+	};
+
+	std::vector<std::string> filters;
+	for(auto it(dbs::user_sync.begin(key)); it; ++it)
+		filters.emplace_back(dbs::user_sync_key(it->first));
+
+	for(const auto &filter_id : filters)
+		refresh(user_id, filter_id);
+}
+
+void
+ircd::m::sync::snapshot::request(const m::user::id &user_id,
+                                 const string_view &filter_id)
+{
+	queue.emplace(std::string{user_id}, std::string{filter_id});
+	dock.notify_one();
+}
+
+void
+ircd::m::sync::snapshot::handle_notify(const m::event &event,
+                                       m::vm::eval &eval)
+{
+	assert(eval.opts);
+	if(!enable || !eval.opts->notify_clients)
+		return;
+
+	const auto &room_id
+	{
+		json::get<"room_id"_>(event)
+	};
+
+	if(!room_id)
+		return;
+
+	if(dirty.emplace(room_id).second)
+		dock.notify_one();
+}
+
+void
+ircd::m::sync::snapshot::worker()
+{
+	while(1)
+	{
+		dock.wait([]
+		{
+			return !queue.empty() || !dirty.empty();
+		});
+
+		// Coalesce the activity of the interval into one update per user.
+		ctx::sleep(milliseconds(interval));
+
+		decltype(snapshot::queue) queue;
+		std::swap(queue, snapshot::queue);
+
+		decltype(snapshot::dirty) dirty;
+		std::swap(dirty, snapshot::dirty);
+
+		std::set<std::string, std::less<>> users;
+		for(const auto &room_id : dirty)
+		{
+			const m::room::members members
+			{
+				m::room{room_id}
+			};
+
+			members.for_each("join", my_host(), [&users]
+			(const id::user &user_id)
+			{
+				if(snapshot::exists(user_id))
+					users.emplace(user_id);
+
+				return true;
+			});
+		}
+
+		const auto handle{[](const auto &closure, const string_view &user_id)
+		{
+			try
+			{
+				closure();
+			}
+			catch(const ctx::interrupted &)
+			{
+				throw;
+			}
+			catch(const std::exception &e)
+			{
+				log::error
+				{
+					log, "snapshot %s :%s",
+					user_id,
+					e.what(),
+				};
+			}
+		}};
+
+		for(const auto &[user_id, filter_id] : queue)
+			handle([&user_id, &filter_id]
+			{
+				refresh(user_id, filter_id);
+			}, user_id);
+
+		for(const auto &user_id : users)
+			handle([&user_id]
+			{
+				refresh(user_id);
+			}, user_id);
+	}
+}
+
+bool
+ircd::m::sync::snapshot::exists(const m::user::id &user_id)
+{
+	char buf[dbs::USER_SYNC_KEY_MAX_SIZE];
+	const string_view &key
+	{
+		dbs::user_sync_key(buf, user_id)
+	};
+
+	return bool(dbs::user_sync.begin(key));
+}
+
+ircd::m::sync::args
+ircd::m::sync::snapshot::make_args(const string_view &filter_id)
+{
+	sync::args ret;
+	ret.filter_id = filter_id;
+	ret.since_token = {};
+	ret.since = 0;
+	ret.next_batch_token = {};
+	ret.next_batch = -1UL;
+	ret.timesout = ircd::now<system_point>();
+	ret.full_state = false;
+	ret.set_presence = false;
+	ret.phased = false;
+	ret.semaphore = false;
+	return ret;
+}
+
+std::string
+ircd::m::sync::snapshot::read(const m::user::id &user_id,
+                              const string_view &filter_id)
+{
+	char buf[dbs::USER_SYNC_KEY_MAX_SIZE];
+	const string_view &key
+	{
+		dbs::user_sync_key(buf, user_id, filter_id)
+	};
+
+	bool found;
+	std::string ret
+	{
+		db::read(dbs::user_sync, key, found)
+	};
+
+	if(!found || size(ret) < sizeof(event::idx) * 2)
+		ret.clear();
+
+	return ret;
+}
+
+void
+ircd::m::sync::snapshot::write(const m::user::id &user_id,
+                               const string_view &filter_id,
+                               const event::idx &seq,
+                               const event::idx &base,
+                               const string_view &json)
+{
+	char buf[dbs::USER_SYNC_KEY_MAX_SIZE];
+	const string_view &key
+	{
+		dbs::user_sync_key(buf, user_id, filter_id)
+	};
+
+	std::string val(sizeof(seq) + sizeof(base) + size(json), char{});
+	mutable_buffer out{val};
+	consume(out, copy(out, byte_view<string_view>{seq}));
+	consume(out, copy(out, byte_view<string_view>{base}));
+	consume(out, copy(out, json));
+	db::write(dbs::user_sync, key, const_buffer{val});
+}
+
+ircd::m::sync::snapshot::value
+ircd::m::sync::snapshot::unpack(const string_view &val)
+{
+	assert(size(val) >= sizeof(event::idx) * 2);
+	return
+	{
+		byte_view<event::idx>(val.substr(0, sizeof(event::idx))),
+		byte_view<event::idx>(val.substr(sizeof(event::idx), sizeof(event::idx))),
+		val.substr(sizeof(event::idx) * 2),
+	};
+}
+
 //
 // data
 //
@@ -34,7 +34,10 @@ ircd::m::sync::device_one_time_keys_count
 {
 	"device_one_time_keys_count",
 	device_one_time_keys_count_polylog,
-	device_one_time_keys_count_linear
+	device_one_time_keys_count_linear,
+	{
+		{ "snapshot", false }
+	}
 };
 
 bool
@@ -28,6 +28,9 @@ ircd::m::sync::presence
 	"presence",
 	presence_polylog,
 	presence_linear,
+	{
+		{ "snapshot", false }
+	}
 };
 
 bool
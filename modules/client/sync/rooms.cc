@@ -157,6 +157,9 @@ ircd::m::sync::_rooms_polylog(data &data,
 	const user::rooms::closure_bool closure{[&data, &ret, &phase]
 	(const m::room &room, const string_view &membership_)
 	{
+		if(data.rooms_only && !data.rooms_only->count(room.room_id))
+			return true;
+
 		if(data.phased)
 		{
 			if(phase < int64_t(data.range.first) && ret)
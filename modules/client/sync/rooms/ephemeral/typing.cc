@@ -26,7 +26,10 @@ ircd::m::sync::room_ephemeral_m_typing
 {
 	"rooms.ephemeral.m_typing",
 	room_ephemeral_m_typing_polylog,
-	room_ephemeral_m_typing_linear
+	room_ephemeral_m_typing_linear,
+	{
+		{ "snapshot", false }
+	}
 };
 
 bool
@@ -28,7 +28,10 @@ ircd::m::sync::to_device
 {
 	"to_device",
 	to_device_polylog,
-	to_device_linear
+	to_device_linear,
+	{
+		{ "snapshot", false }
+	}
 };
 
 bool
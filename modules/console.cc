@@ -1379,6 +1379,25 @@ console_cmd__stats(opt &out, const string_view &line)
 		    ;
 	}
 
+	for(const auto &[name, histogram] : stats::histograms)
+	{
+		static constexpr size_t name_width {60};
+
+		assert(histogram);
+		const auto trunc_name(trunc(name, name_width));
+		out << std::left << std::setw(name_width) << trunc_name;
+
+		if(size(trunc_name) == name_width)
+			out << "...";
+		else
+			out << "   ";
+
+		out << "  "
+		    << std::left << (*histogram)
+		    << std::endl
+		    ;
+	}
+
 	return true;
 }
 
@@ -1394,11 +1413,15 @@ console_cmd__ios(opt &out, const string_view &line)
 	    << " " << std::right << std::setw(6) << "QUEUED"
 	    << " " << std::right << std::setw(13) << "LAST LATENCY"
 	    << " " << std::right << std::setw(13) << "AVG LATENCY"
+	    << " " << std::right << std::setw(13) << "P99 LATENCY"
 	    << " " << std::right << std::setw(13) << "AVG CYCLES"
+	    << " " << std::right << std::setw(13) << "P99 CYCLES"
 	    << " " << std::right << std::setw(13) << "LAST CYCLES"
 	    << " " << std::right << std::setw(10) << "CALLS"
 	    << " " << std::right << std::setw(10) << "ALLOCS"
 	    << " " << std::right << std::setw(10) << "FREES"
+	    << " " << std::right << std::setw(10) << "SLAB HITS"
+	    << " " << std::right << std::setw(10) << "SLAB MISS"
 	    << " " << std::right << std::setw(26) << "ALLOCATED"
 	    << " " << std::right << std::setw(26) << "FREED"
 	    << " " << std::right << std::setw(8) << "FAULTS"
@@ -1427,11 +1450,15 @@ console_cmd__ios(opt &out, const string_view &line)
 		<< " " << std::right << std::setw(6) << s.queued
 		<< " " << std::right << std::setw(13) << pretty(pbuf, si(ulong(s.latency_last)), 2)
 		<< " " << std::right << std::setw(13) << pretty(pbuf, si(ulong(latency_avg)), 2)
+		<< " " << std::right << std::setw(13) << pretty(pbuf, si(s.latency_hist.percentile(99.0)), 2)
 		<< " " << std::right << std::setw(13) << pretty(pbuf, si(ulong(cycles_avg)), 2)
+		<< " " << std::right << std::setw(13) << pretty(pbuf, si(s.slice_hist.percentile(99.0)), 2)
 		<< " " << std::right << std::setw(13) << pretty(pbuf, si(s.slice_last), 2)
 		<< " " << std::right << std::setw(10) << s.calls
 		<< " " << std::right << std::setw(10) << s.allocs
 		<< " " << std::right << std::setw(10) << s.frees
+		<< " " << std::right << std::setw(10) << s.slab_hits
+		<< " " << std::right << std::setw(10) << s.slab_misses
 		<< " " << std::right << std::setw(26) << pretty(pbuf, iec(s.alloc_bytes))
 		<< " " << std::right << std::setw(26) << pretty(pbuf, iec(s.free_bytes))
 		<< " " << std::right << std::setw(8) << s.faults
@@ -2869,6 +2896,63 @@ catch(const std::out_of_range &e)
 	return true;
 }
 
+bool
+console_cmd__db__compact__defer(opt &out, const string_view &line)
+try
+{
+	const params param{line, " ",
+	{
+		"dbname", "[colname]"
+	}};
+
+	const auto dbname
+	{
+		param.at(0)
+	};
+
+	const auto colname
+	{
+		param[1] != "*"?
+			param[1]:
+			string_view{}
+	};
+
+	auto &database
+	{
+		db::database::get(dbname)
+	};
+
+	// Throws if there is no such column.
+	if(colname)
+		database[colname];
+
+	db::governor::defer(dbname, colname);
+	out << "Compaction of " << dbname << " deferred to quiet hours ("
+	    << size_t(db::governor::quiet_begin) << ":00 - "
+	    << size_t(db::governor::quiet_end) << ":00)."
+	    << std::endl;
+
+	return true;
+}
+catch(const std::out_of_range &e)
+{
+	out << "No open database by that name" << std::endl;
+	return true;
+}
+
+bool
+console_cmd__db__governor(opt &out, const string_view &line)
+{
+	out << "enabled:      " << (db::governor::enable? "yes" : "no") << std::endl
+	    << "quiet:        " << (db::governor::quiet()? "yes" : "no") << std::endl
+	    << "load:         " << uint64_t(db::governor::load_pct.val) << '%' << std::endl
+	    << "rate:         " << pretty(iec(uint64_t(db::governor::rate.val))) << "/s" << std::endl
+	    << "compactions:  " << uint64_t(db::governor::compactions.val) << std::endl
+	    << "deferred:     " << uint64_t(db::governor::deferred.val) << std::endl;
+
+	return true;
+}
+
 bool
 console_cmd__db__compact__files(opt &out, const string_view &line)
 try
@@ -4521,6 +4605,177 @@ catch(const std::out_of_range &e)
 	return true;
 }
 
+bool
+console_cmd__db__backup(opt &out, const string_view &line)
+try
+{
+	const params param{line, " ",
+	{
+		"dbname"
+	}};
+
+	auto &database
+	{
+		db::database::get(param.at("dbname"))
+	};
+
+	const auto id
+	{
+		db::backup::create(database)
+	};
+
+	out << "Backup " << name(database)
+	    << " at sequence " << id << " complete." << std::endl
+	    << "files copied: " << uint64_t(db::backup::files_copied.val) << std::endl
+	    << "files shared: " << uint64_t(db::backup::files_shared.val) << std::endl
+	    << "bytes copied: " << pretty(iec(uint64_t(db::backup::bytes_copied.val))) << std::endl
+	    << "bytes total:  " << pretty(iec(uint64_t(db::backup::bytes_total.val))) << std::endl;
+
+	return true;
+}
+catch(const std::out_of_range &e)
+{
+	out << "No open database by that name" << std::endl;
+	return true;
+}
+
+bool
+console_cmd__db__backup__list(opt &out, const string_view &line)
+{
+	const params param{line, " ",
+	{
+		"dbname"
+	}};
+
+	const auto &dbname
+	{
+		param.at("dbname")
+	};
+
+	out << "backups of " << dbname
+	    << " in `" << db::backup::dir(dbname) << "'" << std::endl;
+
+	db::backup::for_each(dbname, [&out, &dbname]
+	(const uint64_t &id)
+	{
+		const auto dir
+		{
+			db::backup::dir(dbname, id)
+		};
+
+		size_t bytes(0), count(0);
+		for(const auto &file : fs::ls(dir))
+		{
+			bytes += fs::size(file);
+			++count;
+		}
+
+		out << std::setw(12) << std::right << id
+		    << "  " << std::setw(3) << count << " files"
+		    << "  " << pretty(iec(bytes))
+		    << std::endl;
+
+		return true;
+	});
+
+	return true;
+}
+
+bool
+console_cmd__db__backup__verify(opt &out, const string_view &line)
+try
+{
+	const params param{line, " ",
+	{
+		"dbname", "id"
+	}};
+
+	auto &database
+	{
+		db::database::get(param.at("dbname"))
+	};
+
+	const auto id
+	{
+		param.at<uint64_t>("id")
+	};
+
+	const auto bytes
+	{
+		db::backup::verify(database, id)
+	};
+
+	out << "Backup " << id << " of " << name(database)
+	    << " verified " << pretty(iec(bytes)) << " without error."
+	    << std::endl;
+
+	return true;
+}
+catch(const std::out_of_range &e)
+{
+	out << "No open database by that name" << std::endl;
+	return true;
+}
+
+bool
+console_cmd__db__backup__purge(opt &out, const string_view &line)
+{
+	const params param{line, " ",
+	{
+		"dbname", "keep"
+	}};
+
+	const auto &dbname
+	{
+		param.at("dbname")
+	};
+
+	const auto keep
+	{
+		param.at<size_t>("keep", size_t(db::backup::keep))
+	};
+
+	const auto purged
+	{
+		db::backup::purge(dbname, keep)
+	};
+
+	out << "Purged " << purged << " backups of " << dbname
+	    << "; keeping " << keep << "." << std::endl;
+
+	return true;
+}
+
+bool
+console_cmd__db__backup__restore(opt &out, const string_view &line)
+{
+	const params param{line, " ",
+	{
+		"dbname", "id"
+	}};
+
+	const auto &dbname
+	{
+		param.at("dbname")
+	};
+
+	const auto id
+	{
+		param.at<uint64_t>("id")
+	};
+
+	const auto path
+	{
+		db::backup::restore(dbname, id)
+	};
+
+	out << "Restored backup " << id << " of " << dbname
+	    << " to `" << path << "'; open it as " << dbname << ':' << id
+	    << std::endl;
+
+	return true;
+}
+
 bool
 console_cmd__db__check(opt &out, const string_view &line)
 try
@@ -5717,6 +5972,8 @@ console_cmd__net__listen__list(opt &out, const string_view &line)
 		out << "binder     : " << net::binder(listener) << std::endl;
 		out << "bound      : " << net::local(listener) << std::endl;
 		out << "config     : " << net::config(listener) << std::endl;
+		out << "handshakes : " << net::handshook_count(listener) << std::endl;
+		out << "resumed    : " << net::resumed_count(listener) << std::endl;
 		out << std::endl;
 	}
 
@@ -5758,6 +6015,119 @@ console_cmd__net__listen__ciphers(opt &out, const string_view &line)
 	return true;
 }
 
+bool
+console_cmd__net__listen__bench(opt &out, const string_view &line)
+{
+	const params param{line, " ",
+	{
+		"name", "count", "concurrency"
+	}};
+
+	const auto &name
+	{
+		param.at("name")
+	};
+
+	const size_t count
+	{
+		param.at<size_t>("count", 1024UL)
+	};
+
+	const size_t concurrency
+	{
+		std::max(param.at<size_t>("concurrency", 32UL), 1UL)
+	};
+
+	using list = std::list<net::listener>;
+
+	static mods::import<list> listeners
+	{
+		"m_listen", "listeners"
+	};
+
+	const list &l(listeners);
+	const auto it
+	{
+		std::find_if(begin(l), end(l), [&name]
+		(const auto &listener)
+		{
+			return listener.name() == name;
+		})
+	};
+
+	if(it == end(l))
+		throw error
+		{
+			"No listener named '%s'", name
+		};
+
+	net::open_opts opts
+	{
+		net::local(*it)
+	};
+
+	opts.verify_certificate = false;
+	opts.send_sni = false;
+
+	const size_t handshakes_before
+	{
+		net::handshook_count(*it)
+	};
+
+	// Handshakes are conducted by the client side here on the main thread as
+	// well; the comparison is between the listener's configurations, i.e.
+	// ircd.net.acceptor.offload.threads, with the same client load.
+	std::deque<ctx::future<std::shared_ptr<net::socket>>> pending;
+	size_t started(0), succeeded(0), failed(0);
+	const ircd::timer timer;
+	while(started < count || !pending.empty())
+	{
+		while(started < count && pending.size() < concurrency)
+		{
+			pending.emplace_back(net::open(opts));
+			++started;
+		} try
+		{
+			const auto sock
+			{
+				pending.front().get()
+			};
+
+			net::close(*sock, net::dc::RST, net::close_ignore);
+			++succeeded;
+		}
+		catch(const ctx::interrupted &)
+		{
+			throw;
+		}
+		catch(const std::exception &)
+		{
+			++failed;
+		}
+
+		pending.pop_front();
+	}
+
+	const auto elapsed
+	{
+		timer.at<microseconds>()
+	};
+
+	char pbuf[48];
+	out
+	<< "listener:       " << name << " " << net::local(*it) << std::endl
+	<< "offload:        " << conf::get("ircd.net.acceptor.offload.threads") << " threads"
+	<< " accept:" << conf::get("ircd.net.acceptor.offload.accept") << std::endl
+	<< "handshakes:     " << succeeded << " (" << failed << " failed)" << std::endl
+	<< "listener count: " << net::handshook_count(*it) - handshakes_before << std::endl
+	<< "elapsed:        " << pretty(pbuf, elapsed) << std::endl
+	<< "rate:           " << (succeeded * 1000000UL) / std::max(elapsed.count(), 1L)
+	<< " handshakes/s" << std::endl
+	;
+
+	return true;
+}
+
 bool
 console_cmd__net__listen(opt &out, const string_view &line)
 {
@@ -6137,6 +6507,9 @@ console_cmd__resource(opt &out, const string_view &line)
 		    << (m.opts->flags & resource::method::CONTENT_DISCRETION? " CONTENT_DISCRETION" : "")
 		    << std::endl;
 
+		out << "latency (us) " << m.stats->latency
+		    << std::endl;
+
 		return true;
 	}
 
@@ -6159,6 +6532,8 @@ console_cmd__resource(opt &out, const string_view &line)
 			    << " | RET " << std::setw(8) << m.stats->completions
 			    << " | TIM " << std::setw(8) << m.stats->timeouts
 			    << " | ERR " << std::setw(8) << m.stats->internal_errors
+			    << " | P50 " << std::setw(8) << m.stats->latency.percentile(50.0) << "us"
+			    << " | P99 " << std::setw(8) << m.stats->latency.percentile(99.0) << "us"
 			    << std::endl;
 		}
 	}
@@ -6250,6 +6625,46 @@ console_cmd__key__get(opt &out, const string_view &line)
 	return true;
 }
 
+bool
+console_cmd__key__pk(opt &out, const string_view &line)
+{
+	const params param{line, " ",
+	{
+		"server_name"
+	}};
+
+	const auto &server_name
+	{
+		param["server_name"]
+	};
+
+	m::keys::pk::for_each([&out, &server_name]
+	(const string_view &key, const m::keys::pk::entry &entry)
+	{
+		if(server_name && !startswith(key, server_name))
+			return true;
+
+		char smbuf[32];
+		out << std::left << std::setw(48) << key << ' ';
+		if(entry.found)
+			out << smalldate(smbuf, entry.valid_until_ts / 1000L);
+		else if(entry.eptr)
+			out << "ERROR " << what(entry.eptr);
+		else
+			out << "NOT FOUND";
+
+		out << std::endl;
+		return true;
+	});
+
+	out << std::endl
+	    << "hits       " << m::keys::pk::hits << std::endl
+	    << "misses     " << m::keys::pk::misses << std::endl
+	    << "negatives  " << m::keys::pk::negatives << std::endl;
+
+	return true;
+}
+
 //
 // stage
 //
@@ -7165,6 +7580,174 @@ console_cmd__events__rebuild(opt &out, const string_view &line)
 	return true;
 }
 
+bool
+console_cmd__events__bloom(opt &out, const string_view &line)
+{
+	using filter = m::dbs::event_idx_filter;
+
+	if(!filter::active)
+	{
+		out << "The event_id filter is not available"
+		    << (filter::building? " (building)." : ".")
+		    << std::endl;
+
+		return true;
+	}
+
+	const auto &active
+	{
+		*filter::active
+	};
+
+	const size_t bits
+	{
+		active.blocks.size() * sizeof(filter::block) * 8
+	};
+
+	const long double fill
+	{
+		bits? active.popcount() / (long double)bits : 0.0L
+	};
+
+	const uint64_t negatives(filter::negatives.val);
+	const uint64_t false_positives(filter::false_positives.val);
+	const long double observed
+	{
+		negatives + false_positives?
+			false_positives / (long double)(negatives + false_positives):
+			0.0L
+	};
+
+	char pbuf[48];
+	out << "enabled:          " << bool(filter::enable) << std::endl
+	    << "rebuilding:       " << bool(filter::building) << std::endl
+	    << "size:             " << pretty(pbuf, iec(bits / 8)) << std::endl
+	    << "blocks:           " << active.blocks.size() << std::endl
+	    << "keys:             " << active.keys << std::endl
+	    << "capacity:         " << active.capacity << std::endl
+	    << "fill:             " << fill * 100.0L << "%" << std::endl
+	    << "queries:          " << uint64_t(filter::queries.val) << std::endl
+	    << "negatives:        " << negatives << std::endl
+	    << "false positives:  " << false_positives << std::endl
+	    << "fp rate expected: " << std::pow(fill, filter::k) * 100.0L << "%" << std::endl
+	    << "fp rate observed: " << observed * 100.0L << "%" << std::endl
+	    ;
+
+	return true;
+}
+
+bool
+console_cmd__events__bloom__rebuild(opt &out, const string_view &line)
+{
+	m::dbs::event_idx_filter::rebuild();
+	out << "done" << std::endl;
+	return true;
+}
+
+bool
+console_cmd__events__rebuild__bin(opt &out, const string_view &line)
+{
+	m::events::rebuild__bin();
+	return true;
+}
+
+bool
+console_cmd__events__bin__bench(opt &out, const string_view &line)
+{
+	const params param{line, " ",
+	{
+		"count"
+	}};
+
+	const size_t count
+	{
+		param.at<size_t>("count", 4096UL)
+	};
+
+	thread_local char buf[m::dbs::EVENT_BIN_MAX_SIZE];
+	nanoseconds json_time{0}, bin_time{0}, enc_time{0};
+	size_t num(0), json_bytes(0), bin_bytes(0), mismatch(0);
+	auto it(m::dbs::event_json.rbegin());
+	for(; it && num < count; ++it, ++num)
+	{
+		const json::object &source
+		{
+			it->second
+		};
+
+		ircd::timer json_timer;
+		const m::event event
+		{
+			source
+		};
+		json_time += json_timer.at<nanoseconds>();
+
+		ircd::timer enc_timer;
+		const string_view bin
+		{
+			m::dbs::event_bin_encode(buf, event)
+		};
+		enc_time += enc_timer.at<nanoseconds>();
+
+		m::event decoded;
+		ircd::timer bin_timer;
+		m::dbs::event_bin_decode(decoded, bin);
+		bin_time += bin_timer.at<nanoseconds>();
+
+		json_bytes += size(string_view(source));
+		bin_bytes += size(bin);
+		mismatch += json::strung(event) != json::strung(decoded);
+	}
+
+	if(!num)
+		return true;
+
+	char pbuf[6][48];
+	out
+	<< "events:         " << num << std::endl
+	<< "json bytes:     " << pretty(pbuf[0], iec(json_bytes)) << std::endl
+	<< "bin bytes:      " << pretty(pbuf[1], iec(bin_bytes)) << std::endl
+	<< "json decode:    " << pretty(pbuf[2], json_time) << " "
+	<< "(" << pretty(pbuf[3], json_time / num) << " per event)" << std::endl
+	<< "bin decode:     " << pretty(pbuf[4], bin_time) << " "
+	<< "(" << pretty(pbuf[5], bin_time / num) << " per event)" << std::endl
+	<< "bin encode:     " << pretty(pbuf[0], enc_time) << std::endl
+	<< "mismatches:     " << mismatch << std::endl
+	;
+
+	return true;
+}
+
+bool
+console_cmd__events__import(opt &out, const string_view &line)
+{
+	const params param{line, " ",
+	{
+		"filename", "limit", "batch", "sample"
+	}};
+
+	m::import::opts opts;
+	opts.limit = param.at<size_t>("limit", 0UL);
+	opts.batch = param.at<size_t>("batch", 0UL);
+	opts.sample = param.at<size_t>("sample", opts.sample);
+
+	const m::import::import import
+	{
+		param.at("filename"), opts
+	};
+
+	out << "read       " << import.read << std::endl
+	    << "imported   " << import.imported << std::endl
+	    << "skipped    " << import.skipped << std::endl
+	    << "batches    " << import.batches << std::endl
+	    << "files      " << import.files << std::endl
+	    << "range      " << import.range.first << ":" << import.range.second << std::endl
+	    << "sampled    " << import.sampled << std::endl
+	    << "failed     " << import.failed << std::endl;
+
+	return true;
+}
+
 //
 // event
 //
@@ -7839,6 +8422,14 @@ console_cmd__event__refs__rebuild(opt &out, const string_view &line)
 	return true;
 }
 
+bool
+console_cmd__event__relations__rebuild(opt &out, const string_view &line)
+{
+	m::event::relations::rebuild();
+	out << "done" << std::endl;
+	return true;
+}
+
 bool
 console_cmd__event__refs(opt &out, const string_view &line)
 {
@@ -8279,6 +8870,53 @@ console_cmd__rooms__public(opt &out, const string_view &line)
 	return true;
 }
 
+bool
+console_cmd__rooms__public__index(opt &out, const string_view &line)
+{
+	const params param{line, " ",
+	{
+		"server", "limit"
+	}};
+
+	const string_view &server
+	{
+		param.at("server", my_host())
+	};
+
+	auto limit
+	{
+		param.at("limit", 32L)
+	};
+
+	out << m::rooms::summary::index::count(server)
+	    << " rooms from " << server
+	    << std::endl;
+
+	m::rooms::summary::index::for_each(server, {}, [&limit, &out]
+	(const m::room::id &room_id, const json::object &summary)
+	{
+		out << std::setw(8) << std::right << summary.get<long>("num_joined_members", 0L)
+		    << " " << room_id
+		    << std::endl;
+
+		return --limit > 0;
+	});
+
+	return true;
+}
+
+bool
+console_cmd__rooms__public__index__rebuild(opt &out, const string_view &line)
+{
+	const auto count
+	{
+		m::rooms::summary::index::rebuild()
+	};
+
+	out << "Rebuilt index with " << count << " rooms." << std::endl;
+	return true;
+}
+
 bool
 console_cmd__rooms__fetch(opt &out, const string_view &line)
 {
@@ -13203,9 +13841,12 @@ console_cmd__feds__send(opt &out, const string_view &line)
 		param.at(0)
 	};
 
+	// The source JSON is sent verbatim.
+	m::event::fetch::opts fopts;
+	fopts.query_json_force = true;
 	const m::event::fetch event
 	{
-		event_id
+		event_id, fopts
 	};
 
 	const json::value event_json
@@ -15180,6 +15821,43 @@ console_cmd__fetch(opt &out, const string_view &line)
 	return true;
 }
 
+bool
+console_cmd__fetch__scores(opt &out, const string_view &line)
+{
+	const params param{line, " ",
+	{
+		"origin"
+	}};
+
+	const string_view &origin
+	{
+		param["origin"]
+	};
+
+	m::fetch::score::for_each([&out, &origin]
+	(const string_view &name, const m::fetch::score &score)
+	{
+		if(origin && name != origin)
+			return true;
+
+		char pbuf[48];
+		out
+		<< std::left << std::setw(40) << trunc(name, 40) << " "
+		<< std::right << std::setw(8) << long(score.latency) << " ms "
+		<< std::right << std::setw(5) << long(score.success * 100.0) << "% "
+		<< std::right << std::setw(8) << score.requests << " "
+		<< std::right << std::setw(8) << score.errors << " "
+		<< std::right << std::setw(10) << pretty(pbuf, now<system_point>() - score.last, 1) << " ago "
+		<< std::left << score.error << " "
+		<< std::endl
+		;
+
+		return true;
+	});
+
+	return true;
+}
+
 bool
 console_cmd__fetch__event(opt &out, const string_view &line)
 {
@@ -117,6 +117,7 @@ get__backfill(client &client,
 		top, "pdus"
 	};
 
+	it.readahead(limit);
 	size_t count{0};
 	for(; it && count < limit; ++count, --it)
 	{
@@ -108,25 +108,46 @@ handle_get(client &client,
 			top, "chunk"
 		};
 
-		m::rooms::for_each(opts, [&]
-		(const m::room::id &room_id)
+		const auto append{[&]
+		(const m::room::id &room_id, const auto &get)
 		{
 			json::stack::object obj
 			{
 				chunk
 			};
 
-			m::rooms::summary::get(obj, room_id);
+			get(obj);
 			next_batch_buf = room_id;
 			return ++count < limit;
-		});
+		}};
+
+		if(m::rooms::summary::index::available())
+			m::rooms::summary::index::for_each(opts.server, since, [&]
+			(const m::room::id &room_id, const json::object &summary)
+			{
+				return append(room_id, [&summary](auto &obj)
+				{
+					obj.append(summary);
+				});
+			});
+		else
+			m::rooms::for_each(opts, [&]
+			(const m::room::id &room_id)
+			{
+				return append(room_id, [&room_id](auto &obj)
+				{
+					m::rooms::summary::get(obj, room_id);
+				});
+			});
 	}
 
 	json::stack::member
 	{
 		top, "total_room_count_estimate", json::value
 		{
-			ssize_t(m::rooms::count(opts))
+			m::rooms::summary::index::available()?
+				ssize_t(m::rooms::summary::index::count(opts.server)):
+				ssize_t(m::rooms::count(opts))
 		}
 	};
 
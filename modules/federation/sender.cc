@@ -66,6 +66,17 @@ struct node
 	server::request::opts sopts;
 	txn *curtxn {nullptr};
 
+	/// EDU coalescing stage. Updates of the same kind to the same subject
+	/// replace each other here until the stage is flushed; the key is the
+	/// edu_type and the subject separated by '\0'.
+	std::map<std::string, std::string, std::less<>> edus;
+	std::map<std::string, steady_point, std::less<>> presence_sent;
+	steady_point edus_since;
+
+	steady_point edus_due() const;
+	size_t take_edus(std::vector<std::string> &, const size_t &max);
+	bool stage(std::string key, const string_view &val);
+	void coalesce(const m::event &);
 	bool flush();
 	void push(std::shared_ptr<unit>);
 
@@ -86,6 +97,11 @@ static void recv();
 static void recv_worker();
 ctx::dock recv_action;
 
+static std::string edu_key(const std::initializer_list<string_view> &);
+static bool coalescible(const m::event &);
+static void edu_worker();
+ctx::dock edu_action;
+
 static void send_from_user(const m::event &, const m::user::id &user_id);
 static void send_to_user(const m::event &, const m::user::id &user_id);
 static void send_to_room(const m::event &, const m::room::id &room_id);
@@ -106,6 +122,61 @@ receiver
 	"m.fedsnd.R", 1_MiB, &recv_worker, context::POST,
 };
 
+context
+edu_timer
+{
+	"m.fedsnd.E", 512_KiB, &edu_worker, context::POST,
+};
+
+conf::item<milliseconds>
+edu_window
+{
+	{ "name",     "ircd.federation.sender.edu.window" },
+	{ "default",  250L                                },
+};
+
+conf::item<milliseconds>
+edu_presence_interval
+{
+	{ "name",     "ircd.federation.sender.edu.presence.interval" },
+	{ "default",  10 * 1000L                                     },
+};
+
+conf::item<size_t>
+edu_max
+{
+	{ "name",     "ircd.federation.sender.edu.max" },
+	{ "default",  100L                             },
+};
+
+stats::item
+edus_staged
+{
+	{ "name", "ircd.federation.sender.edu.staged"                         },
+	{ "desc", "Typing, receipt and presence updates entering the stage"   },
+};
+
+stats::item
+edus_squashed
+{
+	{ "name", "ircd.federation.sender.edu.squashed"                       },
+	{ "desc", "Staged updates replaced by a later update before sending"  },
+};
+
+stats::item
+edus_deferred
+{
+	{ "name", "ircd.federation.sender.edu.presence.deferred"              },
+	{ "desc", "Presence updates held back by the rate limit"              },
+};
+
+stats::item
+edus_sent
+{
+	{ "name", "ircd.federation.sender.edu.sent"                           },
+	{ "desc", "Coalesced EDUs sent in transactions"                       },
+};
+
 mapi::header
 IRCD_MODULE
 {
@@ -114,8 +185,10 @@ IRCD_MODULE
 	{
 		sender.terminate();
 		receiver.terminate();
+		edu_timer.terminate();
 		sender.join();
 		receiver.join();
+		edu_timer.join();
 	}
 };
 
@@ -293,6 +366,9 @@ send_to_room(const m::event &event,
 			it->second
 		};
 
+		if(coalescible(event))
+			return node.coalesce(event);
+
 		if(!unit)
 			unit = std::make_shared<struct unit>(event);
 
@@ -395,6 +471,12 @@ send_from_user(const m::event &event,
 			it->second
 		};
 
+		if(coalescible(event))
+		{
+			node.coalesce(event);
+			return true;
+		}
+
 		auto unit
 		{
 			std::make_shared<struct unit>(event)
@@ -412,14 +494,375 @@ node::push(std::shared_ptr<unit> su)
 	q.emplace_back(std::move(su));
 }
 
+/// Absorb a typing, receipt or presence EDU into the stage. Nothing is sent
+/// here; the stage is flushed with the next transaction or by the edu timer.
+void
+node::coalesce(const m::event &event)
+{
+	const auto &type
+	{
+		json::get<"type"_>(event)
+	};
+
+	const json::object &content
+	{
+		json::get<"content"_>(event)
+	};
+
+	const bool was_empty
+	{
+		edus.empty()
+	};
+
+	switch(hash(type))
+	{
+		// Only the latest typing state of a user in a room is sent.
+		case hash("m.typing"):
+		{
+			const json::string &room_id(content.get("room_id"));
+			const json::string &user_id(content.get("user_id"));
+			stage(edu_key({type, room_id, user_id}), content);
+			break;
+		}
+
+		// Only the latest receipt of each type by a user in a room is sent;
+		// all staged receipts are then sent as one EDU.
+		case hash("m.receipt"):
+			for(const auto &[room_id, receipts] : content)
+				for(const auto &[receipt_type, users] : json::object{receipts})
+					for(const auto &[user_id, data] : json::object{users})
+						stage(edu_key({type, room_id, receipt_type, user_id}), data);
+			break;
+
+		// Only the latest presence of a user is sent, and no more often than
+		// the presence interval; all staged presence is sent as one EDU.
+		case hash("m.presence"):
+			for(const json::object &push : json::array(content.get("push")))
+			{
+				const json::string &user_id(push.get("user_id"));
+				const auto it(presence_sent.find(user_id));
+				if(it != end(presence_sent))
+					if(now<steady_point>() < it->second + milliseconds(edu_presence_interval))
+						++edus_deferred;
+
+				stage(edu_key({type, user_id}), push);
+			}
+			break;
+
+		default:
+			assert(0);
+			return;
+	}
+
+	if(was_empty && !edus.empty())
+		edus_since = now<steady_point>();
+
+	edu_action.notify_one();
+}
+
+/// Returns true if the key was newly staged; false if it replaced an update
+/// which was already staged.
+bool
+node::stage(std::string key,
+            const string_view &val)
+{
+	++edus_staged;
+	const auto it
+	{
+		edus.lower_bound(key)
+	};
+
+	if(it != end(edus) && it->first == key)
+	{
+		it->second = val;
+		++edus_squashed;
+		return false;
+	}
+
+	edus.emplace_hint(it, std::move(key), val);
+	return true;
+}
+
+/// Compose the staged updates into at most `max` EDUs appended to `out`,
+/// removing them from the stage. Presence for a user sent within the
+/// presence interval remains staged.
+size_t
+node::take_edus(std::vector<std::string> &out,
+                const size_t &max)
+{
+	const auto now
+	{
+		ircd::now<steady_point>()
+	};
+
+	const auto prefixed{[this](const string_view &type)
+	{
+		const auto prefix
+		{
+			edu_key({type, {}})
+		};
+
+		auto it(edus.lower_bound(prefix));
+		auto stop(it);
+		while(stop != end(edus) && startswith(stop->first, prefix))
+			++stop;
+
+		return std::make_pair(it, stop);
+	}};
+
+	const auto key_part{[](const string_view &key, const size_t &i)
+	{
+		return token(key, '\0', i);
+	}};
+
+	const size_t start(out.size());
+
+	// Typing is one EDU per user and room.
+	auto [typing, typing_end]
+	{
+		prefixed("m.typing")
+	};
+
+	while(typing != typing_end && out.size() - start < max)
+	{
+		out.emplace_back(json::strung{json::members
+		{
+			{ "content",   json::object{typing->second}  },
+			{ "edu_type",  "m.typing"                    },
+		}});
+
+		typing = edus.erase(typing);
+	}
+
+	// Receipts are merged into one EDU; they're sorted by room and type.
+	const auto [receipt, receipt_end]
+	{
+		prefixed("m.receipt")
+	};
+
+	if(receipt != receipt_end && out.size() - start < max)
+	{
+		size_t reserve(256);
+		for(auto it(receipt); it != receipt_end; ++it)
+			reserve += size(it->first) + size(it->second) + 16;
+
+		std::string buf(reserve, char{});
+		json::stack js{mutable_buffer{buf}};
+		{
+			json::stack::object edu{js};
+			json::stack::member
+			{
+				edu, "edu_type", json::value{"m.receipt"}
+			};
+
+			json::stack::object content{edu, "content"};
+			for(auto room(receipt); room != receipt_end; )
+			{
+				const auto room_id(key_part(room->first, 1));
+				json::stack::object room_object{content, room_id};
+				while(room != receipt_end && key_part(room->first, 1) == room_id)
+				{
+					const auto type(key_part(room->first, 2));
+					json::stack::object type_object{room_object, type};
+					for(; room != receipt_end && key_part(room->first, 1) == room_id && key_part(room->first, 2) == type; ++room)
+						json::stack::member
+						{
+							type_object, key_part(room->first, 3), json::object{room->second}
+						};
+				}
+			}
+		}
+
+		out.emplace_back(js.completed());
+		edus.erase(receipt, receipt_end);
+	}
+
+	// Presence ready under the rate limit is merged into one EDU.
+	const auto [presence, presence_end]
+	{
+		prefixed("m.presence")
+	};
+
+	std::vector<json::value> push;
+	for(auto it(presence); it != presence_end; ++it)
+	{
+		const auto user_id(key_part(it->first, 1));
+		const auto sent(presence_sent.find(user_id));
+		if(sent == end(presence_sent) || now >= sent->second + milliseconds(edu_presence_interval))
+			push.emplace_back(string_view{it->second});
+	}
+
+	if(!push.empty() && out.size() - start < max)
+	{
+		out.emplace_back(json::strung{json::members
+		{
+			{ "content",
+			{
+				{ "push", { push.data(), push.size() } },
+			}},
+			{ "edu_type",  "m.presence" },
+		}});
+
+		for(auto it(presence); it != presence_end; )
+		{
+			const auto user_id(key_part(it->first, 1));
+			auto sent(presence_sent.lower_bound(user_id));
+			if(sent != end(presence_sent) && sent->first == user_id)
+			{
+				if(now < sent->second + milliseconds(edu_presence_interval))
+				{
+					++it;
+					continue;
+				}
+
+				sent->second = now;
+			}
+			else presence_sent.emplace_hint(sent, user_id, now);
+
+			it = edus.erase(it);
+		}
+	}
+
+	// Forget rate limit state which has lapsed.
+	for(auto it(begin(presence_sent)); it != end(presence_sent); )
+		if(now >= it->second + milliseconds(edu_presence_interval) && !edus.count(edu_key({"m.presence", it->first})))
+			it = presence_sent.erase(it);
+		else
+			++it;
+
+	if(!edus.empty())
+		edus_since = now;
+
+	return out.size() - start;
+}
+
+/// When the edu timer should flush the stage: the close of the window, or
+/// for staged presence alone the earliest release from its rate limit. The
+/// maximum when there's nothing the timer can send.
+steady_point
+node::edus_due()
+const
+{
+	if(edus.empty() || curtxn)
+		return steady_point::max();
+
+	const auto window_close
+	{
+		edus_since + milliseconds(edu_window)
+	};
+
+	// Presence sorts ahead of receipts and typing; anything else staged is
+	// found at the end.
+	const auto prefix
+	{
+		edu_key({"m.presence", {}})
+	};
+
+	if(!startswith(rbegin(edus)->first, prefix))
+		return window_close;
+
+	auto ret(steady_point::max());
+	for(const auto &[key, val] : edus)
+	{
+		const auto sent
+		{
+			presence_sent.find(token(key, '\0', 1))
+		};
+
+		ret = std::min(ret, sent != end(presence_sent)?
+			std::max(window_close, sent->second + milliseconds(edu_presence_interval)):
+			window_close);
+	}
+
+	return ret;
+}
+
+void
+__attribute__((noreturn))
+edu_worker()
+{
+	while(1) try
+	{
+		auto due(steady_point::max());
+		for(const auto &[remote, node] : nodes)
+			due = std::min(due, node.edus_due());
+
+		// Anything staged meanwhile wakes the timer to reconsider.
+		const auto now(ircd::now<steady_point>());
+		if(due == steady_point::max())
+		{
+			edu_action.wait();
+			continue;
+		}
+
+		if(due > now)
+		{
+			edu_action.wait_for(due - now);
+			continue;
+		}
+
+		for(auto &[remote, node] : nodes)
+			if(node.edus_due() <= now)
+				node.flush();
+	}
+	catch(const std::exception &e)
+	{
+		log::error
+		{
+			"edu worker: %s", e.what()
+		};
+	}
+}
+
+bool
+coalescible(const m::event &event)
+{
+	if(event.event_id)
+		return false;
+
+	switch(hash(json::get<"type"_>(event)))
+	{
+		case hash("m.typing"):
+		case hash("m.receipt"):
+		case hash("m.presence"):
+			return true;
+
+		default:
+			return false;
+	}
+}
+
+std::string
+edu_key(const std::initializer_list<string_view> &parts)
+{
+	std::string ret;
+	for(auto it(begin(parts)); it != end(parts); ++it)
+	{
+		if(it != begin(parts))
+			ret.push_back('\0');
+
+		ret.append(data(*it), size(*it));
+	}
+
+	return ret;
+}
+
 bool
 node::flush()
 try
 {
-	if(q.empty())
+	if(curtxn)
 		return true;
 
-	if(curtxn)
+	// Staged EDUs are sent when their window closes, or sooner when they
+	// can ride along with a transaction carrying something else anyway.
+	const bool edus_ready
+	{
+		!this->edus.empty()
+		&& now<steady_point>() >= edus_since + milliseconds(edu_window)
+	};
+
+	if(q.empty() && !edus_ready)
 		return true;
 
 	size_t pdus{0}, edus{0};
@@ -430,8 +873,20 @@ try
 		default:                   break;
 	}
 
+	std::vector<std::string> staged;
+	const size_t coalesced
+	{
+		take_edus(staged, size_t(edu_max) - std::min(edus, size_t(edu_max)))
+	};
+
+	if(!pdus && !edus && !coalesced)
+		return true;
+
 	size_t pc(0), ec(0);
-	std::vector<json::value> units(pdus + edus);
+	std::vector<json::value> units(pdus + edus + coalesced);
+	for(const auto &edu : staged)
+		units.at(pdus + ec++) = string_view{edu};
+
 	for(const auto &unit : q) switch(unit->type)
 	{
 		case unit::PDU:
@@ -460,6 +915,8 @@ try
 		units.data() + pdus, units.data() + pdus + ec
 	};
 
+	edus_sent += coalesced;
+
 	std::string content
 	{
 		m::txn::create(pduv, eduv)
@@ -471,10 +928,11 @@ try
 	q.clear();
 	log::debug
 	{
-		m::log, "sending txn %s pdus:%zu edus:%zu to '%s'",
+		m::log, "sending txn %s pdus:%zu edus:%zu coalesced:%zu to '%s'",
 		curtxn->txnid,
 		pdus,
 		edus,
+		coalesced,
 		this->remote,
 	};
 
@@ -545,6 +1003,10 @@ try
 	node.curtxn = nullptr;
 	txns.erase(it);
 
+	// The edu timer disregards a node while its transaction is in flight.
+	if(!node.edus.empty())
+		edu_action.notify_one();
+
 	if(!ret)
 		return;
 
@@ -15,6 +15,7 @@ extern "C" std::list<net::listener> listeners;
 extern "C" bool loaded_listener(const string_view &name);
 static bool load_listener(const string_view &, const json::object &);
 static bool load_listener(const m::event &);
+static bool secondary_listener(const string_view &name);
 extern "C" bool unload_listener(const string_view &name);
 extern "C" bool load_listener(const string_view &name);
 static void init_listeners();
@@ -42,6 +43,18 @@ _on_change{[](const auto &level)
 decltype(listeners)
 listeners;
 
+/// Space-separated names of the listeners which belong to a secondary
+/// instance (see ircd::secondary). A secondary shares the listener
+/// configuration of its primary but must bind addresses of its own: it loads
+/// only these listeners and the primary loads all but these. This can be
+/// given to a secondary in the environment (i.e. ircd_listen_secondary).
+conf::item<std::string>
+listen_secondary
+{
+	{ "name",     "ircd.listen.secondary" },
+	{ "default",  string_view{}           },
+};
+
 //
 // On module load any existing listener descriptions are sought out
 // of room state and instantiated (i.e on startup).
@@ -119,7 +132,12 @@ init_listeners()
 		load_listener(event);
 	});
 
-	if(listeners.empty())
+	if(listeners.empty() && ircd::secondary)
+		log::warning
+		{
+			"No listeners named in ircd.listen.secondary; a secondary can't hear anyone."
+		};
+	else if(listeners.empty())
 		log::warning
 		{
 			"No listening sockets configured; can't hear anyone."
@@ -216,9 +234,32 @@ load_listener(const m::event &event)
 		json::get<"content"_>(event)
 	};
 
+	if(secondary_listener(name) != bool(ircd::secondary))
+	{
+		log::debug
+		{
+			"Skipping listener '%s' for the %s instance",
+			name,
+			ircd::secondary? "primary"_sv: "secondary"_sv,
+		};
+
+		return false;
+	}
+
 	return load_listener(name, opts);
 }
 
+bool
+secondary_listener(const string_view &name)
+{
+	const string_view &list
+	{
+		listen_secondary
+	};
+
+	return token_exists(list, ' ', name);
+}
+
 ctx::context
 _listener_allow
 {
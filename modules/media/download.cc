@@ -32,6 +32,20 @@ download_resource__legacy
 	}
 };
 
+using range = std::pair<size_t, size_t>; // first, last (inclusive)
+
+static bool
+parse_ranges(std::vector<range> &,
+             const string_view &header,
+             const size_t &file_size);
+
+static m::resource::response
+get__download_ranges(client &client,
+                     const m::room &room,
+                     const vector_view<const range> &ranges,
+                     const size_t &file_size,
+                     const string_view &content_type);
+
 static m::resource::response
 get__download_local(client &client,
                     const m::resource::request &request,
@@ -39,6 +53,13 @@ get__download_local(client &client,
                     const string_view &file,
                     const m::room &room);
 
+conf::item<size_t>
+download_ranges_max
+{
+	{ "name",     "ircd.media.download.ranges.max" },
+	{ "default",  16L                              },
+};
+
 static m::resource::response
 get__download(client &client,
               const m::resource::request &request)
@@ -127,10 +148,17 @@ get__download_local(client &client,
 		};
 	});
 
+	// A Range is only honored unconditionally; there is no validator to
+	// compare an If-Range against, so the whole file is sent instead.
+	std::vector<range> ranges;
+	if(request.head.range && !request.head.if_range)
+		if(parse_ranges(ranges, request.head.range, file_size))
+			return get__download_ranges(client, room, ranges, file_size, content_type);
+
 	// Send HTTP head to client
 	m::resource::response
 	{
-		client, http::OK, content_type, file_size
+		client, http::OK, content_type, file_size, "Accept-Ranges: bytes\r\n"
 	};
 
 	size_t sent{0}, read
@@ -160,6 +188,208 @@ get__download_local(client &client,
 	return {};
 }
 
+/// Send the ranges of the file. A single range is sent as the content;
+/// several are sent as multipart/byteranges. Only the blocks overlapping
+/// each range are read. An empty set of ranges is not satisfiable.
+m::resource::response
+get__download_ranges(client &client,
+                     const m::room &room,
+                     const vector_view<const range> &ranges,
+                     const size_t &file_size,
+                     const string_view &content_type)
+{
+	char headers[128];
+	if(ranges.empty())
+		return m::resource::response
+		{
+			client, http::RANGE_NOT_SATISFIABLE, content_type, 0UL, fmt::sprintf
+			{
+				headers, "Content-Range: bytes */%zu\r\n", file_size
+			}
+		};
+
+	const auto send{[&client, &room]
+	(const range &range)
+	{
+		const size_t length
+		{
+			range.second - range.first + 1
+		};
+
+		const size_t read
+		{
+			m::media::file::read(room, range.first, length, [&client]
+			(const const_buffer &block)
+			{
+				write_all(*client.sock, block);
+			})
+		};
+
+		if(likely(read == length))
+			return true;
+
+		log::error
+		{
+			m::media::log, "File [%s] range %zu-%zu size mismatch: expected %zu got %zu",
+			string_view{room.room_id},
+			range.first,
+			range.second,
+			length,
+			read,
+		};
+
+		// Have to kill client here after failing content length expectation.
+		client.close(net::dc::RST, net::close_ignore);
+		return false;
+	}};
+
+	if(ranges.size() == 1)
+	{
+		const auto &range(ranges[0]);
+		m::resource::response
+		{
+			client, http::PARTIAL_CONTENT, content_type, range.second - range.first + 1, fmt::sprintf
+			{
+				headers, "Accept-Ranges: bytes\r\nContent-Range: bytes %zu-%zu/%zu\r\n",
+				range.first,
+				range.second,
+				file_size,
+			}
+		};
+
+		send(range);
+		return {};
+	}
+
+	char boundary_buf[32];
+	const string_view boundary
+	{
+		rand::string(rand::dict::alnum, boundary_buf)
+	};
+
+	// The head of each part is composed up front to know the content length.
+	const unique_buffer<mutable_buffer> part_buf
+	{
+		ranges.size() * 256 + 64
+	};
+
+	std::vector<string_view> parts(ranges.size());
+	size_t content_length{0};
+	window_buffer part_window{part_buf};
+	for(size_t i(0); i < ranges.size(); ++i)
+	{
+		parts[i] = part_window([&](const mutable_buffer &buf)
+		{
+			return fmt::sprintf
+			{
+				buf, "%s--%s\r\nContent-Type: %s\r\nContent-Range: bytes %zu-%zu/%zu\r\n\r\n",
+				i? "\r\n"_sv: string_view{},
+				boundary,
+				content_type,
+				ranges[i].first,
+				ranges[i].second,
+				file_size,
+			};
+		});
+
+		content_length += size(parts[i]) + ranges[i].second - ranges[i].first + 1;
+	}
+
+	const string_view trailer
+	{
+		part_window([&boundary](const mutable_buffer &buf)
+		{
+			return fmt::sprintf
+			{
+				buf, "\r\n--%s--\r\n", boundary
+			};
+		})
+	};
+
+	content_length += size(trailer);
+	char type_buf[96];
+	m::resource::response
+	{
+		client, http::PARTIAL_CONTENT, fmt::sprintf
+		{
+			type_buf, "multipart/byteranges; boundary=%s", boundary
+		},
+		content_length,
+		"Accept-Ranges: bytes\r\n"
+	};
+
+	for(size_t i(0); i < ranges.size(); ++i)
+	{
+		write_all(*client.sock, parts[i]);
+		if(!send(ranges[i]))
+			return {};
+	}
+
+	write_all(*client.sock, trailer);
+	return {};
+}
+
+/// Parse a Range header of byte ranges, e.g. `bytes=0-499,-500`, into
+/// inclusive ranges of the file. Returns false if the header should be
+/// ignored (malformed, another unit or too many ranges) in which case the
+/// whole file is sent. Ranges starting beyond the file are dropped; if
+/// none remain the request is not satisfiable.
+bool
+parse_ranges(std::vector<range> &out,
+             const string_view &header,
+             const size_t &file_size)
+{
+	const auto &[unit, set]
+	{
+		split(header, '=')
+	};
+
+	if(strip(unit) != "bytes")
+		return false;
+
+	bool ret(true);
+	size_t count(0);
+	tokens(set, ',', token_view_bool{[&](const string_view &spec_)
+	{
+		const auto &spec(strip(spec_));
+		const auto &[first, last]
+		{
+			split(spec, '-')
+		};
+
+		ret &= ++count <= size_t(download_ranges_max);
+		ret &= spec.find('-') != spec.npos;
+		ret &= !first || lex_castable<ulong>(first);
+		ret &= !last || lex_castable<ulong>(last);
+		ret &= first || last;
+		if(!ret)
+			return false;
+
+		// suffix range of the last n bytes
+		if(!first)
+		{
+			const auto n(lex_cast<ulong>(last));
+			if(n && file_size)
+				out.emplace_back(file_size - std::min(n, file_size), file_size - 1);
+
+			return true;
+		}
+
+		const auto start(lex_cast<ulong>(first));
+		const auto end(last? lex_cast<ulong>(last): -1UL);
+		ret &= start <= end;
+		if(ret && start < file_size)
+			out.emplace_back(start, std::min(end, file_size - 1));
+
+		return ret;
+	}});
+
+	if(!ret)
+		out.clear();
+
+	return ret;
+}
+
 static m::resource::method
 method_get
 {
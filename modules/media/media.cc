@@ -198,11 +198,14 @@ ircd::m::media::init()
 		{
 			log, "GraphicsMagick support is disabled or unavailable."
 		};
+
+	thumbnail::init();
 }
 
 void
 ircd::m::media::fini()
 {
+	thumbnail::fini();
 	magick_support.reset();
 
 	// The database close contains pthread_join()'s within RocksDB which
@@ -412,11 +415,41 @@ ircd::m::media::file::write(const m::room &room,
                             const m::user::id &user_id,
                             const const_buffer &content,
                             const string_view &content_type)
+{
+	size_t off{0};
+	return write(room, user_id, size(content), content_type, [&content, &off]
+	(const mutable_buffer &buf)
+	{
+		const size_t copied
+		{
+			copy(buf, content + off)
+		};
+
+		off += copied;
+		return const_buffer
+		{
+			data(buf), copied
+		};
+	});
+}
+
+/// Write a file of content_length bytes into the room one block at a time.
+/// The source is called with a buffer for the next block and must fill it
+/// entirely unless the content has ended. Only one block is held in memory
+/// and the source isn't called again until the prior block is written, so
+/// a source reading from a socket is paced by the database.
+size_t
+IRCD_MODULE_EXPORT
+ircd::m::media::file::write(const m::room &room,
+                            const m::user::id &user_id,
+                            const size_t &content_length,
+                            const string_view &content_type,
+                            const source &source)
 {
 	//TODO: TXN
 	send(room, user_id, "ircd.file.stat", "size", json::members
 	{
-		{ "value", long(size(content)) }
+		{ "value", long(content_length) }
 	});
 
 	//TODO: TXN
@@ -425,26 +458,54 @@ ircd::m::media::file::write(const m::room &room,
 		{ "value", content_type }
 	});
 
-	size_t off{0}, wrote{0};
-	while(off < size(content))
+	const unique_buffer<mutable_buffer> buf
 	{
-		const size_t blksz
+		32_KiB
+	};
+
+	sha256 hash;
+	size_t wrote{0};
+	while(wrote < content_length)
+	{
+		const mutable_buffer dst
 		{
-			std::min(size(content) - off, size_t(32_KiB))
+			data(buf), std::min(content_length - wrote, size(buf))
 		};
 
 		const const_buffer &block
 		{
-			data(content) + off, blksz
+			source(dst)
 		};
 
+		if(unlikely(size(block) != size(dst)))
+			throw error
+			{
+				"File [%s] content ended after %zu of %zu bytes",
+				string_view{room.room_id},
+				wrote + size(block),
+				content_length,
+			};
+
+		hash.update(block);
 		block::set(room, user_id, block);
 		wrote += size(block);
-		off += blksz;
 	}
 
-	assert(off == size(content));
-	assert(wrote == off);
+	assert(wrote == content_length);
+	const sha256::buf digest
+	{
+		[&hash](const mutable_buffer &buf)
+		{
+			hash.finalize(buf);
+		}
+	};
+
+	char b58buf[b58encode_size(sha256::digest_size)];
+	send(room, user_id, "ircd.file.stat", "hash", json::members
+	{
+		{ "value", b58encode(b58buf, digest) }
+	});
+
 	return wrote;
 }
 
@@ -452,12 +513,32 @@ size_t
 IRCD_MODULE_EXPORT
 ircd::m::media::file::read(const m::room &room,
                            const closure &closure)
+{
+	return read(room, 0, -1UL, closure);
+}
+
+/// Read length bytes of the file starting at offset. Blocks are located by
+/// the size in their event; blocks outside the range are neither fetched nor
+/// prefetched. The closure is given views into the fetched blocks.
+size_t
+IRCD_MODULE_EXPORT
+ircd::m::media::file::read(const m::room &room,
+                           const size_t &offset,
+                           const size_t &length,
+                           const closure &closure)
 {
 	static const event::fetch::opts fopts
 	{
 		event::keys::include { "content", "type" }
 	};
 
+	const size_t stop
+	{
+		length < -1UL - offset?
+			offset + length:
+			-1UL
+	};
+
 	size_t ret{0};
 	room::events it
 	{
@@ -473,15 +554,15 @@ ircd::m::media::file::read(const m::room &room,
 		room, 1, &fopts
 	};
 
-	size_t blocks_fetched(0), blocks_prefetched(0);
+	size_t blocks_fetched(0), blocks_prefetched(0), bpf_pos(0);
 	room::events bpf
 	{
 		room, 1, &fopts
 	};
 
-	for(; it; ++it)
+	for(size_t pos(0); it && pos < stop; ++it)
 	{
-		for(; bpf && blocks_prefetched < blocks_fetched + blocks_prefetch; ++bpf)
+		for(; bpf && bpf_pos < stop && blocks_prefetched < blocks_fetched + blocks_prefetch; ++bpf)
 		{
 			for(; epf && events_prefetched < events_fetched + events_prefetch; ++epf)
 				events_prefetched += epf.prefetch();
@@ -495,6 +576,10 @@ ircd::m::media::file::read(const m::room &room,
 			if(at<"type"_>(event) != "ircd.file.block")
 				continue;
 
+			bpf_pos += at<"content"_>(event).get<size_t>("size");
+			if(bpf_pos <= offset)
+				continue;
+
 			const json::string &hash
 			{
 				at<"content"_>(event).at("hash")
@@ -503,10 +588,6 @@ ircd::m::media::file::read(const m::room &room,
 			blocks_prefetched += block::prefetch(hash);
 		}
 
-		if(!blocks_fetched)
-			ctx::yield();
-
-		++blocks_fetched;
 		const m::event &event
 		{
 			*it
@@ -515,14 +596,23 @@ ircd::m::media::file::read(const m::room &room,
 		if(at<"type"_>(event) != "ircd.file.block")
 			continue;
 
-		const json::string &hash
+		const auto &block_size
 		{
-			at<"content"_>(event).at("hash")
+			at<"content"_>(event).get<size_t>("size")
 		};
 
-		const auto &block_size
+		const size_t block_pos(pos);
+		pos += block_size;
+		if(pos <= offset)
+			continue;
+
+		if(!blocks_fetched)
+			ctx::yield();
+
+		++blocks_fetched;
+		const json::string &hash
 		{
-			at<"content"_>(event).get<size_t>("size")
+			at<"content"_>(event).at("hash")
 		};
 
 		const auto handle{[&](const const_buffer &block)
@@ -540,7 +630,13 @@ ircd::m::media::file::read(const m::room &room,
 				};
 
 			assert(size(block) == block_size);
-			ret += size(block);
+			const const_buffer slice
+			{
+				data(block) + (offset > block_pos? offset - block_pos : 0),
+				data(block) + std::min(block_size, stop - block_pos)
+			};
+
+			ret += size(slice);
 
 			#if 0
 			log::debug
@@ -557,7 +653,7 @@ ircd::m::media::file::read(const m::room &room,
 			};
 			#endif
 
-			closure(block);
+			closure(slice);
 		}};
 
 		if(unlikely(!block::get(hash, handle)))
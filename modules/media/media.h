@@ -36,6 +36,22 @@ namespace ircd::m::media
 
 namespace ircd::m::media::thumbnail
 {
+	using dimensions = std::pair<size_t, size_t>;
+
+	void init();
+	void fini();
+
+	room::id::buf room_id(const mxc &, const string_view &method, const dimensions &);
+	void generate(const mxc &, const const_buffer &, const string_view &content_type, const string_view &method, const dimensions &, const file::closure & = {});
+	bool enqueue(const mxc &);
+
+	extern conf::item<bool> cache_enable;
+	extern conf::item<std::string> presets;
+	extern conf::item<size_t> queue_max;
+	extern std::deque<std::string> queue;
+	extern ctx::dock queue_dock;
+	extern ctx::context worker;
+
 	extern conf::item<bool> enable;
 	extern conf::item<bool> enable_remote;
 	extern conf::item<size_t> width_min;
@@ -13,6 +13,21 @@
 using namespace ircd::m::media::thumbnail; //TODO: XXX
 using namespace ircd;
 
+namespace ircd::m::media::thumbnail
+{
+	using preset_closure = std::function<bool (const string_view &method, const dimensions &)>;
+
+	static bool for_each_preset(const preset_closure &);
+	static bool fit_preset(string_view &method, dimensions &);
+	static bool permitted(const string_view &content_type);
+	static std::pair<size_t, string_view> stat(const m::room &, const mutable_buffer &type_buf);
+	static unique_buffer<mutable_buffer> read(const m::room &, const size_t &file_size);
+	static bool cached(const m::room::id &);
+	static void store(const mxc &, const const_buffer &, const string_view &content_type, const string_view &method, const dimensions &);
+	static void pregenerate(const mxc &);
+	static void worker_main();
+}
+
 decltype(ircd::m::media::thumbnail::enable)
 ircd::m::media::thumbnail::enable
 {
@@ -69,6 +84,40 @@ ircd::m::media::thumbnail::mime_blacklist
 	{ "default",  ""                                      },
 };
 
+decltype(ircd::m::media::thumbnail::cache_enable)
+ircd::m::media::thumbnail::cache_enable
+{
+	{ "name",     "ircd.m.media.thumbnail.cache.enable" },
+	{ "default",  true                                  },
+};
+
+/// Space-separated list of WIDTHxHEIGHT:METHOD. These are generated in the
+/// background for every local upload; requests are served with the smallest
+/// preset of their method at least as large as requested. Requests larger
+/// than every preset are thumbnailed on demand and not cached.
+decltype(ircd::m::media::thumbnail::presets)
+ircd::m::media::thumbnail::presets
+{
+	{ "name",     "ircd.m.media.thumbnail.presets"                                  },
+	{ "default",  "32x32:crop 96x96:crop 320x240:scale 640x480:scale 800x600:scale" },
+};
+
+decltype(ircd::m::media::thumbnail::queue_max)
+ircd::m::media::thumbnail::queue_max
+{
+	{ "name",     "ircd.m.media.thumbnail.queue.max" },
+	{ "default",  256L                               },
+};
+
+decltype(ircd::m::media::thumbnail::queue)
+ircd::m::media::thumbnail::queue;
+
+decltype(ircd::m::media::thumbnail::queue_dock)
+ircd::m::media::thumbnail::queue_dock;
+
+decltype(ircd::m::media::thumbnail::worker)
+ircd::m::media::thumbnail::worker;
+
 m::resource
 thumbnail_resource__legacy
 {
@@ -165,12 +214,12 @@ get__thumbnail_local(client &client,
                      const m::media::mxc &mxc,
                      const m::room &room)
 {
-	const auto &method
+	string_view method
 	{
 		request.query.get("method", "scale"_sv)
 	};
 
-	std::pair<size_t, size_t> dimension
+	dimensions dimension
 	{
 		request.query.get<size_t>("width", 0),
 		request.query.get<size_t>("height", 0)
@@ -188,100 +237,81 @@ get__thumbnail_local(client &client,
 		dimension.second = std::min(dimension.second, size_t(height_max));
 	}
 
-	static const m::event::fetch::opts fopts
+	const bool valid_args
 	{
-		m::event::keys::include {"content"}
-	};
+		// Both dimension parameters given in query string
+		(dimension.first && dimension.second)
 
-	const m::room::state state
-	{
-		room, &fopts
+		// Known thumbnailing method in query string
+		&& (method == "scale" || method == "crop")
 	};
 
-	// Get the file's total size
-	size_t file_size{0};
-	state.get("ircd.file.stat", "size", [&file_size]
-	(const m::event &event)
+	// A cached thumbnail is served without reading the original at all.
+	const bool cacheable
 	{
-		file_size = at<"content"_>(event).get<size_t>("value");
-	});
+		enable && cache_enable && valid_args && fit_preset(method, dimension)
+	};
 
-	// Get the MIME type
-	char type_buf[64];
-	string_view content_type
+	const m::room::id::buf cache_room_id
 	{
-		"application/octet-stream"
+		cacheable?
+			room_id(mxc, method, dimension):
+			m::room::id::buf{}
 	};
 
-	state.get("ircd.file.stat", "type", [&type_buf, &content_type]
-	(const m::event &event)
+	if(cacheable && cached(cache_room_id))
 	{
-		const auto &value
+		const m::room cache_room
 		{
-			unquote(at<"content"_>(event).at("value"))
+			cache_room_id
 		};
 
-		content_type =
+		char type_buf[64];
+		const auto [file_size, content_type]
 		{
-			type_buf, copy(type_buf, value)
+			m::media::thumbnail::stat(cache_room, type_buf)
 		};
-	});
 
-	const unique_buffer<mutable_buffer> buf
-	{
-		file_size
-	};
-
-	size_t copied(0);
-	const auto sink{[&buf, &copied]
-	(const const_buffer &block)
-	{
-		copied += copy(buf + copied, block);
-	}};
-
-	const size_t read_size
-	{
-		m::media::file::read(room, sink)
-	};
+		m::resource::response
+		{
+			client, http::OK, content_type, file_size
+		};
 
-	if(unlikely(read_size != file_size || file_size != copied))
-		throw ircd::error
+		const size_t read
 		{
-			"File %s/%s [%s] size mismatch: expected %zu got %zu copied %zu",
-			mxc.server,
-			mxc.mediaid,
-			string_view{room.room_id},
-			file_size,
-			read_size,
-			copied
+			m::media::file::read(cache_room, [&client]
+			(const const_buffer &block)
+			{
+				write_all(*client.sock, block);
+			})
 		};
 
-	const bool available
+		// Have to kill client here after failing content length expectation.
+		if(unlikely(read != file_size))
+			client.close(net::dc::RST, net::close_ignore);
+
+		return {};
+	}
+
+	char type_buf[64];
+	const auto [file_size, content_type]
 	{
-		m::media::magick_support
+		m::media::thumbnail::stat(room, type_buf)
 	};
 
-	const auto mime_type
+	const unique_buffer<mutable_buffer> buf
 	{
-		split(content_type, ';').first
+		m::media::thumbnail::read(room, file_size)
 	};
 
-	const bool permitted
+	const bool available
 	{
-		// If there's a blacklist, mime type must not in the blacklist.
-		(!mime_blacklist || !has(mime_blacklist, mime_type))
-
-		// If there's a whitelist, mime type must be in the whitelist.
-		&& (!mime_whitelist || has(mime_whitelist, mime_type))
+		m::media::magick_support
 	};
 
-	const bool valid_args
+	const bool permitted
 	{
-		// Both dimension parameters given in query string
-		(dimension.first && dimension.second)
-
-		// Known thumbnailing method in query string
-		&& (method == "scale" || method == "crop")
+		m::media::thumbnail::permitted(content_type)
 	};
 
 	const bool fallback // Reasons to just send the original image
@@ -321,16 +351,19 @@ get__thumbnail_local(client &client,
 			client, buf, content_type
 		};
 
-	const auto closure{[&client, &content_type]
+	const auto closure{[&client]
 	(const const_buffer &buf)
 	{
+		char type_buf[64];
 		m::resource::response
 		{
-			client, buf, content_type
+			client, buf, magic::mime(type_buf, buf)
 		};
 	}};
 
-	if(method == "crop")
+	if(cacheable)
+		generate(mxc, buf, content_type, method, dimension, closure);
+	else if(method == "crop")
 		magick::thumbcrop
 		{
 			buf, dimension, closure
@@ -343,3 +376,427 @@ get__thumbnail_local(client &client,
 
 	return {}; // responded from closure.
 }
+
+//
+// thumbnail
+//
+
+ircd::m::room::id::buf
+ircd::m::media::thumbnail::room_id(const mxc &mxc,
+                                   const string_view &method,
+                                   const dimensions &dimension)
+{
+	char buf[256];
+	const string_view mediaid
+	{
+		fmt::sprintf
+		{
+			buf, "%s.%s.%zux%zu",
+			mxc.mediaid,
+			method,
+			dimension.first,
+			dimension.second,
+		}
+	};
+
+	return file::room_id(media::mxc
+	{
+		mxc.server, mediaid
+	});
+}
+
+/// Thumbnail the original; the closure is given the result before it is
+/// stored in the cache so a client waiting on it is not also made to wait
+/// for the write. Failure to store is logged and otherwise ignored.
+void
+ircd::m::media::thumbnail::generate(const mxc &mxc,
+                                    const const_buffer &original,
+                                    const string_view &content_type,
+                                    const string_view &method,
+                                    const dimensions &dimension,
+                                    const file::closure &closure)
+{
+	unique_buffer<mutable_buffer> result;
+	const auto make{[&result]
+	(const const_buffer &buf)
+	{
+		result = unique_buffer<mutable_buffer>
+		{
+			buf
+		};
+	}};
+
+	if(method == "crop")
+		ircd::magick::thumbcrop
+		{
+			original, dimension, make
+		};
+	else
+		ircd::magick::thumbnail
+		{
+			original, dimension, make
+		};
+
+	if(closure)
+		closure(result);
+
+	char type_buf[64];
+	store(mxc, result, magic::mime(type_buf, result), method, dimension);
+}
+
+void
+ircd::m::media::thumbnail::store(const mxc &mxc,
+                                 const const_buffer &content,
+                                 const string_view &content_type,
+                                 const string_view &method,
+                                 const dimensions &dimension)
+try
+{
+	if(!cache_enable)
+		return;
+
+	const m::room::id::buf room_id
+	{
+		thumbnail::room_id(mxc, method, dimension)
+	};
+
+	// Readers of the cache wait on this entry rather than finding a
+	// partially written file.
+	auto iit
+	{
+		downloading.emplace(room_id)
+	};
+
+	if(!iit.second)
+		return;
+
+	const unwind uw{[&iit]
+	{
+		downloading.erase(iit.first);
+		downloading_dock.notify_all();
+	}};
+
+	if(exists(room_id))
+		return;
+
+	m::vm::copts vmopts;
+	vmopts.history = false;
+	const m::room room
+	{
+		room_id, &vmopts
+	};
+
+	create(room, m::me(), "file");
+	const unwind_exceptional purge{[&room]
+	{
+		m::room::purge(room);
+	}};
+
+	file::write(room, m::me(), content, content_type);
+}
+catch(const ctx::interrupted &)
+{
+	throw;
+}
+catch(const std::exception &e)
+{
+	log::error
+	{
+		log, "Failed to cache %s thumbnail %zux%zu of %s/%s :%s",
+		method,
+		dimension.first,
+		dimension.second,
+		mxc.server,
+		mxc.mediaid,
+		e.what(),
+	};
+}
+
+/// Queue the file for generation of all presets by the worker. Returns false
+/// when the queue is full or the thumbnailer is unavailable.
+bool
+ircd::m::media::thumbnail::enqueue(const mxc &mxc)
+{
+	if(!enable || !cache_enable || !magick_support || !worker)
+		return false;
+
+	if(queue.size() >= size_t(queue_max))
+	{
+		log::dwarning
+		{
+			log, "Thumbnail queue full; not pregenerating %s/%s",
+			mxc.server,
+			mxc.mediaid,
+		};
+
+		return false;
+	}
+
+	char buf[512];
+	queue.emplace_back(mxc.path(buf));
+	queue_dock.notify_one();
+	return true;
+}
+
+void
+ircd::m::media::thumbnail::init()
+{
+	worker = ctx::context
+	{
+		"m.media.thumb", size_t(client::settings::stack_size), worker_main
+	};
+}
+
+void
+ircd::m::media::thumbnail::fini()
+{
+	// Terminates and joins the worker.
+	worker = ctx::context{};
+	queue.clear();
+}
+
+void
+ircd::m::media::thumbnail::worker_main()
+{
+	while(1)
+	{
+		queue_dock.wait([]
+		{
+			return !queue.empty();
+		});
+
+		const std::string path
+		{
+			std::move(queue.front())
+		};
+
+		queue.pop_front();
+		pregenerate(media::mxc{path});
+	}
+}
+
+void
+ircd::m::media::thumbnail::pregenerate(const mxc &mxc)
+try
+{
+	const m::room room
+	{
+		file::room_id(mxc)
+	};
+
+	char type_buf[64];
+	const auto [file_size, content_type]
+	{
+		stat(room, type_buf)
+	};
+
+	if(!permitted(content_type) || !magick_support)
+		return;
+
+	unique_buffer<mutable_buffer> buf;
+	for_each_preset([&](const string_view &method, const dimensions &dimension)
+	{
+		if(exists(room_id(mxc, method, dimension)))
+			return true;
+
+		// The original is only read when there is something to generate.
+		if(!buf)
+			buf = read(room, file_size);
+
+		generate(mxc, buf, content_type, method, dimension);
+		return true;
+	});
+}
+catch(const ctx::interrupted &)
+{
+	throw;
+}
+catch(const std::exception &e)
+{
+	log::derror
+	{
+		log, "Failed to pregenerate thumbnails of %s/%s :%s",
+		mxc.server,
+		mxc.mediaid,
+		e.what(),
+	};
+}
+
+/// Wait for any write of the thumbnail in progress, then whether it exists.
+bool
+ircd::m::media::thumbnail::cached(const m::room::id &room_id)
+{
+	downloading_dock.wait([&room_id]
+	{
+		return !downloading.count(room_id);
+	});
+
+	return exists(room_id);
+}
+
+/// Find the smallest preset of the method at least as large as the
+/// dimensions in both axes; the dimensions are replaced with it.
+bool
+ircd::m::media::thumbnail::fit_preset(string_view &method,
+                                      dimensions &dimension)
+{
+	std::optional<dimensions> ret;
+	for_each_preset([&method, &dimension, &ret]
+	(const string_view &method_, const dimensions &preset)
+	{
+		if(method_ != method)
+			return true;
+
+		if(preset.first < dimension.first || preset.second < dimension.second)
+			return true;
+
+		if(!ret || preset.first * preset.second < ret->first * ret->second)
+			ret = preset;
+
+		return true;
+	});
+
+	if(!ret)
+		return false;
+
+	dimension = *ret;
+	method = method == "crop"? "crop"_sv : "scale"_sv;
+	return true;
+}
+
+bool
+ircd::m::media::thumbnail::for_each_preset(const preset_closure &closure)
+{
+	const std::string presets
+	{
+		thumbnail::presets
+	};
+
+	return tokens(presets, ' ', token_view_bool{[&closure]
+	(const string_view &preset)
+	{
+		const auto &[dims, method]
+		{
+			split(preset, ':')
+		};
+
+		const auto &[width, height]
+		{
+			split(dims, 'x')
+		};
+
+		const dimensions dimension
+		{
+			lex_castable<size_t>(width)? lex_cast<size_t>(width) : 0UL,
+			lex_castable<size_t>(height)? lex_cast<size_t>(height) : 0UL,
+		};
+
+		if(!dimension.first || !dimension.second)
+			return true;
+
+		if(method != "scale" && method != "crop")
+			return true;
+
+		return closure(method, dimension);
+	}});
+}
+
+bool
+ircd::m::media::thumbnail::permitted(const string_view &content_type)
+{
+	const auto mime_type
+	{
+		split(content_type, ';').first
+	};
+
+	return
+	{
+		// If there's a blacklist, mime type must not in the blacklist.
+		(!mime_blacklist || !has(mime_blacklist, mime_type))
+
+		// If there's a whitelist, mime type must be in the whitelist.
+		&& (!mime_whitelist || has(mime_whitelist, mime_type))
+	};
+}
+
+std::pair<size_t, ircd::string_view>
+ircd::m::media::thumbnail::stat(const m::room &room,
+                                const mutable_buffer &type_buf)
+{
+	static const m::event::fetch::opts fopts
+	{
+		m::event::keys::include {"content"}
+	};
+
+	const m::room::state state
+	{
+		room, &fopts
+	};
+
+	// Get the file's total size
+	size_t file_size{0};
+	state.get("ircd.file.stat", "size", [&file_size]
+	(const m::event &event)
+	{
+		file_size = at<"content"_>(event).get<size_t>("value");
+	});
+
+	// Get the MIME type
+	string_view content_type
+	{
+		"application/octet-stream"
+	};
+
+	state.get("ircd.file.stat", "type", [&type_buf, &content_type]
+	(const m::event &event)
+	{
+		const auto &value
+		{
+			unquote(at<"content"_>(event).at("value"))
+		};
+
+		content_type =
+		{
+			data(type_buf), copy(type_buf, value)
+		};
+	});
+
+	return
+	{
+		file_size, content_type
+	};
+}
+
+ircd::unique_buffer<ircd::mutable_buffer>
+ircd::m::media::thumbnail::read(const m::room &room,
+                                const size_t &file_size)
+{
+	unique_buffer<mutable_buffer> buf
+	{
+		file_size
+	};
+
+	size_t copied(0);
+	const auto sink{[&buf, &copied]
+	(const const_buffer &block)
+	{
+		copied += copy(buf + copied, block);
+	}};
+
+	const size_t read_size
+	{
+		m::media::file::read(room, sink)
+	};
+
+	if(unlikely(read_size != file_size || file_size != copied))
+		throw ircd::error
+		{
+			"File [%s] size mismatch: expected %zu got %zu copied %zu",
+			string_view{room.room_id},
+			file_size,
+			read_size,
+			copied
+		};
+
+	return buf;
+}
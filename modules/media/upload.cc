@@ -73,21 +73,41 @@ post__upload(client &client,
 	};
 
 	create(room, request.user_id, "file");
-
-	const unique_buffer<mutable_buffer> buf
+	const unwind_exceptional purge{[&room]
 	{
-		request.head.content_length
-	};
+		m::room::purge(room);
+	}};
+
+	// The content is written block by block as it is read off the socket;
+	// any part of it which arrived with the head is consumed first.
+	size_t partial{0};
+	const auto source{[&client, &request, &partial]
+	(const mutable_buffer &buf)
+	{
+		const size_t copied
+		{
+			copy(buf, const_buffer{request.content} + partial)
+		};
 
-	copy(buf, request.content);
-	client.content_consumed += read_all(*client.sock, buf + client.content_consumed);
-	assert(client.content_consumed == request.head.content_length);
+		partial += copied;
+		if(copied < size(buf))
+			client.content_consumed += read_all(*client.sock, buf + copied);
+
+		return const_buffer
+		{
+			data(buf), size(buf)
+		};
+	}};
 
 	const size_t written
 	{
-		m::media::file::write(room, request.user_id, buf, content_type)
+		m::media::file::write(room, request.user_id, request.head.content_length, content_type, source)
 	};
 
+	assert(written == request.head.content_length);
+	assert(client.content_consumed == request.head.content_length);
+	m::media::thumbnail::enqueue(mxc);
+
 	char uribuf[256];
 	const string_view content_uri
 	{
@@ -16,6 +16,33 @@ IRCD_MODULE
 	"Prometheus Metrics"
 };
 
+/// Composes the text exposition format for a chunked response. Each metric
+/// family is composed into memory without yielding while iterating the lists
+/// it reports; family() writes the previous family out as one chunk first.
+/// Nothing may yield between family() calls otherwise.
+struct exposition
+{
+	static constexpr size_t line_max {512};
+
+	resource::response::chunked &response;
+	std::string text;
+
+	void flush();
+	void family(const string_view &name, const string_view &type, const string_view &help = {});
+
+	template<class... args>
+	void operator()(const string_view &fmt, args&&... a);
+
+	exposition(resource::response::chunked &);
+};
+
+static void expose_stats(exposition &);
+static void expose_aio(exposition &);
+static void expose_ios(exposition &);
+static void expose_ctx(exposition &);
+static void expose_resource(exposition &);
+static void expose_db(exposition &);
+
 resource
 stats_resource
 {
@@ -39,37 +66,302 @@ resource::response
 get__stats(client &client,
            const resource::request &request)
 {
-	static const size_t buf_max
+	resource::response::chunked response
 	{
-		4096
+		client, http::OK, "text/plain; version=0.0.4"
 	};
 
-	char buf[buf_max];
-	std::stringstream out;
-	pubsetbuf(out, buf);
+	exposition out
+	{
+		response
+	};
+
+	expose_stats(out);
+	expose_aio(out);
+	expose_ios(out);
+	expose_ctx(out);
+	expose_resource(out);
+	expose_db(out);
+	out.flush();
+	return std::move(response);
+}
+
+void
+expose_stats(exposition &out)
+{
+	out.family("ircd_stats", "untyped", "ircd::stats items");
+	for(const auto &[name, item] : stats::items)
+		out("ircd_stats{name=\"%s\"} %ld\n",
+		    name,
+		    long(stats::get(*item)));
+
+	out.family("ircd_stats_histogram", "summary", "ircd::stats histograms");
+	for(const auto &[name, histogram] : stats::histograms)
+	{
+		for(const double quantile : {0.5, 0.9, 0.99, 0.999})
+			out("ircd_stats_histogram{name=\"%s\",quantile=\"%lf\"} %lu\n",
+			    name,
+			    quantile,
+			    histogram->percentile(quantile * 100.0));
+
+		out("ircd_stats_histogram_sum{name=\"%s\"} %lu\n",
+		    name,
+		    histogram->sum.load(std::memory_order_relaxed));
+
+		out("ircd_stats_histogram_count{name=\"%s\"} %lu\n",
+		    name,
+		    histogram->count.load(std::memory_order_relaxed));
+	}
+}
 
-	const time_t ts
+void
+expose_aio(exposition &out)
+{
+	const auto &stats
 	{
-		ircd::time<milliseconds>()
+		fs::aio::stats
 	};
 
-	out << "aio_requests_total"
-	    << ' ' << fs::aio::stats.requests
-	    << ' ' << ts
-	    << '\n';
+	const auto counter{[&out]
+	(const string_view &name, const uint64_t &val)
+	{
+		out.family(name, "counter");
+		out("%s %lu\n", name, val);
+	}};
+
+	const auto gauge{[&out]
+	(const string_view &name, const uint64_t &val)
+	{
+		out.family(name, "gauge");
+		out("%s %lu\n", name, val);
+	}};
+
+	counter("aio_requests_total", stats.requests);
+	counter("aio_requests_bytes_total", stats.bytes_requests);
+	counter("aio_complete_total", stats.complete);
+	counter("aio_complete_bytes_total", stats.bytes_complete);
+	counter("aio_submits_total", stats.submits);
+	counter("aio_chases_total", stats.chases);
+	counter("aio_handles_total", stats.handles);
+	counter("aio_events_total", stats.events);
+	counter("aio_cancel_total", stats.cancel);
+	counter("aio_cancel_bytes_total", stats.bytes_cancel);
+	counter("aio_errors_total", stats.errors);
+	counter("aio_errors_bytes_total", stats.bytes_errors);
+	counter("aio_reads_total", stats.reads);
+	counter("aio_reads_bytes_total", stats.bytes_read);
+	counter("aio_writes_total", stats.writes);
+	counter("aio_writes_bytes_total", stats.bytes_write);
+	counter("aio_stalls_total", stats.stalls);
+	gauge("aio_cur_reads", stats.cur_reads);
+	gauge("aio_cur_writes", stats.cur_writes);
+	gauge("aio_cur_write_bytes", stats.cur_bytes_write);
+	gauge("aio_cur_queued", stats.cur_queued);
+	gauge("aio_cur_submits", stats.cur_submits);
+}
 
-	out << "aio_requests_bytes_total"
-	    << ' ' << fs::aio::stats.bytes_requests
-	    << ' ' << ts
-	    << '\n';
+void
+expose_ios(exposition &out)
+{
+	using stats = struct ios::descriptor::stats;
 
-	const string_view output
+	const auto family{[&out]
+	(const string_view &name, const string_view &type, uint64_t stats::*const member)
 	{
-		view(out, buf)
+		out.family(name, type);
+		for(const auto *const &descriptor : ios::descriptor::list)
+			out("%s{name=\"%s\",id=\"%lu\"} %lu\n",
+			    name,
+			    descriptor->name,
+			    descriptor->id,
+			    (*descriptor->stats).*member);
+	}};
+
+	family("ircd_ios_queued", "gauge", &stats::queued);
+	family("ircd_ios_calls_total", "counter", &stats::calls);
+	family("ircd_ios_faults_total", "counter", &stats::faults);
+	family("ircd_ios_allocs_total", "counter", &stats::allocs);
+	family("ircd_ios_alloc_bytes_total", "counter", &stats::alloc_bytes);
+	family("ircd_ios_frees_total", "counter", &stats::frees);
+	family("ircd_ios_free_bytes_total", "counter", &stats::free_bytes);
+	family("ircd_ios_slab_hits_total", "counter", &stats::slab_hits);
+	family("ircd_ios_slab_misses_total", "counter", &stats::slab_misses);
+	family("ircd_ios_slice_cycles_total", "counter", &stats::slice_total);
+	family("ircd_ios_latency_cycles_total", "counter", &stats::latency_total);
+}
+
+void
+expose_ctx(exposition &out)
+{
+	size_t count(0);
+	ctx::for_each([&count](auto &)
+	{
+		++count;
+		return true;
+	});
+
+	out.family("ircd_ctx_count", "gauge", "Contexts currently allocated");
+	out("ircd_ctx_count %zu\n", count);
+
+	const auto &ticker
+	{
+		ctx::prof::get()
 	};
 
-	return resource::response
+	out.family("ircd_ctx_events_total", "counter", "Context profiling events");
+	for(size_t i(0); i < ticker.event.size(); ++i)
+	{
+		const auto event
+		{
+			static_cast<ctx::prof::event>(i)
+		};
+
+		if(event == ctx::prof::event::CYCLES)
+			continue;
+
+		out("ircd_ctx_events_total{event=\"%s\"} %lu\n",
+		    ctx::prof::reflect(event),
+		    ticker.event[i]);
+	}
+
+	out.family("ircd_ctx_cycles_total", "counter", "Reference cycles spent in contexts");
+	out("ircd_ctx_cycles_total %lu\n", ctx::prof::get(ctx::prof::event::CYCLES));
+
+	out.family("ircd_ctx_prio_cycles_total", "counter", "Reference cycles spent by priority class");
+	for(size_t i(0); i < num_of<ctx::prio>(); ++i)
+		out("ircd_ctx_prio_cycles_total{class=\"%s\"} %lu\n",
+		    ctx::reflect(ctx::prio(i)),
+		    ctx::prof::get(ctx::prio(i)));
+}
+
+void
+expose_resource(exposition &out)
+{
+	using stats = struct resource::method::stats;
+
+	const auto family{[&out]
+	(const string_view &name, const string_view &type, uint64_t stats::*const member)
+	{
+		out.family(name, type);
+		for(const auto &[path, resource] : resource::resources)
+			for(const auto &[name_, method] : resource->methods)
+				out("%s{path=\"%s\",method=\"%s\"} %lu\n",
+				    name,
+				    path,
+				    method->name,
+				    (*method->stats).*member);
+	}};
+
+	family("ircd_resource_pending", "gauge", &stats::pending);
+	family("ircd_resource_requests_total", "counter", &stats::requests);
+	family("ircd_resource_timeouts_total", "counter", &stats::timeouts);
+	family("ircd_resource_completions_total", "counter", &stats::completions);
+	family("ircd_resource_internal_errors_total", "counter", &stats::internal_errors);
+}
+
+void
+expose_db(exposition &out)
+{
+	out.family("ircd_db_ticker_total", "counter", "RocksDB tickers");
+	for(const auto *const &database : db::database::list)
+		for(uint32_t i(0); i < db::ticker_max; ++i)
+		{
+			const string_view &name
+			{
+				db::ticker_id(i)
+			};
+
+			if(!name)
+				continue;
+
+			out("ircd_db_ticker_total{db=\"%s\",ticker=\"%s\"} %lu\n",
+			    db::name(*database),
+			    name,
+			    db::ticker(*database, i));
+		}
+
+	// Histograms which have not recorded anything are omitted; there are many
+	// of them and most are never used by a given database.
+	out.family("ircd_db_histogram", "summary", "RocksDB histograms");
+	for(const auto *const &database : db::database::list)
+		for(uint32_t i(0); i < db::histogram_max; ++i)
+		{
+			const string_view &name
+			{
+				db::histogram_id(i)
+			};
+
+			if(!name)
+				continue;
+
+			const auto &val
+			{
+				db::histogram(*database, i)
+			};
+
+			if(!val.hits)
+				continue;
+
+			const auto &dbname
+			{
+				db::name(*database)
+			};
+
+			out("ircd_db_histogram{db=\"%s\",histogram=\"%s\",quantile=\"0.5\"} %lf\n",
+			    dbname, name, val.median);
+			out("ircd_db_histogram{db=\"%s\",histogram=\"%s\",quantile=\"0.95\"} %lf\n",
+			    dbname, name, val.pct95);
+			out("ircd_db_histogram{db=\"%s\",histogram=\"%s\",quantile=\"0.99\"} %lf\n",
+			    dbname, name, val.pct99);
+			out("ircd_db_histogram{db=\"%s\",histogram=\"%s\",quantile=\"1\"} %lf\n",
+			    dbname, name, val.max);
+			out("ircd_db_histogram_sum{db=\"%s\",histogram=\"%s\"} %lu\n",
+			    dbname, name, val.time);
+			out("ircd_db_histogram_count{db=\"%s\",histogram=\"%s\"} %lu\n",
+			    dbname, name, val.hits);
+		}
+}
+
+//
+// exposition
+//
+
+exposition::exposition(resource::response::chunked &response)
+:response{response}
+{
+}
+
+template<class... args>
+void
+exposition::operator()(const string_view &fmt,
+                       args&&... a)
+{
+	char line[line_max];
+	text += fmt::sprintf
 	{
-		client, output, "text/plain", http::OK
+		line, fmt, std::forward<args>(a)...
 	};
 }
+
+void
+exposition::family(const string_view &name,
+                   const string_view &type,
+                   const string_view &help)
+{
+	flush();
+
+	if(help)
+		operator()("# HELP %s %s\n", name, help);
+
+	operator()("# TYPE %s %s\n", name, type);
+}
+
+void
+exposition::flush()
+{
+	if(text.empty())
+		return;
+
+	response.write(const_buffer{text});
+	text.clear();
+}